@@ -0,0 +1,542 @@
+/**
+ * Native Benchmark
+ *
+ * Times the addon's native paths outside Electron, built from the same
+ * sources as the addon (see binding.gyp):
+ *
+ *   native_bench <corpus-dir> [--iterations N] [--max-docs N] [--out file.json] [--no-controls]
+ *
+ * The corpus is walked once and sorted, so the same folder produces the
+ * same work on every machine. Each measurement gets one discarded warmup
+ * run, then N timed runs reported as min / median / p90 / mean / max in
+ * milliseconds; compare medians between builds. File reads run against a
+ * warm OS cache after the warmup run.
+ *
+ * Output is one JSON object on stdout (or --out) with fixed key order.
+ */
+
+#include <windows.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "control_pool.h"
+#include "directory_tree.h"
+#include "hash_engine.h"
+#include "native_stats.h"
+#include "sha256.h"
+#include "sta_thread.h"
+#include "string_util.h"
+#include "thumbnail_extractor.h"
+
+static const int kSchemaVersion = 1;
+static const DWORD kLoadTimeoutMs = 120000;
+static const uint32_t kThumbnailEdge = 256;
+static const size_t kShaBufferBytes = 64 * 1024 * 1024;
+
+struct BenchOptions {
+    std::wstring corpus;
+    int iterations = 5;
+    size_t maxDocs = 5;   // per document kind, for OpenDoc
+    std::wstring out;
+    bool controls = true;
+};
+
+struct CorpusFile {
+    std::wstring path;
+    uint64_t size;
+    const char* kind;   // "part", "assembly", "drawing" or nullptr
+};
+
+struct Summary {
+    size_t runs = 0;
+    double minMs = 0;
+    double medianMs = 0;
+    double p90Ms = 0;
+    double meanMs = 0;
+    double maxMs = 0;
+};
+
+static double ElapsedMs(int64_t startTicks) {
+    static const double ticksPerMs = []() {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return frequency.QuadPart / 1000.0;
+    }();
+    return (NativeStats::Now() - startTicks) / ticksPerMs;
+}
+
+static Summary Summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    summary.runs = samples.size();
+    summary.minMs = samples.front();
+    summary.maxMs = samples.back();
+    summary.medianMs = samples[samples.size() / 2];
+    summary.p90Ms = samples[std::min(samples.size() - 1, samples.size() * 9 / 10)];
+    double total = 0;
+    for (double sample : samples) total += sample;
+    summary.meanMs = total / samples.size();
+    return summary;
+}
+
+// Minimal streaming JSON writer: keys are emitted in call order
+class JsonWriter {
+public:
+    void BeginObject(const char* key = nullptr) { Open(key, '{'); }
+    void EndObject() { Close('}'); }
+
+    void Number(const char* key, double value) {
+        Key(key);
+        char text[32];
+        snprintf(text, sizeof(text), "%.3f", value);
+        m_text += text;
+    }
+    void Integer(const char* key, uint64_t value) {
+        Key(key);
+        m_text += std::to_string(value);
+    }
+    void Bool(const char* key, bool value) {
+        Key(key);
+        m_text += value ? "true" : "false";
+    }
+    void String(const char* key, const std::string& value) {
+        Key(key);
+        m_text += '"';
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                m_text += '\\';
+                m_text += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                m_text += escaped;
+            } else {
+                m_text += c;
+            }
+        }
+        m_text += '"';
+    }
+    void Timing(const char* key, const Summary& summary) {
+        BeginObject(key);
+        Integer("runs", summary.runs);
+        Number("minMs", summary.minMs);
+        Number("medianMs", summary.medianMs);
+        Number("p90Ms", summary.p90Ms);
+        Number("meanMs", summary.meanMs);
+        Number("maxMs", summary.maxMs);
+        EndObject();
+    }
+
+    const std::string& Text() const { return m_text; }
+
+private:
+    void Key(const char* key) {
+        if (!m_first.empty()) {
+            if (!m_first.back()) m_text += ',';
+            m_first.back() = false;
+        }
+        m_text += '\n';
+        m_text.append(m_first.size() * 2, ' ');
+        if (key) {
+            m_text += '"';
+            m_text += key;
+            m_text += "\": ";
+        }
+    }
+    void Open(const char* key, char bracket) {
+        if (!m_first.empty()) Key(key);
+        m_text += bracket;
+        m_first.push_back(true);
+    }
+    void Close(char bracket) {
+        bool empty = m_first.back();
+        m_first.pop_back();
+        if (!empty) {
+            m_text += '\n';
+            m_text.append(m_first.size() * 2, ' ');
+        }
+        m_text += bracket;
+    }
+
+    std::string m_text;
+    std::vector<bool> m_first;
+};
+
+static const char* KindForPath(const std::wstring& path) {
+    size_t dot = path.find_last_of(L'.');
+    if (dot == std::wstring::npos) return nullptr;
+    std::wstring ext = path.substr(dot);
+    CharLowerBuffW(&ext[0], static_cast<DWORD>(ext.size()));
+    if (ext == L".sldprt" || ext == L".eprt") return "part";
+    if (ext == L".sldasm" || ext == L".easm") return "assembly";
+    if (ext == L".slddrw" || ext == L".edrw") return "drawing";
+    return nullptr;
+}
+
+// Every regular file under the corpus, in path order
+static std::vector<CorpusFile> ListCorpus(const DirectoryTree& tree, const std::wstring& root) {
+    std::vector<std::wstring> paths(tree.entries.size());
+    std::vector<CorpusFile> files;
+    for (size_t i = 0; i < tree.entries.size(); i++) {
+        const TreeEntry& entry = tree.entries[i];
+        std::wstring name = Utf8ToWide(tree.names.substr(entry.nameOffset, entry.nameLength));
+        const std::wstring& parent = entry.parent == DirectoryTree::kTreeRoot ? root : paths[entry.parent];
+        paths[i] = parent + L"\\" + name;
+        if (!(entry.attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+            files.push_back({ paths[i], entry.size, KindForPath(paths[i]) });
+        }
+    }
+    std::sort(files.begin(), files.end(),
+        [](const CorpusFile& a, const CorpusFile& b) { return a.path < b.path; });
+    return files;
+}
+
+// Cold: no idle control, so Acquire pays CreateWindowExW + CoCreateInstance.
+// Warm: one control prewarmed, so Acquire only re-shows it.
+static void BenchControls(JsonWriter& json, StaThread& apartment, int iterations) {
+    json.BeginObject("controls");
+
+    double firstMs = -1;
+    std::vector<double> cold, warm;
+    apartment.Invoke([&]() {
+        ControlPool& pool = ControlPool::Current();
+        pool.Prewarm(0);
+        for (int i = 0; i <= iterations; i++) {
+            int64_t started = NativeStats::Now();
+            PooledControl* control = pool.AcquireOffscreen(400, 300);
+            double ms = ElapsedMs(started);
+            if (!control) return;
+            pool.Release(control);  // over capacity: destroyed
+            if (i == 0) firstMs = ms; else cold.push_back(ms);
+        }
+
+        pool.Prewarm(1);
+        for (int i = 0; i <= iterations; i++) {
+            int64_t started = NativeStats::Now();
+            PooledControl* control = pool.AcquireOffscreen(400, 300);
+            double ms = ElapsedMs(started);
+            pool.Release(control);
+            if (i > 0) warm.push_back(ms);
+        }
+    });
+
+    json.Bool("available", firstMs >= 0);
+    if (firstMs >= 0) {
+        json.Number("firstCreateMs", firstMs);  // includes loading the control's DLLs
+        json.Timing("cold", Summarize(cold));
+        json.Timing("warm", Summarize(warm));
+    }
+    json.EndObject();
+}
+
+struct LoadTiming {
+    HANDLE done = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    double openMs = 0;   // OpenDoc returned
+    double loadMs = 0;   // load-complete event
+    bool success = false;
+    ~LoadTiming() { CloseHandle(done); }
+};
+
+// One load: OpenDoc on the apartment, then wait (pumping there) for the
+// control's completion event
+static std::shared_ptr<LoadTiming> TimeLoad(StaThread& apartment, PooledControl* control, const std::wstring& path) {
+    auto timing = std::make_shared<LoadTiming>();
+    apartment.Post([timing, control, path]() {
+        int64_t started = NativeStats::Now();
+        if (control->events) {
+            ControlEventSink* events = control->events;
+            events->SetListener([timing, events, started](const LoadEvent& ev) {
+                if (ev.type == LoadEvent::Type::Progress) return;
+                events->SetListener(nullptr);
+                timing->loadMs = ElapsedMs(started);
+                timing->success = ev.type == LoadEvent::Type::Complete;
+                SetEvent(timing->done);
+            });
+        }
+        DispatchValue arg;
+        arg.kind = DispatchValue::Kind::String;
+        arg.stringValue = path;
+        HRESULT hr = InvokeControl(control, L"OpenDoc", { arg });
+        timing->openMs = ElapsedMs(started);
+        if (FAILED(hr) || !control->events) {
+            if (control->events) control->events->SetListener(nullptr);
+            timing->loadMs = timing->openMs;
+            timing->success = SUCCEEDED(hr);
+            SetEvent(timing->done);
+        }
+    });
+    if (WaitForSingleObject(timing->done, kLoadTimeoutMs) != WAIT_OBJECT_0) {
+        timing->success = false;
+    }
+    apartment.Invoke([control]() {
+        if (control->events) {
+            control->events->SetListener(nullptr);
+            control->events->CancelPending(L"Benchmark run finished");
+        }
+        DispatchValue unused;
+        unused.kind = DispatchValue::Kind::String;
+        InvokeControl(control, L"CloseActiveDoc", { unused });
+    });
+    return timing;
+}
+
+static void BenchOpenDoc(JsonWriter& json, StaThread& apartment, const std::vector<CorpusFile>& files,
+    const BenchOptions& options) {
+    json.BeginObject("openDoc");
+
+    PooledControl* control = nullptr;
+    apartment.Invoke([&]() { control = ControlPool::Current().AcquireOffscreen(1024, 768); });
+    json.Bool("available", control != nullptr);
+
+    const char* kinds[] = { "part", "assembly", "drawing" };
+    for (const char* kind : kinds) {
+        if (!control) break;
+        std::vector<double> open, load;
+        size_t documents = 0, failures = 0;
+        for (const CorpusFile& file : files) {
+            if (file.kind != kind || documents >= options.maxDocs) continue;
+            documents++;
+            for (int i = 0; i <= options.iterations; i++) {
+                auto timing = TimeLoad(apartment, control, file.path);
+                if (!timing->success) {
+                    failures++;
+                    break;
+                }
+                if (i == 0) continue;
+                open.push_back(timing->openMs);
+                load.push_back(timing->loadMs);
+            }
+        }
+        json.BeginObject(kind);
+        json.Integer("documents", documents);
+        json.Integer("failures", failures);
+        json.Timing("openDoc", Summarize(open));
+        json.Timing("loaded", Summarize(load));
+        json.EndObject();
+    }
+
+    if (control) {
+        apartment.Invoke([control]() { ControlPool::Current().Release(control); });
+    }
+    json.EndObject();
+}
+
+// Per-file latency on this (STA) thread, cache bypassed
+static void BenchThumbnails(JsonWriter& json, const std::vector<CorpusFile>& files, int iterations) {
+    std::vector<double> samples;
+    size_t documents = 0, failures = 0;
+    for (const CorpusFile& file : files) {
+        if (!file.kind) continue;
+        documents++;
+        for (int i = 0; i <= iterations; i++) {
+            int64_t started = NativeStats::Now();
+            ThumbnailImage image = ExtractThumbnail(file.path, kThumbnailEdge);
+            double ms = ElapsedMs(started);
+            if (!image.success) {
+                failures++;
+                break;
+            }
+            if (i > 0) samples.push_back(ms);
+        }
+    }
+    json.BeginObject("thumbnails");
+    json.Integer("maxEdge", kThumbnailEdge);
+    json.Integer("documents", documents);
+    json.Integer("failures", failures);
+    json.Timing("perFile", Summarize(samples));
+    json.EndObject();
+}
+
+static void BenchEnumerate(JsonWriter& json, const std::wstring& root, int iterations) {
+    std::vector<double> samples;
+    size_t entries = 0;
+    TreeOptions options;
+    for (int i = 0; i <= iterations; i++) {
+        int64_t started = NativeStats::Now();
+        DirectoryTree tree = EnumerateTree(root, options);
+        double ms = ElapsedMs(started);
+        entries = tree.entries.size();
+        if (i > 0) samples.push_back(ms);
+    }
+    Summary summary = Summarize(samples);
+    json.BeginObject("enumerateTree");
+    json.Integer("entries", entries);
+    json.Timing("walk", summary);
+    json.Number("entriesPerSec", summary.medianMs > 0 ? entries * 1000.0 / summary.medianMs : 0);
+    json.EndObject();
+}
+
+static void BenchHashing(JsonWriter& json, const std::vector<CorpusFile>& files, int iterations) {
+    std::vector<std::wstring> paths;
+    uint64_t bytes = 0;
+    for (const CorpusFile& file : files) {
+        paths.push_back(file.path);
+        bytes += file.size;
+    }
+
+    std::vector<double> samples;
+    size_t failures = 0;
+    for (int i = 0; i <= iterations; i++) {
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+        size_t failed = 0;
+        int64_t started = NativeStats::Now();
+        HashEngine::Shared().HashFiles(paths, 0,
+            [&](size_t, FileHash&& hash) {
+                if (hash.success) return;
+                std::lock_guard<std::mutex> lock(mutex);
+                failed++;
+            },
+            [&]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                done = true;
+                finished.notify_all();
+            });
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() { return done; });
+        double ms = ElapsedMs(started);
+        failures = failed;
+        if (i > 0) samples.push_back(ms);
+    }
+
+    // Compute alone, for separating CPU from I/O regressions
+    std::vector<uint8_t> buffer(kShaBufferBytes, 0x5A);
+    Sha256 sha;
+    int64_t started = NativeStats::Now();
+    sha.Update(buffer.data(), buffer.size());
+    sha.FinalHex();
+    double shaMs = ElapsedMs(started);
+
+    Summary summary = Summarize(samples);
+    json.BeginObject("hashing");
+    json.Integer("files", paths.size());
+    json.Integer("bytes", bytes);
+    json.Integer("failures", failures);
+    json.Bool("accelerated", Sha256::IsHardwareAccelerated());
+    json.Timing("hashFiles", summary);
+    json.Number("filesMBps", summary.medianMs > 0 ? bytes / 1048576.0 / (summary.medianMs / 1000) : 0);
+    json.Number("sha256MemoryMBps", shaMs > 0 ? kShaBufferBytes / 1048576.0 / (shaMs / 1000) : 0);
+    json.EndObject();
+}
+
+static void WriteNativeStats(JsonWriter& json) {
+    json.BeginObject("nativeStats");
+    for (const NativeOpSummary& summary : NativeStats::Snapshot()) {
+        if (summary.count == 0) continue;
+        json.BeginObject(summary.name);
+        json.Integer("count", summary.count);
+        json.Number("meanUs", summary.meanUs);
+        json.Number("p50Us", summary.p50Us);
+        json.Number("p99Us", summary.p99Us);
+        json.EndObject();
+    }
+    json.EndObject();
+}
+
+static bool ParseOptions(int argc, wchar_t** argv, BenchOptions* options) {
+    for (int i = 1; i < argc; i++) {
+        std::wstring arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == L"--iterations" && hasValue) {
+            options->iterations = std::max(1, _wtoi(argv[++i]));
+        } else if (arg == L"--max-docs" && hasValue) {
+            options->maxDocs = static_cast<size_t>(std::max(0, _wtoi(argv[++i])));
+        } else if (arg == L"--out" && hasValue) {
+            options->out = argv[++i];
+        } else if (arg == L"--no-controls") {
+            options->controls = false;
+        } else if (arg.compare(0, 2, L"--") != 0 && options->corpus.empty()) {
+            options->corpus = arg;
+        } else {
+            return false;
+        }
+    }
+    // `npm run bench` passes nothing of its own: take the corpus from the
+    // environment when the command line has none
+    if (options->corpus.empty()) {
+        const wchar_t* corpus = _wgetenv(L"BENCH_CORPUS");
+        if (corpus) options->corpus = corpus;
+    }
+    while (options->corpus.size() > 3 &&
+           (options->corpus.back() == L'\\' || options->corpus.back() == L'/')) {
+        options->corpus.pop_back();
+    }
+    return !options->corpus.empty();
+}
+
+int wmain(int argc, wchar_t** argv) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, &options)) {
+        fprintf(stderr, "usage: native_bench <corpus-dir> [--iterations N] [--max-docs N] "
+            "[--out file.json] [--no-controls]\n"
+            "       (or set BENCH_CORPUS to the corpus dir)\n");
+        return 2;
+    }
+
+    // Thumbnail handlers and WIC need an apartment on this thread
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+    if (FAILED(hr)) {
+        fprintf(stderr, "CoInitializeEx failed: 0x%08lX\n", static_cast<unsigned long>(hr));
+        return 1;
+    }
+
+    TreeOptions treeOptions;
+    DirectoryTree tree = EnumerateTree(options.corpus, treeOptions);
+    if (!tree.success) {
+        fprintf(stderr, "Could not read corpus: %s\n", tree.error.c_str());
+        return 1;
+    }
+    std::vector<CorpusFile> files = ListCorpus(tree, options.corpus);
+    NativeStats::Reset();
+
+    SYSTEM_INFO system;
+    GetNativeSystemInfo(&system);
+
+    JsonWriter json;
+    json.BeginObject();
+    json.Integer("schema", kSchemaVersion);
+    json.String("corpus", WideToUtf8(options.corpus));
+    json.Integer("iterations", options.iterations);
+    json.Integer("processors", system.dwNumberOfProcessors);
+    json.Integer("files", files.size());
+
+    if (options.controls) {
+        StaThread apartment;
+        if (apartment.Start()) {
+            BenchControls(json, apartment, options.iterations);
+            BenchOpenDoc(json, apartment, files, options);
+            apartment.Invoke([]() { ControlPool::DestroyCurrent(); });
+            apartment.Stop();
+        }
+    }
+    BenchThumbnails(json, files, options.iterations);
+    BenchEnumerate(json, options.corpus, options.iterations);
+    BenchHashing(json, files, options.iterations);
+    WriteNativeStats(json);
+    json.EndObject();
+
+    HashEngine::Shared().Shutdown();
+    CoUninitialize();
+
+    std::string text = json.Text() + "\n";
+    if (options.out.empty()) {
+        fwrite(text.data(), 1, text.size(), stdout);
+        return 0;
+    }
+    FILE* out = _wfopen(options.out.c_str(), L"wb");
+    if (!out) {
+        fprintf(stderr, "Could not open %s\n", WideToUtf8(options.out).c_str());
+        return 1;
+    }
+    fwrite(text.data(), 1, text.size(), out);
+    fclose(out);
+    return 0;
+}
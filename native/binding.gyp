@@ -1,22 +1,111 @@
 {
+  "variables": {
+    # N-API free; shared by the addon and the benchmark
+    "core_sources": [
+      "src/control_pool.cpp",
+      "src/control_events.cpp",
+      "src/dispatch_cache.cpp",
+      "src/sta_thread.cpp",
+      "src/com_executor.cpp",
+      "src/offscreen_render.cpp",
+      "src/thread_pool.cpp",
+      "src/thumbnail_extractor.cpp",
+      "src/compound_file.cpp",
+      "src/mapped_file.cpp",
+      "src/thumbnail_cache.cpp",
+      "src/sha256.cpp",
+      "src/hash_engine.cpp",
+      "src/directory_tree.cpp",
+      "src/change_journal.cpp",
+      "src/directory_watcher.cpp",
+      "src/lock_probe.cpp",
+      "src/native_stats.cpp",
+      "src/job_registry.cpp",
+      "src/memory_guard.cpp",
+      "src/copy_engine.cpp",
+      "src/aligned_buffer_pool.cpp",
+      "src/unbuffered_io.cpp",
+      "src/chunk_reader.cpp",
+      "src/content_chunker.cpp",
+      "src/install_locator.cpp",
+      "src/bounds_sync.cpp",
+      "src/document_properties.cpp"
+    ],
+    "win_libraries": ["ole32.lib", "oleaut32.lib", "user32.lib", "gdi32.lib", "shell32.lib", "shlwapi.lib", "windowscodecs.lib", "rstrtmgr.lib", "psapi.lib", "version.lib", "dwmapi.lib"],
+    # Mapped on first call instead of when the addon loads. user32 stays
+    # eager: Electron already has it mapped, so delaying it saves nothing.
+    "win_delay_load_dlls": ["ole32.dll", "oleaut32.dll", "gdi32.dll", "shell32.dll", "shlwapi.dll", "windowscodecs.dll", "rstrtmgr.dll", "psapi.dll", "version.dll", "dwmapi.dll"]
+  },
   "targets": [
     {
       "target_name": "edrawings_preview",
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
-      "sources": ["src/edrawings_preview.cpp"],
+      "sources": [
+        "<@(core_sources)",
+        "src/edrawings_preview.cpp",
+        "src/thumbnails_napi.cpp",
+        "src/compound_file_napi.cpp",
+        "src/hash_napi.cpp",
+        "src/directory_tree_napi.cpp",
+        "src/change_journal_napi.cpp",
+        "src/directory_watcher_napi.cpp",
+        "src/lock_probe_napi.cpp",
+        "src/stats_napi.cpp",
+        "src/jobs_napi.cpp",
+        "src/copy_napi.cpp",
+        "src/chunk_reader_napi.cpp",
+        "src/content_chunker_napi.cpp",
+        "src/worker_shutdown.cpp"
+      ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")"
       ],
-      "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
+      "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS", "NOMINMAX"],
+      "conditions": [
+        [
+          "OS=='win'",
+          {
+            "libraries": ["<@(win_libraries)", "delayimp.lib"],
+            "msvs_settings": {
+              "VCCLCompilerTool": {
+                "ExceptionHandling": 1
+              },
+              "VCLinkerTool": {
+                "DelayLoadDLLs": ["<@(win_delay_load_dlls)"]
+              }
+            }
+          }
+        ]
+      ]
+    },
+    {
+      # Standalone timing harness: build/Release/native_bench.exe <corpus-dir>
+      # (or BENCH_CORPUS in the environment, as `npm run bench` relies on)
+      "target_name": "native_bench",
+      "type": "executable",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "variables": {
+        "win_delay_load_hook": "false"
+      },
+      "sources": [
+        "<@(core_sources)",
+        "bench/native_bench.cpp"
+      ],
+      "include_dirs": ["src"],
+      "defines": ["NOMINMAX"],
       "conditions": [
         [
           "OS=='win'",
           {
-            "libraries": ["ole32.lib", "oleaut32.lib", "user32.lib", "gdi32.lib"],
+            "libraries": ["<@(win_libraries)"],
             "msvs_settings": {
               "VCCLCompilerTool": {
                 "ExceptionHandling": 1
+              },
+              "VCLinkerTool": {
+                "SubSystem": 1
               }
             }
           }
@@ -25,4 +114,3 @@
     }
   ]
 }
-
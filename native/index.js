@@ -5,41 +5,86 @@
  * isn't built or isn't available (non-Windows platforms).
  */
 
-let nativeModule = null;
+let nativeModule;  // undefined until first use, then the addon or null
 let loadError = null;
 
-// Try to load the native module
-try {
-  nativeModule = require('./build/Release/edrawings_preview.node');
-} catch (err) {
-  loadError = err.message;
-  console.warn('[eDrawings] Native module not available:', err.message);
+// Load the addon on first use rather than at require time, so app start
+// pays nothing for it (or for its absence) until something needs it
+function native() {
+  if (nativeModule === undefined) {
+    try {
+      nativeModule = require('./build/Release/edrawings_preview.node');
+    } catch (err) {
+      nativeModule = null;
+      loadError = err.message;
+      console.warn('[eDrawings] Native module not available:', err.message);
+    }
+  }
+  return nativeModule;
+}
+
+let nextJobId = 1;
+
+// Batch calls hand their paths over as one table of '\0'-terminated paths: a
+// single string crosses into the addon in one read instead of one per
+// element. Terminated, not joined, so [] and [''] (and a trailing '') differ.
+function pathTable(paths) {
+  return paths.length ? paths.join('\0') + '\0' : '';
+}
+
+/**
+ * Start a native job, wiring an optional AbortSignal in options to cancelJob
+ * @param {{ signal?: AbortSignal }} options
+ * @param {(nativeOptions: object) => Promise<any>} start
+ */
+async function runJob(options, start) {
+  const { signal, ...rest } = options || {};
+  if (!signal) {
+    return start(rest);
+  }
+  const jobId = nextJobId++;
+  const cancel = () => native().cancelJob(jobId);
+  // The native side registers the job synchronously, so cancel after starting
+  const pending = start({ ...rest, jobId });
+  if (signal.aborted) {
+    cancel();
+  } else {
+    signal.addEventListener('abort', cancel, { once: true });
+  }
+  try {
+    return await pending;
+  } finally {
+    signal.removeEventListener('abort', cancel);
+  }
 }
 
 /**
  * Check if the native module is available
  */
 function isAvailable() {
-  return nativeModule !== null;
+  return native() !== null;
 }
 
 /**
  * Get the load error if module failed to load
  */
 function getLoadError() {
+  native();
   return loadError;
 }
 
 /**
- * Check if eDrawings is installed on the system
- * @returns {{ installed: boolean, path: string | null }}
+ * Check if eDrawings is installed on the system. Cached natively and kept
+ * current by a registry watch, so calling it on every panel mount is free.
+ * @param {{ refresh?: boolean }} [options] - refresh: resolve again even if the registry has not changed
+ * @returns {{ installed: boolean, path: string | null, controlPath?: string, version?: string, source?: 'clsid' | 'registry' | 'path' }}
  */
-function checkEDrawingsInstalled() {
-  if (!nativeModule) {
+function checkEDrawingsInstalled(options = {}) {
+  if (!native()) {
     return { installed: false, path: null, error: 'Native module not loaded' };
   }
   try {
-    return nativeModule.checkEDrawingsInstalled();
+    return native().checkEDrawingsInstalled(options);
   } catch (err) {
     return { installed: false, path: null, error: err.message };
   }
@@ -51,14 +96,14 @@ function checkEDrawingsInstalled() {
  * @returns {boolean} - True if launch succeeded
  */
 function openInEDrawings(filePath) {
-  if (!nativeModule) {
+  if (!native()) {
     // Fallback: try shell open
     const { shell } = require('electron');
     shell.openPath(filePath);
     return true;
   }
   try {
-    return nativeModule.openInEDrawings(filePath);
+    return native().openInEDrawings(filePath);
   } catch (err) {
     console.error('[eDrawings] Failed to open file:', err);
     return false;
@@ -70,24 +115,701 @@ function openInEDrawings(filePath) {
  * @returns {EDrawingsPreview | null}
  */
 function createPreview() {
-  if (!nativeModule) {
+  if (!native()) {
     return null;
   }
   try {
-    return new nativeModule.EDrawingsPreview();
+    const { EDrawingsPreview } = native();
+    return new EDrawingsPreview();
   } catch (err) {
     console.error('[eDrawings] Failed to create preview:', err);
     return null;
   }
 }
 
+/**
+ * Pre-create hidden eDrawings controls so previews start warm
+ * @param {number} size - Number of idle controls to keep ready (split across apartments)
+ * @param {{ apartments?: number, maxApartments?: number, residentDocuments?: number, residentMemoryMB?: number, memoryBudgetMB?: number }} [options]
+ *   apartments: STA threads to spread previews over (1-4, first call only).
+ *   maxApartments: threads concurrent previews may grow that to, one per
+ *   live preview (1-4, default apartments: no growth). A grown thread gets
+ *   the same share of warm controls after its first, cold, preview.
+ *   residentDocuments / residentMemoryMB: how many released documents stay
+ *   loaded for instant reopening, and how much memory they may hold, split
+ *   across apartments (default 2 and 512 per apartment; 0 documents turns this off).
+ *   memoryBudgetMB: process commit above which idle documents, then idle
+ *   controls, are evicted (default none; low system memory always evicts)
+ * @returns {Promise<number>} - Idle controls available (0 if eDrawings is missing)
+ */
+async function initPreviewPool(size = 2, options = {}) {
+  if (!native()) {
+    return 0;
+  }
+  try {
+    return await native().initPreviewPool(size, options);
+  } catch (err) {
+    console.error('[eDrawings] Failed to init preview pool:', err);
+    return 0;
+  }
+}
+
+/**
+ * Do the addon's one-time startup work now, e.g. when the app goes idle,
+ * instead of on the first preview or thumbnail: loads the addon, starts the
+ * preview apartments and worker threads, and loads the image codecs
+ * @param {{ previews?: boolean, thumbnails?: boolean }} [options] - previews: start the COM apartments (default true); thumbnails: start workers and load WIC (default true)
+ * @returns {Promise<{ apartments: number, workers: number, codecs: boolean, elapsedMs: number } | null>} - null if the addon is unavailable
+ */
+async function warmup(options = {}) {
+  if (!native()) {
+    return null;
+  }
+  try {
+    return await native().warmup(options);
+  } catch (err) {
+    console.error('[eDrawings] Failed to warm up:', err);
+    return null;
+  }
+}
+
+/**
+ * Get a preview backed by a warm pooled control
+ * @param {Buffer | number} [hwnd] - Parent window to attach to immediately
+ * @returns {EDrawingsPreview | null}
+ */
+function acquirePreview(hwnd) {
+  if (!native()) {
+    return null;
+  }
+  try {
+    return native().acquirePreview(hwnd);
+  } catch (err) {
+    console.error('[eDrawings] Failed to acquire preview:', err);
+    return null;
+  }
+}
+
+// BoundsSlot (src/bounds_sync.h): Int32 0 sequence, Int32 1 parked,
+// Float64 1-5 x, y, width, height, zoom, Int32 12 flags
+const BOUNDS_SLOT_BYTES = 64;
+
+/**
+ * Keep a preview's window on its placeholder element without a native call
+ * per move. set() only writes the rect into memory the addon reads once per
+ * display frame, so a splitter drag or window resize costs at most one move
+ * per frame, and previews on one window move together. Rects are CSS pixels
+ * (getBoundingClientRect) in the window's client area; the addon scales
+ * them by the window's per-monitor DPI and the zoom given. Forward rects
+ * from the renderer fire-and-forget (ipcRenderer.send or a MessagePort),
+ * never with invoke. Don't mix with setBounds() while syncing.
+ * @param {EDrawingsPreview} preview - an attached preview
+ * @returns {{ set: (rect: { x: number, y: number, width: number, height: number }, options?: { zoom?: number, visible?: boolean }) => void, stop: () => void } | null}
+ *   zoom: the page's zoom factor (default 1); visible: false hides the window
+ */
+function syncBounds(preview) {
+  if (!native() || !preview) {
+    return null;
+  }
+  try {
+    const slot = new ArrayBuffer(BOUNDS_SLOT_BYTES);
+    if (!preview.syncBounds(slot)) {
+      return null;
+    }
+    const words = new Int32Array(slot);
+    const values = new Float64Array(slot);
+    return {
+      set(rect, options = {}) {
+        Atomics.add(words, 0, 1);  // odd: the addon skips the slot this frame
+        values[1] = rect.x;
+        values[2] = rect.y;
+        values[3] = rect.width;
+        values[4] = rect.height;
+        values[5] = options.zoom || 1;
+        words[12] = options.visible === false ? 0 : 1;
+        Atomics.add(words, 0, 1);
+        if (Atomics.load(words, 1) !== 0) {
+          native().wakeBoundsSync();
+        }
+      },
+      stop() {
+        preview.syncBounds(null);
+      },
+    };
+  } catch (err) {
+    console.error('[eDrawings] Failed to sync bounds:', err);
+    return null;
+  }
+}
+
+/**
+ * Return a preview's control to the pool instead of destroying it
+ * @param {EDrawingsPreview} preview
+ * @returns {boolean}
+ */
+function releasePreview(preview) {
+  if (!native() || !preview) {
+    return false;
+  }
+  try {
+    return native().releasePreview(preview);
+  } catch (err) {
+    console.error('[eDrawings] Failed to release preview:', err);
+    return false;
+  }
+}
+
+/**
+ * Render a document to RGBA pixels without showing a window
+ * @param {string} filePath - Document to render
+ * @param {number} width - Output width in pixels (16-4096)
+ * @param {number} height - Output height in pixels (16-4096)
+ * @param {number} [viewOrientation] - eDrawings view orientation to apply before capturing
+ * @param {{ signal?: AbortSignal }} [options] - signal: cancels the render if it has not started
+ * @returns {Promise<{ success: boolean, width?: number, height?: number, data?: Buffer, error?: string }>}
+ */
+async function renderToBuffer(filePath, width, height, viewOrientation, options = {}) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return await runJob(options, (jobOptions) =>
+      native().renderToBuffer(filePath, width, height, viewOrientation, jobOptions));
+  } catch (err) {
+    console.error('[eDrawings] Failed to render preview:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Warm native caches for files the user is likely to open next: thumbnails
+ * go into the disk cache at idle priority and, given a preview, the first
+ * path is loaded into a hidden pooled control on that preview's apartment.
+ * A later preview.loadFileAsync of that file adopts the control already loaded.
+ * @param {string[]} paths - Likely next files, most likely first
+ * @param {{ priority?: 'visible' | 'normal' | 'prefetch', preview?: EDrawingsPreview, signal?: AbortSignal }} [options] - priority defaults to 'prefetch'
+ * @returns {Promise<{ thumbnails: number, preloaded: boolean, error?: string }>}
+ */
+async function prefetch(paths, options = {}) {
+  if (!native()) {
+    return { thumbnails: 0, preloaded: false, error: 'Native module not loaded' };
+  }
+  try {
+    return await runJob(options, (jobOptions) => native().prefetch(pathTable(paths), jobOptions));
+  } catch (err) {
+    console.error('[eDrawings] Failed to prefetch:', err);
+    return { thumbnails: 0, preloaded: false, error: err.message };
+  }
+}
+
+/**
+ * Extract embedded thumbnails for many files on native worker threads
+ * @param {string[]} paths - Files to extract previews from
+ * @param {{ maxEdge?: number, format?: 'auto' | 'jpeg' | 'png', cache?: boolean, priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal }} [options] - Longest output edge in pixels (default 256); format: 'auto' (default) is JPEG unless the image has transparency; cache: false skips the disk cache; priority: 'visible' runs ahead of queued work, 'prefetch' behind it
+ * @returns {Promise<Array<{ path: string, success: boolean, mimeType?: string, width?: number, height?: number, source?: string, data?: Buffer, error?: string }>>}
+ */
+async function extractThumbnails(paths, options = {}) {
+  if (!native()) {
+    return paths.map(path => ({ path, success: false, error: 'Native module not loaded' }));
+  }
+  try {
+    return await runJob(options, (jobOptions) => native().extractThumbnails(pathTable(paths), jobOptions));
+  } catch (err) {
+    console.error('[eDrawings] Failed to extract thumbnails:', err);
+    return paths.map(path => ({ path, success: false, error: err.message }));
+  }
+}
+
+/**
+ * Open the persistent thumbnail cache used by extractThumbnails
+ * @param {string} directory - Absolute cache directory (created if missing)
+ * @param {{ sizes?: number[], format?: 'auto' | 'jpeg' | 'png' }} [options] - Edges pre-rendered on a miss (max 3, default [128, 256]); format: what prefetch() warms (default 'auto')
+ * @returns {{ success: boolean, entries?: number, error?: string }}
+ */
+function openThumbnailCache(directory, options = {}) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return native().openThumbnailCache(directory, options);
+  } catch (err) {
+    console.error('[eDrawings] Failed to open thumbnail cache:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Flush and close the thumbnail cache
+ */
+function closeThumbnailCache() {
+  if (!native()) {
+    return;
+  }
+  try {
+    native().closeThumbnailCache();
+  } catch (err) {
+    console.error('[eDrawings] Failed to close thumbnail cache:', err);
+  }
+}
+
+/**
+ * Thumbnail cache counters
+ * @returns {{ open: boolean, entries: number, packBytes: number, hits: number, misses: number }}
+ */
+function getThumbnailCacheStats() {
+  const empty = { open: false, entries: 0, packBytes: 0, hits: 0, misses: 0 };
+  if (!native()) {
+    return empty;
+  }
+  try {
+    return native().getThumbnailCacheStats();
+  } catch (err) {
+    console.error('[eDrawings] Failed to read thumbnail cache stats:', err);
+    return empty;
+  }
+}
+
+/**
+ * Copy one preview stream out of a compound file without reading the rest
+ * @param {string} filePath - SolidWorks file (pre-2015 compound format)
+ * @param {string[]} streamNames - Candidate names, best first ('Storage/Stream' paths allowed)
+ * @returns {Promise<{ success: boolean, name?: string, data?: Buffer, error?: string }>}
+ */
+async function readPreviewStream(filePath, streamNames) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return await native().readPreviewStream(filePath, streamNames);
+  } catch (err) {
+    console.error('[eDrawings] Failed to read preview stream:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Read document properties from the files' OLE property sets on native worker threads
+ * @param {string[]} paths - SolidWorks (or any OLE compound) files
+ * @param {{ priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal, fallback?: (path: string) => Promise<object> }} [options] - fallback: called, one file at a time, for each file the native reader could not parse (SOLIDWORKS 2015+, no property sets); its result is merged in with source 'service'
+ * @returns {Promise<Array<{ path: string, success: boolean, source?: 'native' | 'service', summary?: object, fileProperties?: Object<string, string>, compound?: boolean, error?: string }>>}
+ */
+async function readProperties(paths, options = {}) {
+  const { fallback, ...jobOptions } = options;
+  let results;
+  if (!native()) {
+    results = paths.map(path => ({ path, success: false, error: 'Native module not loaded' }));
+  } else {
+    try {
+      results = await runJob(jobOptions, (job) => native().readProperties(pathTable(paths), job));
+    } catch (err) {
+      console.error('[eDrawings] Failed to read properties:', err);
+      results = paths.map(path => ({ path, success: false, error: err.message }));
+    }
+  }
+  if (!fallback) {
+    return results;
+  }
+
+  for (let i = 0; i < results.length; i++) {
+    const result = results[i];
+    if (result.success || result.error === 'Cancelled' || (options.signal && options.signal.aborted)) {
+      continue;
+    }
+    try {
+      results[i] = { ...(await fallback(result.path)), path: result.path, success: true, source: 'service' };
+    } catch (err) {
+      results[i] = { ...result, error: err.message };
+    }
+  }
+  return results;
+}
+
+/**
+ * SHA-256 many files with overlapped unbuffered reads on native threads
+ * @param {string[]} paths - Files to hash
+ * @param {{ algo?: 'sha256', concurrency?: number, batchSize?: number, priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal }} [options] - concurrency: files in flight; batchSize: entries per onBatch call (default 256); priority: each file waits its turn on the worker pool at this priority
+ * @param {(batch: Array<{ index: number, path: string, success: boolean, size: number, hash?: string, error?: string }>) => void} [onBatch] - Called as files finish; when omitted, all entries are returned in `results`
+ * @returns {Promise<{ hashed: number, failed: number, cancelled?: number, bytes: number, elapsedMs: number, accelerated?: boolean, results?: Array<object>, error?: string }>}
+ */
+async function hashFiles(paths, options = {}, onBatch) {
+  const failAll = (error) => {
+    const entries = paths.map((path, index) => ({ index, path, success: false, size: 0, error }));
+    if (onBatch) {
+      onBatch(entries);
+      return { hashed: 0, failed: paths.length, bytes: 0, elapsedMs: 0, error };
+    }
+    return { hashed: 0, failed: paths.length, bytes: 0, elapsedMs: 0, error, results: entries };
+  };
+  if (!native()) {
+    return failAll('Native module not loaded');
+  }
+  try {
+    if (onBatch) {
+      return await runJob(options, (jobOptions) => native().hashFiles(pathTable(paths), jobOptions, onBatch));
+    }
+    const results = new Array(paths.length);
+    const summary = await runJob(options, (jobOptions) => native().hashFiles(pathTable(paths), jobOptions, (batch) => {
+      for (const entry of batch) results[entry.index] = entry;
+    }));
+    return { ...summary, results };
+  } catch (err) {
+    console.error('[eDrawings] Failed to hash files:', err);
+    return failAll(err.message);
+  }
+}
+
+/**
+ * Copy many files natively: CopyFile2 (unbuffered) for large files, a
+ * double-buffered overlapped loop for the rest and for anything hashed
+ * @param {Array<{ from: string, to: string }>} pairs - Missing destination folders are created
+ * @param {{ concurrency?: number, verifyHash?: boolean, overwrite?: boolean, priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal }} [options] - concurrency: files in flight (1-16, default 4); verifyHash: SHA-256 of each file as it is copied; overwrite: default true; priority: each file waits its turn on the worker pool at this priority
+ * @returns {Promise<{ copied: number, failed: number, cancelled?: number, bytes: number, elapsedMs: number, results: Array<{ index: number, from: string, to: string, success: boolean, size: number, hash?: string, method?: 'copyFile2' | 'overlapped', error?: string }>, error?: string }>}
+ */
+async function copyBatch(pairs, options = {}) {
+  const failAll = (error) => ({
+    copied: 0,
+    failed: pairs.length,
+    bytes: 0,
+    elapsedMs: 0,
+    error,
+    results: pairs.map((pair, index) => ({ index, from: pair.from, to: pair.to, success: false, size: 0, error })),
+  });
+  if (!native()) {
+    return failAll('Native module not loaded');
+  }
+  try {
+    return await runJob(options, (jobOptions) => native().copyBatch(pairs, jobOptions));
+  } catch (err) {
+    console.error('[eDrawings] Failed to copy files:', err);
+    return failAll(err.message);
+  }
+}
+
+/**
+ * Read a file in chunks while hashing it, for single-pass hash-and-upload.
+ * Iterate the reader with `for await`; once the last chunk is out, `hash`
+ * is the file's SHA-256. Chunks are the reader's own buffers where the
+ * runtime allows it: consume each one before keeping many around.
+ * @param {string} filePath
+ * @param {{ chunkSize?: number, priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal }} [options] - chunkSize: bytes per chunk (64 KB-16 MB, default 1 MB)
+ * @returns {Promise<{ success: boolean, size?: number, chunkSize?: number, hash?: string | null, close?: () => void, [Symbol.asyncIterator]?: () => AsyncGenerator<Buffer>, error?: string }>}
+ */
+async function openChunkReader(filePath, options = {}) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  // Not runJob: the signal has to reach reads long after the open settles
+  const { signal, ...rest } = options || {};
+  const jobId = signal ? nextJobId++ : 0;
+  const cancel = () => native().cancelJob(jobId);
+  try {
+    const pending = native().openChunkReader(filePath, signal ? { ...rest, jobId } : rest);
+    if (signal) {
+      if (signal.aborted) cancel();
+      else signal.addEventListener('abort', cancel, { once: true });
+    }
+    const opened = await pending;
+    if (!opened.success) {
+      if (signal) signal.removeEventListener('abort', cancel);
+      return opened;
+    }
+    const reader = {
+      success: true,
+      size: opened.size,
+      chunkSize: opened.chunkSize,
+      hash: null,
+      close() {
+        native().closeChunkReader(opened.id);
+        if (signal) signal.removeEventListener('abort', cancel);
+      },
+      async *[Symbol.asyncIterator]() {
+        try {
+          for (;;) {
+            const chunk = await native().readChunk(opened.id);
+            if (!chunk.success) throw new Error(chunk.error);
+            if (chunk.data) yield chunk.data;
+            if (chunk.done) {
+              reader.hash = chunk.hash || null;
+              return;
+            }
+          }
+        } finally {
+          reader.close();
+        }
+      },
+    };
+    return reader;
+  } catch (err) {
+    console.error('[eDrawings] Failed to open chunk reader:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Split a file into content-defined chunks (FastCDC) with a SHA-256 per
+ * chunk, for uploading only the chunks a store does not have yet
+ * @param {string} filePath
+ * @param {{ minSize?: number, avgSize?: number, maxSize?: number, priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal }} [options] - Chunk sizes in bytes (defaults 16 KB / 64 KB / 256 KB); keep them the same across revisions
+ * @returns {Promise<{ success: boolean, size?: number, hash?: string, count?: number, minSize?: number, avgSize?: number, maxSize?: number, offsets?: Float64Array, lengths?: Uint32Array, hashes?: Uint8Array, buffer?: ArrayBuffer, error?: string }>}
+ */
+async function chunkFile(filePath, options = {}) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return await runJob(options, (jobOptions) => native().chunkFile(filePath, jobOptions));
+  } catch (err) {
+    console.error('[eDrawings] Failed to chunk file:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Hex SHA-256 of every chunk of a chunkFile result, in file order
+ * @param {{ count: number, hashes: Uint8Array }} chunks
+ * @returns {string[]}
+ */
+function chunkHashes(chunks) {
+  const keys = new Array(chunks.count);
+  for (let i = 0; i < chunks.count; i++) {
+    keys[i] = Buffer.from(chunks.hashes.buffer, chunks.hashes.byteOffset + i * 32, 32).toString('hex');
+  }
+  return keys;
+}
+
+/**
+ * List a folder tree with metadata in one native pass
+ * @param {string} root - Directory to walk
+ * @param {{ skipHidden?: boolean, want?: Array<'size' | 'mtime' | 'attrs' | 'fileId'>, maxEntries?: number }} [options]
+ * @returns {Promise<{ success: boolean, count?: number, truncated?: boolean, unreadable?: number, parents?: Uint32Array, nameOffsets?: Uint32Array, names?: Uint8Array, kinds?: Uint8Array, size?: Float64Array, mtime?: Float64Array, attrs?: Uint32Array, fileId?: BigUint64Array, buffer?: ArrayBuffer, error?: string }>}
+ */
+async function enumerateTree(root, options = {}) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return await native().enumerateTree(root, options);
+  } catch (err) {
+    console.error('[eDrawings] Failed to enumerate tree:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Root-relative, '/'-separated paths for every entry of an enumerateTree result
+ * @param {{ count: number, parents: Uint32Array, nameOffsets: Uint32Array, names: Uint8Array }} tree
+ * @returns {string[]}
+ */
+function treePaths(tree) {
+  const decoder = new TextDecoder();
+  const paths = new Array(tree.count);
+  for (let i = 0; i < tree.count; i++) {
+    const name = decoder.decode(tree.names.subarray(tree.nameOffsets[i], tree.nameOffsets[i + 1]));
+    const parent = tree.parents[i];
+    // Parents come first, so their path is already known
+    paths[i] = parent === 0xFFFFFFFF ? name : paths[parent] + '/' + name;
+  }
+  return paths;
+}
+
+/**
+ * Files changed on the volume since a saved change-journal cursor
+ * @param {{ volume: string, journalId: string, usn: string } | string} cursorOrPath - Cursor from an earlier call, or any path on the volume to get a starting cursor
+ * @param {{ maxRecords?: number }} [options] - Journal records to read per call (default 200000)
+ * @returns {Promise<{ success: boolean, cursor?: { volume: string, journalId: string, usn: string }, reset?: boolean, more?: boolean, changes?: Array<{ fileId: bigint, parentId: bigint, name: string, kind: 'created' | 'modified' | 'renamed' | 'deleted', isDirectory: boolean, reasons: number }>, error?: string }>}
+ */
+async function getChangesSince(cursorOrPath, options = {}) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return await native().getChangesSince(cursorOrPath, options);
+  } catch (err) {
+    console.error('[eDrawings] Failed to read change journal:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Watch a directory tree; changes arrive debounced, in batches
+ * @param {string} root - Directory to watch
+ * @param {{ recursive?: boolean, debounceMs?: number, skipHidden?: boolean, skipTemp?: boolean }} options
+ * @param {(events: Array<{ type: 'added' | 'modified' | 'removed' | 'renamed' | 'overflow' | 'error', path?: string, oldPath?: string, isDirectory?: boolean, size?: number, mtime?: number, fileId?: bigint }>) => void} onEvents
+ * @returns {{ success: boolean, id?: number, error?: string }}
+ */
+function watchDirectory(root, options, onEvents) {
+  if (!native()) {
+    return { success: false, error: 'Native module not loaded' };
+  }
+  try {
+    return native().watchDirectory(root, options || {}, onEvents);
+  } catch (err) {
+    console.error('[eDrawings] Failed to watch directory:', err);
+    return { success: false, error: err.message };
+  }
+}
+
+/**
+ * Stop a watch started with watchDirectory; pending events are delivered first
+ * @param {number} id
+ * @returns {boolean}
+ */
+function unwatchDirectory(id) {
+  if (!native()) {
+    return false;
+  }
+  try {
+    return native().unwatchDirectory(id);
+  } catch (err) {
+    console.error('[eDrawings] Failed to unwatch directory:', err);
+    return false;
+  }
+}
+
+/**
+ * Find which files are held open by another process
+ * @param {string[]} paths - Files to probe
+ * @param {{ owners?: boolean, priority?: 'visible' | 'normal' | 'prefetch', signal?: AbortSignal }} [options] - owners: ask the Restart Manager who holds each locked file (default true)
+ * @returns {Promise<{ count: number, lockedCount: number, locked: Buffer, missing: Buffer, failed: Buffer, owners: Array<{ pid: number, appName: string, exeName: string, appType: number }>, holders: Array<{ index: number, owners: number[] }>, error?: string }>}
+ */
+async function probeLocks(paths, options = {}) {
+  const empty = (error) => {
+    const bitmap = () => Buffer.alloc(Math.ceil(paths.length / 8));
+    return { count: paths.length, lockedCount: 0, locked: bitmap(), missing: bitmap(), failed: bitmap(), owners: [], holders: [], error };
+  };
+  if (!native()) {
+    return empty('Native module not loaded');
+  }
+  try {
+    return await runJob(options, (jobOptions) => native().probeLocks(pathTable(paths), jobOptions));
+  } catch (err) {
+    console.error('[eDrawings] Failed to probe locks:', err);
+    return empty(err.message);
+  }
+}
+
+/**
+ * Cancel every native job's work on files under a folder. Running file
+ * reads stop at their next chunk; queued files fail with "Cancelled".
+ * @param {string} folder
+ * @returns {number} Jobs affected
+ */
+function cancelJobsUnder(folder) {
+  if (!native()) {
+    return 0;
+  }
+  try {
+    return native().cancelJobsUnder(folder);
+  } catch (err) {
+    console.error('[eDrawings] Failed to cancel jobs:', err);
+    return 0;
+  }
+}
+
+/**
+ * Latency histograms for native operations since the last reset, keyed by
+ * operation (createControl, loadFileAsync, setBounds, hashFile, ...)
+ * @returns {Object<string, { count: number, meanUs: number, p50Us: number, p90Us: number, p99Us: number, maxUs: number }>}
+ */
+function getNativeStats() {
+  if (!native()) {
+    return {};
+  }
+  try {
+    return native().getNativeStats();
+  } catch (err) {
+    console.error('[eDrawings] Failed to read native stats:', err);
+    return {};
+  }
+}
+
+/**
+ * Process commit against the memory budget, and what the pools have
+ * evicted to stay within it since the last reset
+ * @returns {{ commitBytes: number, budgetBytes: number, lowMemory: boolean, pressureEvents: number, documentsEvicted: number, controlsEvicted: number } | null}
+ */
+function getMemoryStats() {
+  if (!native()) {
+    return null;
+  }
+  try {
+    return native().getMemoryStats();
+  } catch (err) {
+    console.error('[eDrawings] Failed to read memory stats:', err);
+    return null;
+  }
+}
+
+/**
+ * Start a new measurement window for getNativeStats and getMemoryStats
+ */
+function resetNativeStats() {
+  if (!native()) {
+    return;
+  }
+  try {
+    native().resetNativeStats();
+  } catch (err) {
+    console.error('[eDrawings] Failed to reset native stats:', err);
+  }
+}
+
+/**
+ * Collect the ArrayBuffers behind native result Buffers for a MessagePort
+ * transfer list, so thumbnails move to the renderer instead of being cloned
+ * @param {Array<{ data?: Buffer }> | { data?: Buffer }} results
+ * @returns {ArrayBuffer[]}
+ */
+function transferList(results) {
+  const list = [];
+  for (const result of Array.isArray(results) ? results : [results]) {
+    const data = result && result.data;
+    // Only whole-buffer views are safe to detach
+    if (data && data.byteOffset === 0 && data.byteLength === data.buffer.byteLength) {
+      list.push(data.buffer);
+    }
+  }
+  return list;
+}
+
 module.exports = {
   isAvailable,
   getLoadError,
   checkEDrawingsInstalled,
   openInEDrawings,
   createPreview,
-  // Export class directly if available
-  EDrawingsPreview: nativeModule?.EDrawingsPreview || null
+  initPreviewPool,
+  warmup,
+  acquirePreview,
+  releasePreview,
+  syncBounds,
+  renderToBuffer,
+  prefetch,
+  extractThumbnails,
+  readPreviewStream,
+  readProperties,
+  hashFiles,
+  copyBatch,
+  openChunkReader,
+  chunkFile,
+  chunkHashes,
+  enumerateTree,
+  treePaths,
+  getChangesSince,
+  watchDirectory,
+  unwatchDirectory,
+  probeLocks,
+  cancelJobsUnder,
+  getNativeStats,
+  getMemoryStats,
+  resetNativeStats,
+  openThumbnailCache,
+  closeThumbnailCache,
+  getThumbnailCacheStats,
+  transferList,
+  // Export class directly if available (getter: loads the addon)
+  get EDrawingsPreview() {
+    return native()?.EDrawingsPreview || null;
+  },
 };
 
@@ -0,0 +1,142 @@
+/**
+ * Addon-wide N-API declarations
+ *
+ * Each feature keeps its core logic N-API free (so it can be reused outside
+ * Node) and registers its JS exports through one Init* function here.
+ */
+
+#pragma once
+
+#ifndef NAPI_VERSION
+#define NAPI_VERSION 8
+#endif
+#include <napi.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "job_registry.h"
+#include "js_args.h"
+
+// Feature registration, called from the module Init in edrawings_preview.cpp
+void InitThumbnailBindings(Napi::Env env, Napi::Object exports);
+void InitCompoundFileBindings(Napi::Env env, Napi::Object exports);
+void InitHashBindings(Napi::Env env, Napi::Object exports);
+void InitDirectoryTreeBindings(Napi::Env env, Napi::Object exports);
+void InitChangeJournalBindings(Napi::Env env, Napi::Object exports);
+void InitDirectoryWatcherBindings(Napi::Env env, Napi::Object exports);
+void InitLockProbeBindings(Napi::Env env, Napi::Object exports);
+void InitStatsBindings(Napi::Env env, Napi::Object exports);
+void InitJobBindings(Napi::Env env, Napi::Object exports);
+void InitCopyBindings(Napi::Env env, Napi::Object exports);
+void InitChunkReaderBindings(Napi::Env env, Napi::Object exports);
+void InitContentChunkerBindings(Napi::Env env, Napi::Object exports);
+
+// Warm the thumbnail disk cache for paths on the worker pool; done(warmed)
+// runs on a worker once every path is served or stored (at once, with 0,
+// while the cache is closed)
+void WarmThumbnailCache(std::vector<std::wstring> paths, JobPriority priority, CancelTokenPtr token,
+    std::function<void(size_t warmed)> done);
+
+// Shuts down background workers (worker_shutdown.cpp); called from the env
+// cleanup hook
+void ShutdownWorkerBindings();
+
+// Hands native bytes to JS as a Buffer. Where the runtime allows external
+// buffers the vector's allocation is wrapped as-is and freed by the
+// finalizer; Electron's V8 memory cage does not, and NewOrCopy falls back
+// to a single copy. The Buffer always spans its whole ArrayBuffer, so
+// `buffer.buffer` can go in a MessagePort transfer list.
+inline Napi::Buffer<uint8_t> TakeBuffer(Napi::Env env, std::vector<uint8_t>&& bytes) {
+    if (bytes.empty()) return Napi::Buffer<uint8_t>::New(env, 0);
+    auto* owned = new std::vector<uint8_t>(std::move(bytes));
+    return Napi::Buffer<uint8_t>::NewOrCopy(env, owned->data(), owned->size(),
+        [](Napi::Env, uint8_t*, std::vector<uint8_t>* vector) { delete vector; }, owned);
+}
+
+// FILETIME ticks (100 ns since 1601) as ms since 1970, what JS Dates take
+inline double FiletimeToEpochMs(int64_t filetime) {
+    const int64_t kUnixEpochTicks = 116444736000000000LL;  // FILETIME at 1970-01-01
+    return static_cast<double>((filetime - kUnixEpochTicks) / 10000);
+}
+
+// Scheduling options shared by every async job:
+// { priority?: 'visible' | 'normal' | 'prefetch', jobId?: number }
+struct JobOptions {
+    JobPriority priority = JobPriority::Normal;
+    uint64_t jobId = 0;  // for cancelJob; 0 = only reachable through cancelJobsUnder
+};
+
+// Read JobOptions from an options object (anything else leaves the
+// defaults). Throws and returns false on an unknown priority.
+inline bool ReadJobOptions(Napi::Env env, const Napi::Value& value, JobOptions* options) {
+    if (!value.IsObject()) return true;
+    Napi::Object object = value.As<Napi::Object>();
+    Napi::Value priority = object.Get("priority");
+    if (!priority.IsUndefined()) {
+        std::string name = priority.IsString() ? priority.As<Napi::String>().Utf8Value() : "";
+        if (name == "visible") {
+            options->priority = JobPriority::Visible;
+        } else if (name == "normal") {
+            options->priority = JobPriority::Normal;
+        } else if (name == "prefetch") {
+            options->priority = JobPriority::Prefetch;
+        } else {
+            Napi::TypeError::New(env, "priority must be 'visible', 'normal' or 'prefetch'")
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    Napi::Value jobId = object.Get("jobId");
+    if (jobId.IsNumber()) options->jobId = static_cast<uint64_t>(jobId.As<Napi::Number>().Int64Value());
+    return true;
+}
+
+// Settles a Promise from any thread. Create on the JS thread, hand the
+// pointer to a worker, and call Resolve exactly once; the builder runs on
+// the JS thread and produces the resolution value. The object deletes
+// itself once the JS side has run.
+class AsyncCompletion {
+public:
+    using Builder = std::function<Napi::Value(Napi::Env)>;
+
+    static AsyncCompletion* Create(Napi::Env env, const char* resourceName) {
+        auto* completion = new AsyncCompletion(env);
+        completion->m_tsfn = Napi::ThreadSafeFunction::New(
+            env,
+            Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+            resourceName, 0, 1, completion,
+            [](Napi::Env, AsyncCompletion* self) { delete self; });
+        return completion;
+    }
+
+    Napi::Promise Promise() const { return m_deferred.Promise(); }
+
+    // Run fn on the JS thread without settling (progress / partial results)
+    void Emit(std::function<void(Napi::Env)> fn) {
+        auto* data = new std::function<void(Napi::Env)>(std::move(fn));
+        napi_status status = m_tsfn.BlockingCall(data,
+            [](Napi::Env env, Napi::Function, std::function<void(Napi::Env)>* call) {
+                if (env != nullptr) (*call)(env);
+                delete call;
+            });
+        if (status != napi_ok) delete data;
+    }
+
+    void Resolve(Builder builder) {
+        AsyncCompletion* self = this;
+        Emit([self, builder](Napi::Env env) {
+            self->m_deferred.Resolve(builder(env));
+        });
+        m_tsfn.Release();
+    }
+
+private:
+    explicit AsyncCompletion(Napi::Env env) : m_deferred(Napi::Promise::Deferred::New(env)) {}
+
+    Napi::Promise::Deferred m_deferred;
+    Napi::ThreadSafeFunction m_tsfn;
+};
@@ -0,0 +1,73 @@
+/**
+ * Aligned Buffer Pool
+ */
+
+#include "aligned_buffer_pool.h"
+
+#include <windows.h>
+
+// VirtualAlloc hands out address space in 64 KB units anyway
+static const size_t kGranularity = 64 * 1024;
+
+// Enough for every hash and copy slot at full concurrency to start warm
+static const size_t kMaxCachedBytes = 64 * 1024 * 1024;
+
+static size_t RoundUp(size_t size) {
+    return (size + kGranularity - 1) / kGranularity * kGranularity;
+}
+
+AlignedBufferPool& AlignedBufferPool::Shared() {
+    static AlignedBufferPool pool;
+    return pool;
+}
+
+AlignedBufferPool::~AlignedBufferPool() {
+    Trim();
+}
+
+uint8_t* AlignedBufferPool::Acquire(size_t size) {
+    size_t rounded = RoundUp(size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = m_free.size(); i-- > 0;) {
+            if (m_free[i].first != rounded) continue;
+            uint8_t* buffer = m_free[i].second;
+            m_free[i] = m_free.back();
+            m_free.pop_back();
+            m_cachedBytes -= rounded;
+            return buffer;
+        }
+    }
+    return static_cast<uint8_t*>(VirtualAlloc(nullptr, rounded, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+}
+
+void AlignedBufferPool::Release(uint8_t* buffer, size_t size) {
+    if (!buffer) return;
+    size_t rounded = RoundUp(size);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cachedBytes + rounded <= kMaxCachedBytes) {
+            m_free.emplace_back(rounded, buffer);
+            m_cachedBytes += rounded;
+            return;
+        }
+    }
+    VirtualFree(buffer, 0, MEM_RELEASE);
+}
+
+void AlignedBufferPool::Trim() {
+    std::vector<std::pair<size_t, uint8_t*>> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        released.swap(m_free);
+        m_cachedBytes = 0;
+    }
+    for (auto& entry : released) {
+        VirtualFree(entry.second, 0, MEM_RELEASE);
+    }
+}
+
+size_t AlignedBufferPool::CachedBytes() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cachedBytes;
+}
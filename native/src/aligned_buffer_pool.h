@@ -0,0 +1,44 @@
+/**
+ * Aligned Buffer Pool
+ *
+ * Page-aligned I/O buffers, as unbuffered reads and writes require, kept
+ * for reuse instead of a VirtualAlloc / VirtualFree pair per file or per
+ * slot. Sizes are rounded up to the 64 KB allocation granularity, so a
+ * buffer is always a whole number of sectors. Freed buffers are cached up
+ * to a fixed total and released beyond it.
+ *
+ * Thread-safe; shared by the hash engine, the copy engine and chunk readers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class AlignedBufferPool {
+public:
+    static AlignedBufferPool& Shared();
+
+    // A committed, page-aligned buffer of at least size bytes; nullptr if
+    // the allocation fails. Give it back with the same size.
+    uint8_t* Acquire(size_t size);
+    void Release(uint8_t* buffer, size_t size);
+
+    // Free every cached buffer (memory pressure)
+    void Trim();
+
+    size_t CachedBytes();
+
+private:
+    AlignedBufferPool() = default;
+    ~AlignedBufferPool();
+    AlignedBufferPool(const AlignedBufferPool&) = delete;
+    AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+    std::mutex m_mutex;
+    std::vector<std::pair<size_t, uint8_t*>> m_free;  // rounded size, buffer
+    size_t m_cachedBytes = 0;
+};
@@ -0,0 +1,355 @@
+/**
+ * Bounds Sync
+ */
+
+#include "bounds_sync.h"
+
+#include <dwmapi.h>
+#include <algorithm>
+#include <cmath>
+
+#include "native_stats.h"
+
+#pragma comment(lib, "dwmapi.lib")
+
+// Frames without a change before the pacer parks (about a second at 60 Hz)
+static const int kParkAfterFrames = 60;
+
+// A parked pacer still looks this often, for previews whose control was
+// still being attached when it parked
+static const DWORD kParkedPollMs = 250;
+
+// Frame pacing when DwmFlush fails (composition off, remote session)
+static const DWORD kFallbackFrameMs = 16;
+
+// Reads of a slot that keeps showing a write in progress before giving up
+// until the next frame
+static const int kReadRetries = 64;
+
+static const UINT kMoveFlags = SWP_NOZORDER | SWP_NOACTIVATE;
+
+// One consistent read of a slot
+struct Bounds {
+    double x, y, width, height, zoom;
+    int32_t flags;
+};
+
+struct BoundsSync::Entry {
+    uint64_t id = 0;
+    BoundsTarget target;
+
+    // Pacer only: the last slot contents read, and the scale applied to them
+    bool seen = false;
+    LONG sequence = 0;
+    Bounds bounds = {};
+    double scale = 0;
+
+    // Newest physical rect, for whichever of the batch or the async path
+    // gets to it first
+    std::mutex mutex;
+    RECT rect = {};
+    bool visible = true;
+    bool dirty = false;
+    int visibleApplied = -1;  // -1 until the first move sets it
+    int64_t since = 0;        // NativeStats time the oldest unapplied rect was read
+
+    std::atomic<bool> removed{false};
+};
+
+// The entries waiting for one apartment's next batch job
+struct BoundsSync::Batch {
+    StaThread* apartment = nullptr;
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Entry>> entries;
+    bool posted = false;
+};
+
+struct BoundsSync::Move {
+    HWND parent;
+    HWND window;
+    RECT rect;
+    UINT flags;
+    int64_t since;
+};
+
+// Full-barrier read, so the field reads can't move across it
+static LONG LoadSequence(const BoundsSlot* slot) {
+    return InterlockedCompareExchange(const_cast<volatile LONG*>(&slot->sequence), 0, 0);
+}
+
+// Per-monitor DPI of the window (Windows 10 1607+), else the system DPI
+static UINT WindowDpi(HWND hwnd) {
+    using GetDpiForWindowFn = UINT(WINAPI*)(HWND);
+    static const GetDpiForWindowFn getDpiForWindow = reinterpret_cast<GetDpiForWindowFn>(
+        GetProcAddress(GetModuleHandleW(L"user32.dll"), "GetDpiForWindow"));
+    if (getDpiForWindow && hwnd) {
+        UINT dpi = getDpiForWindow(hwnd);
+        if (dpi) return dpi;
+    }
+    HDC screen = GetDC(nullptr);
+    int dpi = screen ? GetDeviceCaps(screen, LOGPIXELSX) : USER_DEFAULT_SCREEN_DPI;
+    if (screen) ReleaseDC(nullptr, screen);
+    return dpi > 0 ? static_cast<UINT>(dpi) : USER_DEFAULT_SCREEN_DPI;
+}
+
+BoundsSync& BoundsSync::Shared() {
+    static BoundsSync sync;
+    return sync;
+}
+
+uint64_t BoundsSync::Add(const BoundsTarget& target) {
+    if (!target.slot || !target.apartment || !target.container) return 0;
+
+    auto entry = std::make_shared<Entry>();
+    entry->target = target;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) {
+        if (!m_wake) m_wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!m_wake) return 0;
+        m_stop = false;
+        m_thread = std::thread(&BoundsSync::Run, this);
+    }
+    entry->id = m_nextId++;
+    m_entries.push_back(entry);
+    SetEvent(m_wake);
+    return entry->id;
+}
+
+void BoundsSync::Remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(),
+        [id](const std::shared_ptr<Entry>& entry) { return entry->id == id; });
+    if (it == m_entries.end()) return;
+    (*it)->removed = true;
+    m_entries.erase(it);
+}
+
+void BoundsSync::Wake() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_wake) SetEvent(m_wake);
+}
+
+void BoundsSync::Stop() {
+    // Join outside the lock: the pacer takes it every frame
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        thread.swap(m_thread);
+        m_stop = true;
+        if (m_wake) SetEvent(m_wake);
+    }
+    if (thread.joinable()) thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::shared_ptr<Entry>& entry : m_entries) entry->removed = true;
+    m_entries.clear();
+    m_batches.clear();
+    if (m_wake) CloseHandle(m_wake);
+    m_wake = nullptr;
+}
+
+void BoundsSync::Run() {
+    // A move that misses its frame is a visible stutter
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+    int idleFrames = 0;
+    bool parked = false;
+    while (!m_stop) {
+        std::vector<std::shared_ptr<Entry>> changed;
+        bool syncing = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            syncing = !m_entries.empty();
+            for (const std::shared_ptr<Entry>& entry : m_entries) {
+                if (PollLocked(*entry)) changed.push_back(entry);
+            }
+            if (!changed.empty()) {
+                idleFrames = 0;
+                if (parked) SetParkedLocked(0);
+                parked = false;
+            } else if (syncing && !parked && ++idleFrames >= kParkAfterFrames) {
+                // Look once more after publishing the flag: a write that
+                // landed before the writer could see it is caught here
+                SetParkedLocked(1);
+                parked = true;
+                continue;
+            }
+        }
+
+        if (!changed.empty()) Dispatch(changed);
+
+        if (!syncing) {
+            WaitForSingleObject(m_wake, INFINITE);
+        } else if (parked) {
+            WaitForSingleObject(m_wake, kParkedPollMs);
+        } else if (FAILED(DwmFlush())) {
+            Sleep(kFallbackFrameMs);
+        }
+    }
+}
+
+// A move is due when the slot has a new rect, or when the parent's DPI
+// changed under an old one (the window was dragged to another monitor)
+bool BoundsSync::PollLocked(Entry& entry) {
+    HWND container = entry.target.container->load();
+    if (!container) return false;
+
+    const BoundsSlot* slot = entry.target.slot;
+    bool fresh = false;
+    for (int attempt = 0; attempt < kReadRetries; attempt++) {
+        LONG sequence = LoadSequence(slot);
+        if (sequence & 1) {
+            YieldProcessor();
+            continue;
+        }
+        if (sequence == 0 || (entry.seen && sequence == entry.sequence)) break;
+        Bounds bounds = { slot->x, slot->y, slot->width, slot->height, slot->zoom, slot->flags };
+        if (LoadSequence(slot) != sequence) continue;
+        entry.seen = true;
+        entry.sequence = sequence;
+        entry.bounds = bounds;
+        fresh = true;
+        break;
+    }
+    if (!entry.seen) return false;
+
+    const Bounds& bounds = entry.bounds;
+    if (!std::isfinite(bounds.x) || !std::isfinite(bounds.y) ||
+        !std::isfinite(bounds.width) || !std::isfinite(bounds.height)) {
+        return false;
+    }
+    double zoom = std::isfinite(bounds.zoom) && bounds.zoom > 0 ? bounds.zoom : 1.0;
+    HWND parent = GetAncestor(container, GA_PARENT);
+    double scale = WindowDpi(parent) / static_cast<double>(USER_DEFAULT_SCREEN_DPI) * zoom;
+    if (!fresh && scale == entry.scale) return false;
+    entry.scale = scale;
+
+    // Round the edges, not the size: adjacent rects keep sharing an edge
+    RECT rect;
+    rect.left = std::lround(bounds.x * scale);
+    rect.top = std::lround(bounds.y * scale);
+    rect.right = std::lround((bounds.x + std::max(bounds.width, 0.0)) * scale);
+    rect.bottom = std::lround((bounds.y + std::max(bounds.height, 0.0)) * scale);
+
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (!entry.dirty) entry.since = NativeStats::Now();
+    entry.rect = rect;
+    entry.visible = (bounds.flags & kBoundsVisible) != 0;
+    entry.dirty = true;
+    return true;
+}
+
+void BoundsSync::SetParkedLocked(LONG parked) {
+    for (const std::shared_ptr<Entry>& entry : m_entries) {
+        InterlockedExchange(const_cast<volatile LONG*>(&entry->target.slot->parked), parked);
+    }
+}
+
+// Pacer thread: hand this frame's moves to their apartments
+void BoundsSync::Dispatch(const std::vector<std::shared_ptr<Entry>>& changed) {
+    for (const std::shared_ptr<Entry>& entry : changed) {
+        StaThread* apartment = entry->target.apartment;
+        auto it = std::find_if(m_batches.begin(), m_batches.end(),
+            [apartment](const std::shared_ptr<Batch>& batch) { return batch->apartment == apartment; });
+        std::shared_ptr<Batch> batch;
+        if (it != m_batches.end()) {
+            batch = *it;
+        } else {
+            batch = std::make_shared<Batch>();
+            batch->apartment = apartment;
+            m_batches.push_back(batch);
+        }
+
+        if (apartment->IsBusy()) {
+            // Inside OpenDoc: move now, asynchronously, rather than wait.
+            // The window's thread applies it from OpenDoc's own pumping.
+            Move move;
+            if (TakeMove(*entry, &move)) {
+                SetWindowPos(move.window, nullptr, move.rect.left, move.rect.top,
+                    move.rect.right - move.rect.left, move.rect.bottom - move.rect.top,
+                    move.flags | SWP_ASYNCWINDOWPOS);
+                NativeStats::Record(NativeOp::SyncBounds, move.since);
+            }
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        if (std::find(batch->entries.begin(), batch->entries.end(), entry) == batch->entries.end()) {
+            batch->entries.push_back(entry);
+        }
+        if (!batch->posted) {
+            // The job reads each entry's rect when it runs, so a job still
+            // queued at the next frame just picks up the newer rect
+            batch->posted = apartment->Post([batch]() { ApplyBatch(batch); });
+            if (!batch->posted) batch->entries.clear();
+        }
+    }
+}
+
+// Take the entry's pending rect as a move; false if there is none
+bool BoundsSync::TakeMove(Entry& entry, Move* move) {
+    if (entry.removed) return false;
+    HWND window = entry.target.container->load();
+    if (!window) return false;
+
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (!entry.dirty) return false;
+    entry.dirty = false;
+
+    move->window = window;
+    move->parent = nullptr;
+    move->rect = entry.rect;
+    move->flags = kMoveFlags;
+    move->since = entry.since;
+    if (entry.visibleApplied != (entry.visible ? 1 : 0)) {
+        move->flags |= entry.visible ? SWP_SHOWWINDOW : SWP_HIDEWINDOW;
+        entry.visibleApplied = entry.visible ? 1 : 0;
+    }
+    return true;
+}
+
+// Apartment thread: one deferred-position batch per parent window
+void BoundsSync::ApplyBatch(const std::shared_ptr<Batch>& batch) {
+    std::vector<std::shared_ptr<Entry>> entries;
+    {
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        entries.swap(batch->entries);
+        batch->posted = false;
+    }
+
+    std::vector<Move> moves;
+    moves.reserve(entries.size());
+    for (const std::shared_ptr<Entry>& entry : entries) {
+        Move move;
+        if (!TakeMove(*entry, &move)) continue;
+        move.parent = GetAncestor(move.window, GA_PARENT);
+        moves.push_back(move);
+    }
+    std::stable_sort(moves.begin(), moves.end(),
+        [](const Move& a, const Move& b) { return a.parent < b.parent; });
+
+    for (size_t first = 0; first < moves.size();) {
+        size_t last = first;
+        while (last < moves.size() && moves[last].parent == moves[first].parent) last++;
+
+        HDWP positions = BeginDeferWindowPos(static_cast<int>(last - first));
+        for (size_t i = first; i < last && positions; i++) {
+            const Move& move = moves[i];
+            positions = DeferWindowPos(positions, move.window, nullptr, move.rect.left, move.rect.top,
+                move.rect.right - move.rect.left, move.rect.bottom - move.rect.top, move.flags);
+        }
+        if (positions) {
+            EndDeferWindowPos(positions);
+        } else {
+            // A failed DeferWindowPos drops the whole batch: move one by one
+            for (size_t i = first; i < last; i++) {
+                const Move& move = moves[i];
+                SetWindowPos(move.window, nullptr, move.rect.left, move.rect.top,
+                    move.rect.right - move.rect.left, move.rect.bottom - move.rect.top, move.flags);
+            }
+        }
+        for (size_t i = first; i < last; i++) NativeStats::Record(NativeOp::SyncBounds, moves[i].since);
+        first = last;
+    }
+}
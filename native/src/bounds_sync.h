@@ -0,0 +1,111 @@
+/**
+ * Bounds Sync
+ *
+ * Moves embedded preview windows in step with the DOM without a call per
+ * rect. Each synced preview has a 64-byte BoundsSlot in memory JS owns (an
+ * ArrayBuffer the binding keeps alive): JS overwrites it whenever the
+ * placeholder element moves, and one pacer thread reads every slot once
+ * per composition frame (DwmFlush), so a flood of rects during a splitter
+ * drag costs at most one move per preview per frame. Only the newest rect
+ * of a frame matters, so a slot holds one rect rather than a queue.
+ *
+ * Slots are seqlocked: the writer bumps `sequence` to odd, writes the
+ * fields, and bumps it to even; the pacer retries a read that saw an odd
+ * or a changing sequence, and ignores a slot still at sequence 0. Rects are
+ * CSS pixels relative to the parent's client area. The pacer scales them
+ * by the parent window's DPI and the page zoom, rounding edges rather than
+ * sizes so neighbours never gap. The DPI is per monitor and re-read every
+ * frame: a window dragged to another screen is moved again without JS
+ * writing anything.
+ *
+ * The moves of one frame are applied on the apartment that owns the
+ * windows, all of them in one BeginDeferWindowPos batch per parent, so
+ * side-by-side previews move and repaint together. While that apartment is
+ * busy (OpenDoc), its windows get SWP_ASYNCWINDOWPOS moves from the pacer
+ * instead, as setBounds does, so a load never freezes the layout.
+ *
+ * After a second without changes the pacer parks: it sets every slot's
+ * `parked` word and waits for Wake(), which the writer calls when it sees
+ * that word set after a write. Both sides fence between their store and
+ * their load, so a wake is never lost.
+ *
+ * Thread-safe. N-API free.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sta_thread.h"
+
+// Byte layout shared with index.js
+struct BoundsSlot {
+    volatile LONG sequence;   // writer: odd while a write is in progress
+    volatile LONG parked;     // pacer: 1 while it waits for Wake()
+    double x;                 // CSS pixels in the parent's client area
+    double y;
+    double width;
+    double height;
+    double zoom;              // page zoom factor; 0 reads as 1
+    int32_t flags;            // kBoundsVisible
+    int32_t reserved[3];
+};
+static_assert(sizeof(BoundsSlot) == 64, "BoundsSlot layout is shared with JS");
+
+static const int32_t kBoundsVisible = 1;
+
+struct BoundsTarget {
+    const BoundsSlot* slot = nullptr;               // read until Remove returns
+    StaThread* apartment = nullptr;                 // owns the container window
+    const std::atomic<HWND>* container = nullptr;   // null until attached
+    std::shared_ptr<void> owner;                    // keeps `container` alive
+};
+
+class BoundsSync {
+public:
+    static BoundsSync& Shared();
+
+    // Start syncing a window from its slot; starts the pacer on first use.
+    // Returns an id for Remove, 0 if the pacer could not start.
+    uint64_t Add(const BoundsTarget& target);
+
+    // Stop syncing; once it returns the slot is never touched again
+    void Remove(uint64_t id);
+
+    // Un-park the pacer after a write. Cheap; safe from any thread.
+    void Wake();
+
+    // Join the pacer. Moves not yet applied are dropped.
+    void Stop();
+
+private:
+    struct Entry;
+    struct Batch;
+    struct Move;
+
+    BoundsSync() = default;
+    BoundsSync(const BoundsSync&) = delete;
+    BoundsSync& operator=(const BoundsSync&) = delete;
+
+    void Run();
+    bool PollLocked(Entry& entry);
+    void SetParkedLocked(LONG parked);
+    void Dispatch(const std::vector<std::shared_ptr<Entry>>& changed);
+    static bool TakeMove(Entry& entry, Move* move);
+    static void ApplyBatch(const std::shared_ptr<Batch>& batch);
+
+    std::mutex m_mutex;  // guards m_entries and every slot read
+    std::vector<std::shared_ptr<Entry>> m_entries;
+    std::vector<std::shared_ptr<Batch>> m_batches;  // one per apartment; pacer thread only
+    uint64_t m_nextId = 1;
+
+    std::thread m_thread;
+    HANDLE m_wake = nullptr;
+    std::atomic<bool> m_stop{false};
+};
@@ -0,0 +1,206 @@
+/**
+ * NTFS Change Journal
+ */
+
+#include "change_journal.h"
+
+#include <windows.h>
+#include <winioctl.h>
+#include <unordered_map>
+
+#ifndef FSCTL_READ_UNPRIVILEGED_USN_JOURNAL
+#define FSCTL_READ_UNPRIVILEGED_USN_JOURNAL CTL_CODE(FILE_DEVICE_FILE_SYSTEM, 234, METHOD_NEITHER, FILE_ANY_ACCESS)
+#endif
+
+static const DWORD kReadBufferSize = 64 * 1024;
+
+class JournalHandle {
+public:
+    ~JournalHandle() {
+        if (m_handle != INVALID_HANDLE_VALUE) CloseHandle(m_handle);
+    }
+
+    bool Open(const std::wstring& volume) {
+        // The volume device itself (\\?\Volume{GUID}, no trailing slash)
+        // needs administrator rights
+        std::wstring device = volume;
+        if (!device.empty() && device.back() == L'\\') device.pop_back();
+        m_handle = CreateFileW(device.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr, OPEN_EXISTING, 0, nullptr);
+        if (m_handle != INVALID_HANDLE_VALUE) return true;
+
+        // Anyone can read through a handle to the volume root
+        m_handle = CreateFileW(volume.c_str(), FILE_READ_ATTRIBUTES,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        m_unprivileged = true;
+        return m_handle != INVALID_HANDLE_VALUE;
+    }
+
+    bool Query(USN_JOURNAL_DATA_V0* data, std::string* error) {
+        DWORD bytes = 0;
+        if (DeviceIoControl(m_handle, FSCTL_QUERY_USN_JOURNAL, nullptr, 0, data, sizeof(*data), &bytes, nullptr)) {
+            return true;
+        }
+        DWORD lastError = GetLastError();
+        if (lastError == ERROR_JOURNAL_NOT_ACTIVE || lastError == ERROR_JOURNAL_DELETE_IN_PROGRESS) {
+            *error = "Change journal is not active on this volume";
+        } else if (lastError == ERROR_INVALID_FUNCTION) {
+            *error = "Volume has no change journal";
+        } else if (lastError == ERROR_ACCESS_DENIED) {
+            *error = "Change journal access denied";
+        } else {
+            *error = "Could not query change journal";
+        }
+        return false;
+    }
+
+    BOOL Read(READ_USN_JOURNAL_DATA_V1* request, void* buffer, DWORD size, DWORD* bytes) {
+        DWORD code = m_unprivileged ? FSCTL_READ_UNPRIVILEGED_USN_JOURNAL : FSCTL_READ_USN_JOURNAL;
+        return DeviceIoControl(m_handle, code, request, sizeof(*request), buffer, size, bytes, nullptr);
+    }
+
+private:
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+    bool m_unprivileged = false;
+};
+
+static bool VolumeForPath(const std::wstring& path, std::wstring* volume) {
+    wchar_t mountPoint[MAX_PATH];
+    wchar_t name[64];
+    if (!GetVolumePathNameW(path.c_str(), mountPoint, MAX_PATH)) return false;
+    if (!GetVolumeNameForVolumeMountPointW(mountPoint, name, 64)) return false;
+    *volume = name;
+    return true;
+}
+
+static JournalChangeKind Classify(uint32_t reasons) {
+    if (reasons & USN_REASON_FILE_DELETE) return JournalChangeKind::Deleted;
+    if (reasons & USN_REASON_FILE_CREATE) return JournalChangeKind::Created;
+    if (reasons & (USN_REASON_RENAME_NEW_NAME | USN_REASON_RENAME_OLD_NAME)) return JournalChangeKind::Renamed;
+    return JournalChangeKind::Modified;
+}
+
+JournalChanges QueryJournalCursor(const std::wstring& path) {
+    JournalChanges result;
+    if (!VolumeForPath(path, &result.cursor.volume)) {
+        result.error = "Could not resolve volume";
+        return result;
+    }
+
+    JournalHandle journal;
+    if (!journal.Open(result.cursor.volume)) {
+        result.error = "Could not open volume";
+        return result;
+    }
+
+    USN_JOURNAL_DATA_V0 data = {};
+    if (!journal.Query(&data, &result.error)) return result;
+
+    result.cursor.journalId = data.UsnJournalID;
+    result.cursor.usn = data.NextUsn;
+    result.success = true;
+    return result;
+}
+
+JournalChanges ReadJournalChanges(const JournalCursor& cursor, uint32_t maxRecords) {
+    JournalChanges result;
+    result.cursor = cursor;
+
+    JournalHandle journal;
+    if (!journal.Open(cursor.volume)) {
+        result.error = "Could not open volume";
+        return result;
+    }
+
+    USN_JOURNAL_DATA_V0 data = {};
+    if (!journal.Query(&data, &result.error)) return result;
+
+    // Recreated journal, or the cursor fell off the end of a full one
+    if (data.UsnJournalID != cursor.journalId || cursor.usn < data.FirstUsn || cursor.usn > data.NextUsn) {
+        result.cursor.journalId = data.UsnJournalID;
+        result.cursor.usn = data.NextUsn;
+        result.reset = true;
+        result.success = true;
+        return result;
+    }
+
+    READ_USN_JOURNAL_DATA_V1 request = {};
+    request.StartUsn = cursor.usn;
+    request.ReasonMask = 0xFFFFFFFF;
+    request.ReturnOnlyOnClose = FALSE;
+    request.UsnJournalID = data.UsnJournalID;
+    request.MinMajorVersion = 2;
+    request.MaxMajorVersion = 2;
+
+    std::vector<uint64_t> buffer(kReadBufferSize / sizeof(uint64_t));
+    std::unordered_map<uint64_t, size_t> byFileId;
+    uint32_t records = 0;
+
+    // Stop at the end as it was when we started, so a busy volume can't
+    // keep the loop going
+    while (request.StartUsn < data.NextUsn) {
+        DWORD bytes = 0;
+        if (!journal.Read(&request, buffer.data(), kReadBufferSize, &bytes)) {
+            if (GetLastError() == ERROR_JOURNAL_ENTRY_DELETED) {
+                result.changes.clear();
+                result.cursor.usn = data.NextUsn;
+                result.reset = true;
+                result.success = true;
+                return result;
+            }
+            result.error = "Could not read change journal";
+            return result;
+        }
+        if (bytes <= sizeof(USN)) break;
+
+        auto* base = reinterpret_cast<const uint8_t*>(buffer.data());
+        USN next = *reinterpret_cast<const USN*>(base);
+        for (DWORD offset = sizeof(USN); offset + sizeof(USN_RECORD_V2) <= bytes;) {
+            auto* record = reinterpret_cast<const USN_RECORD_V2*>(base + offset);
+            if (record->RecordLength == 0) break;
+            offset += record->RecordLength;
+            if (record->MajorVersion != 2) continue;
+            records++;
+
+            auto found = byFileId.find(record->FileReferenceNumber);
+            if (found == byFileId.end()) {
+                found = byFileId.emplace(record->FileReferenceNumber, result.changes.size()).first;
+                result.changes.emplace_back();
+                result.changes.back().fileId = record->FileReferenceNumber;
+            }
+
+            JournalChange& change = result.changes[found->second];
+            change.reasons |= record->Reason;
+            change.isDirectory = (record->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+            // The old-name half of a rename carries the name being replaced
+            if (!(record->Reason & USN_REASON_RENAME_OLD_NAME) || change.name.empty()) {
+                change.parentId = record->ParentFileReferenceNumber;
+                change.name.assign(reinterpret_cast<const wchar_t*>(
+                    reinterpret_cast<const uint8_t*>(record) + record->FileNameOffset),
+                    record->FileNameLength / sizeof(wchar_t));
+            }
+        }
+
+        request.StartUsn = next;
+        if (maxRecords && records >= maxRecords) {
+            result.more = request.StartUsn < data.NextUsn;
+            break;
+        }
+    }
+    result.cursor.usn = request.StartUsn;
+
+    // Settle each file's net change; created-then-deleted files vanish
+    size_t kept = 0;
+    for (size_t i = 0; i < result.changes.size(); i++) {
+        JournalChange& change = result.changes[i];
+        if ((change.reasons & USN_REASON_FILE_CREATE) && (change.reasons & USN_REASON_FILE_DELETE)) continue;
+        change.kind = Classify(change.reasons);
+        if (kept != i) result.changes[kept] = std::move(change);
+        kept++;
+    }
+    result.changes.resize(kept);
+
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,53 @@
+/**
+ * NTFS Change Journal
+ *
+ * Reads the volume's USN journal from a saved position so a rescan only
+ * has to look at files that actually changed. Records are collapsed per
+ * file ID: a file written a hundred times since the cursor is reported
+ * once, and one created and deleted in between is not reported at all.
+ *
+ * Opens the volume itself when the process may (administrator), and
+ * otherwise the volume root with FSCTL_READ_UNPRIVILEGED_USN_JOURNAL
+ * (Windows 10 1709+), which returns the same records without names of
+ * files the caller cannot see.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class JournalChangeKind { Created, Modified, Renamed, Deleted };
+
+struct JournalChange {
+    uint64_t fileId = 0;
+    uint64_t parentId = 0;   // directory holding the file's latest name
+    std::wstring name;       // latest name, without directory
+    JournalChangeKind kind = JournalChangeKind::Modified;
+    uint32_t reasons = 0;    // every USN_REASON_* seen for the file
+    bool isDirectory = false;
+};
+
+struct JournalCursor {
+    std::wstring volume;     // \\?\Volume{GUID}\ of the volume
+    uint64_t journalId = 0;
+    int64_t usn = 0;         // next record to read
+};
+
+struct JournalChanges {
+    bool success = false;
+    std::string error;
+    JournalCursor cursor;    // where the next call should continue
+    std::vector<JournalChange> changes;
+    // The journal was recreated or has wrapped past the cursor: changes are
+    // lost and the caller must do a full rescan from `cursor` on
+    bool reset = false;
+    bool more = false;       // stopped at maxRecords; call again
+};
+
+// Current end of the journal for the volume holding `path`, to start from
+JournalChanges QueryJournalCursor(const std::wstring& path);
+
+// Changes after `cursor`, at most maxRecords raw journal records per call
+JournalChanges ReadJournalChanges(const JournalCursor& cursor, uint32_t maxRecords);
@@ -0,0 +1,126 @@
+/**
+ * Change Journal Bindings
+ *
+ * getChangesSince(cursor | path, { maxRecords }) -> Promise<JournalChanges>
+ *
+ * Given a path, returns the journal's current end as a starting cursor and
+ * no changes. Given a cursor from an earlier call, returns every file that
+ * changed after it and the cursor to save for next time. Cursors are plain
+ * strings ({ volume, journalId, usn }) so they can be persisted as JSON;
+ * file IDs are BigInts, comparable with enumerateTree's fileId column.
+ *
+ * The journal is read on the shared worker pool.
+ */
+
+#include "addon.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "change_journal.h"
+#include "thread_pool.h"
+
+static const uint32_t kDefaultMaxRecords = 200000;
+
+struct JournalRequest {
+    bool fromPath = false;
+    std::wstring path;
+    JournalCursor cursor;
+    uint32_t maxRecords = kDefaultMaxRecords;
+    JournalChanges result;
+};
+
+static const char* KindName(JournalChangeKind kind) {
+    switch (kind) {
+        case JournalChangeKind::Created: return "created";
+        case JournalChangeKind::Renamed: return "renamed";
+        case JournalChangeKind::Deleted: return "deleted";
+        default: return "modified";
+    }
+}
+
+static Napi::Value BuildJournalChanges(Napi::Env env, JournalChanges& changes) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, changes.success));
+    if (!changes.success) {
+        result.Set("error", Napi::String::New(env, changes.error));
+        return result;
+    }
+
+    Napi::Object cursor = Napi::Object::New(env);
+    cursor.Set("volume", WideToJs(env, changes.cursor.volume));
+    cursor.Set("journalId", Napi::String::New(env, std::to_string(changes.cursor.journalId)));
+    cursor.Set("usn", Napi::String::New(env, std::to_string(changes.cursor.usn)));
+    result.Set("cursor", cursor);
+    result.Set("reset", Napi::Boolean::New(env, changes.reset));
+    result.Set("more", Napi::Boolean::New(env, changes.more));
+
+    Napi::Array list = Napi::Array::New(env, changes.changes.size());
+    for (size_t i = 0; i < changes.changes.size(); i++) {
+        const JournalChange& change = changes.changes[i];
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("fileId", Napi::BigInt::New(env, change.fileId));
+        entry.Set("parentId", Napi::BigInt::New(env, change.parentId));
+        entry.Set("name", WideToJs(env, change.name));
+        entry.Set("kind", Napi::String::New(env, KindName(change.kind)));
+        entry.Set("isDirectory", Napi::Boolean::New(env, change.isDirectory));
+        entry.Set("reasons", Napi::Number::New(env, change.reasons));
+        list.Set(static_cast<uint32_t>(i), entry);
+    }
+    result.Set("changes", list);
+    return result;
+}
+
+static bool ParseCursor(Napi::Object object, JournalCursor* cursor) {
+    Napi::Value volume = object.Get("volume");
+    Napi::Value journalId = object.Get("journalId");
+    Napi::Value usn = object.Get("usn");
+    if (!volume.IsString() || !journalId.IsString() || !usn.IsString()) return false;
+
+    cursor->volume = JsToWide(volume);
+    std::string id = journalId.As<Napi::String>().Utf8Value();
+    std::string position = usn.As<Napi::String>().Utf8Value();
+    char* end = nullptr;
+    cursor->journalId = strtoull(id.c_str(), &end, 10);
+    if (id.empty() || *end != '\0') return false;
+    cursor->usn = strtoll(position.c_str(), &end, 10);
+    return !position.empty() && *end == '\0';
+}
+
+// getChangesSince(cursorOrPath: { volume, journalId, usn } | string, options?: { maxRecords?: number })
+static Napi::Value GetChangesSince(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto request = std::make_shared<JournalRequest>();
+
+    if (info.Length() >= 1 && info[0].IsString()) {
+        request->fromPath = true;
+        request->path = JsToWide(info[0]);
+    } else if (info.Length() < 1 || !info[0].IsObject() || !ParseCursor(info[0].As<Napi::Object>(), &request->cursor)) {
+        Napi::TypeError::New(env, "Journal cursor or path expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Value maxRecords = info[1].As<Napi::Object>().Get("maxRecords");
+        if (maxRecords.IsNumber()) request->maxRecords = maxRecords.As<Napi::Number>().Uint32Value();
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "getChangesSince");
+    Napi::Promise promise = completion->Promise();
+
+    ThreadPool::Shared().Submit([request, completion]() {
+        request->result = request->fromPath
+            ? QueryJournalCursor(request->path)
+            : ReadJournalChanges(request->cursor, request->maxRecords);
+        completion->Resolve([request](Napi::Env env) {
+            return BuildJournalChanges(env, request->result);
+        });
+    });
+
+    return promise;
+}
+
+void InitChangeJournalBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("getChangesSince", Napi::Function::New(env, GetChangesSince));
+}
@@ -0,0 +1,191 @@
+/**
+ * Chunk Reader
+ */
+
+#include "chunk_reader.h"
+
+#include <algorithm>
+
+#include "aligned_buffer_pool.h"
+#include "native_stats.h"
+#include "unbuffered_io.h"
+
+static const size_t kGranularity = 64 * 1024;
+
+std::shared_ptr<ChunkReader> ChunkReader::Open(const std::wstring& path, size_t chunkSize,
+    CancelTokenPtr token, std::string* error) {
+    std::shared_ptr<ChunkReader> reader(new ChunkReader());
+    reader->m_path = path;
+    reader->m_token = std::move(token);
+    if (chunkSize == 0) chunkSize = kDefaultChunkSize;
+    chunkSize = (chunkSize + kGranularity - 1) / kGranularity * kGranularity;
+    reader->m_chunkSize = std::min(std::max(chunkSize, size_t(kMinChunkSize)), size_t(kMaxChunkSize));
+
+    reader->m_file = OpenForUnbufferedRead(path);
+    if (reader->m_file == INVALID_HANDLE_VALUE) {
+        DWORD openError = GetLastError();
+        *error = openError == ERROR_FILE_NOT_FOUND || openError == ERROR_PATH_NOT_FOUND
+            ? "File not found" : "Could not open file";
+        return nullptr;
+    }
+
+    LARGE_INTEGER size = {};
+    reader->m_overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!GetFileSizeEx(reader->m_file, &size) || !reader->m_overlapped.hEvent) {
+        *error = "Could not open file";
+        return nullptr;
+    }
+    reader->m_size = static_cast<uint64_t>(size.QuadPart);
+
+    // Start reading before the first Next()
+    const char* readError = reader->m_size > 0 ? reader->IssueRead() : nullptr;
+    if (readError) {
+        *error = readError;
+        return nullptr;
+    }
+    return reader;
+}
+
+ChunkReader::~ChunkReader() {
+    WaitForReadAhead();
+    if (m_ahead) m_free.push_back(m_ahead);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+    if (m_overlapped.hEvent) CloseHandle(m_overlapped.hEvent);
+    // Anything lent holds a reference to the reader, so every buffer is back
+    for (uint8_t* buffer : m_free) {
+        AlignedBufferPool::Shared().Release(buffer, m_chunkSize);
+    }
+}
+
+uint8_t* ChunkReader::AcquireBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free.empty()) {
+            uint8_t* buffer = m_free.back();
+            m_free.pop_back();
+            return buffer;
+        }
+        m_allocated++;
+    }
+    uint8_t* buffer = AlignedBufferPool::Shared().Acquire(m_chunkSize);
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_allocated--;
+    }
+    return buffer;
+}
+
+void ChunkReader::Return(uint8_t* data) {
+    if (!data) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Extra buffers from a caller that held every chunk go back to the pool
+        if (m_allocated <= kBuffers) {
+            m_free.push_back(data);
+            return;
+        }
+        m_allocated--;
+    }
+    AlignedBufferPool::Shared().Release(data, m_chunkSize);
+}
+
+// Start reading the chunk at m_offset into a free buffer. nullptr on
+// success, including a read that ends at once because the file shrank
+// (m_ahead stays null and Next() reports the end).
+const char* ChunkReader::IssueRead() {
+    uint8_t* buffer = AcquireBuffer();
+    if (!buffer) return "Out of memory";
+
+    HANDLE event = m_overlapped.hEvent;
+    ZeroMemory(&m_overlapped, sizeof(m_overlapped));
+    m_overlapped.hEvent = event;
+    m_overlapped.Offset = static_cast<DWORD>(m_offset);
+    m_overlapped.OffsetHigh = static_cast<DWORD>(m_offset >> 32);
+
+    if (!ReadFile(m_file, buffer, static_cast<DWORD>(m_chunkSize), nullptr, &m_overlapped)) {
+        DWORD error = GetLastError();
+        if (error != ERROR_IO_PENDING) {
+            Return(buffer);
+            return error == ERROR_HANDLE_EOF ? nullptr : "Read failed";
+        }
+    }
+    m_ahead = buffer;
+    return nullptr;
+}
+
+void ChunkReader::WaitForReadAhead() {
+    if (!m_ahead) return;
+    CancelIoEx(m_file, &m_overlapped);
+    DWORD ignored = 0;
+    GetOverlappedResult(m_file, &m_overlapped, &ignored, TRUE);
+}
+
+bool ChunkReader::Next(Chunk* chunk) {
+    if (m_finished) {
+        chunk->done = true;
+        return true;
+    }
+    int64_t started = NativeStats::Now();
+
+    auto fail = [this, chunk](const char* error) {
+        WaitForReadAhead();
+        Return(m_ahead);
+        m_ahead = nullptr;
+        m_finished = true;
+        chunk->error = error;
+        return false;
+    };
+
+    if (m_token && m_token->IsCancelled(m_path)) return fail(kCancelledError);
+    if (!m_ahead && m_offset < m_size) {
+        const char* error = IssueRead();
+        if (error) return fail(error);
+    }
+    if (!m_ahead) {
+        // Empty, or shrank to where we are
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hash = m_sha.FinalHex();
+        m_finished = true;
+        chunk->done = true;
+        return true;
+    }
+
+    DWORD got = 0;
+    if (!GetOverlappedResult(m_file, &m_overlapped, &got, TRUE) && GetLastError() != ERROR_HANDLE_EOF) {
+        return fail("Read failed");
+    }
+    uint8_t* data = m_ahead;
+    m_ahead = nullptr;
+
+    chunk->offset = m_offset;
+    m_offset += got;
+    // A short read is end of file, even if the file shrank
+    bool last = got < m_chunkSize || m_offset >= m_size;
+    const char* error = last ? nullptr : IssueRead();
+    if (error) {
+        Return(data);
+        return fail(error);
+    }
+
+    // Hashed while the read-ahead is in flight
+    m_sha.Update(data, got);
+    if (got == 0) {
+        Return(data);
+        data = nullptr;
+    }
+    chunk->data = data;
+    chunk->length = got;
+    if (last) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hash = m_sha.FinalHex();
+        m_finished = true;
+        chunk->done = true;
+    }
+    NativeStats::Record(NativeOp::ReadChunk, started);
+    return true;
+}
+
+std::string ChunkReader::Hash() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hash;
+}
@@ -0,0 +1,94 @@
+/**
+ * Chunk Reader
+ *
+ * Reads one file front to back in fixed-size chunks and keeps a running
+ * SHA-256 of everything handed out, so check-in can hash and upload a file
+ * in a single pass. The file is opened unbuffered and overlapped. While the
+ * caller consumes one chunk, the next is already being read into another
+ * buffer.
+ *
+ * Chunks are lent, not copied: Next() hands out one of the reader's
+ * page-aligned buffers (from AlignedBufferPool), and the caller gives it
+ * back with Return(). The reader keeps at most kBuffers buffers, so memory
+ * per file stays fixed however large the file is. A caller holding on to
+ * every chunk gets extra buffers rather than a stall; they are released on
+ * return instead of kept.
+ *
+ * Next() is for one thread at a time and blocks on disk reads. Return()
+ * may be called from any thread. N-API free.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "job_registry.h"
+#include "sha256.h"
+
+class ChunkReader {
+public:
+    static const size_t kDefaultChunkSize = 1024 * 1024;
+    static const size_t kMinChunkSize = 64 * 1024;
+    static const size_t kMaxChunkSize = 16 * 1024 * 1024;
+    static const size_t kBuffers = 3;  // one read ahead, two with the caller
+
+    struct Chunk {
+        uint8_t* data = nullptr;  // lent; Return() it. Null at end of file.
+        size_t length = 0;
+        uint64_t offset = 0;
+        bool done = false;        // no chunks after this one; Hash() is final
+        std::string error;
+    };
+
+    // chunkSize is rounded up to 64 KB and clamped to the limits above.
+    // nullptr (with *error set) if the file cannot be opened.
+    static std::shared_ptr<ChunkReader> Open(const std::wstring& path, size_t chunkSize,
+        CancelTokenPtr token, std::string* error);
+
+    ~ChunkReader();
+
+    ChunkReader(const ChunkReader&) = delete;
+    ChunkReader& operator=(const ChunkReader&) = delete;
+
+    // The next chunk in file order. False on a read error or cancellation
+    // (chunk->error says which); the reader is finished after that.
+    bool Next(Chunk* chunk);
+
+    void Return(uint8_t* data);
+
+    // Lowercase hex SHA-256 of the whole file once the last chunk is out
+    std::string Hash();
+
+    uint64_t Size() const { return m_size; }
+    size_t ChunkSize() const { return m_chunkSize; }
+
+private:
+    ChunkReader() = default;
+
+    uint8_t* AcquireBuffer();
+    const char* IssueRead();
+    void WaitForReadAhead();
+
+    std::wstring m_path;
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    uint64_t m_size = 0;
+    size_t m_chunkSize = kDefaultChunkSize;
+    CancelTokenPtr m_token;
+
+    // Next() only
+    OVERLAPPED m_overlapped = {};
+    uint8_t* m_ahead = nullptr;  // buffer the in-flight read targets
+    uint64_t m_offset = 0;       // next byte to read
+    bool m_finished = false;
+    Sha256 m_sha;
+
+    std::mutex m_mutex;
+    std::vector<uint8_t*> m_free;
+    size_t m_allocated = 0;      // buffers owned, free or lent
+    std::string m_hash;
+};
@@ -0,0 +1,151 @@
+/**
+ * Chunk Reader Bindings
+ *
+ * openChunkReader(path, { chunkSize, priority, jobId }) -> Promise<{ success, id, size, chunkSize, error? }>
+ * readChunk(id) -> Promise<{ success, data: Buffer | null, offset, done, hash?, error? }>
+ * closeChunkReader(id) -> boolean
+ *
+ * Reads run on the worker pool, one at a time per reader. `data` wraps the
+ * reader's own page-aligned buffer where the runtime allows external
+ * buffers; it goes back to the reader when the Buffer is collected (in
+ * Electron, NewOrCopy copies it once and returns it at once). `hash` is
+ * the SHA-256 of the whole file, on the chunk with `done: true`.
+ */
+
+#include "addon.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "chunk_reader.h"
+#include "thread_pool.h"
+
+struct ReaderEntry {
+    std::shared_ptr<ChunkReader> reader;
+    JobPriority priority = JobPriority::Normal;
+    bool reading = false;
+};
+
+// JS thread only
+static std::unordered_map<uint32_t, ReaderEntry> g_readers;
+static uint32_t g_nextReaderId = 0;
+
+static Napi::Value OpenChunkReader(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::wstring path;
+    if (!ReadArgs(info, "File path expected", &path)) return env.Null();
+    size_t chunkSize = ChunkReader::kDefaultChunkSize;
+    JobOptions job;
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        Napi::Value value = options.Get("chunkSize");
+        if (value.IsNumber()) chunkSize = static_cast<size_t>(value.As<Napi::Number>().Int64Value());
+        if (!ReadJobOptions(env, options, &job)) return env.Null();
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "openChunkReader");
+    Napi::Promise promise = completion->Promise();
+
+    CancelTokenPtr token = CancelToken::Create(job.jobId, path);
+    JobPriority priority = job.priority;
+    ThreadPool::Shared().Submit([path, chunkSize, token, priority, completion]() {
+        std::string error;
+        std::shared_ptr<ChunkReader> reader = token->IsCancelled(path)
+            ? nullptr : ChunkReader::Open(path, chunkSize, token, &error);
+        if (!reader && error.empty()) error = kCancelledError;
+
+        completion->Resolve([reader, error, priority](Napi::Env env) {
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("success", Napi::Boolean::New(env, reader != nullptr));
+            if (!reader) {
+                result.Set("error", Napi::String::New(env, error));
+                return result;
+            }
+            uint32_t id = ++g_nextReaderId;
+            g_readers[id] = { reader, priority, false };
+            result.Set("id", Napi::Number::New(env, id));
+            result.Set("size", Napi::Number::New(env, static_cast<double>(reader->Size())));
+            result.Set("chunkSize", Napi::Number::New(env, static_cast<double>(reader->ChunkSize())));
+            return result;
+        });
+    }, priority);
+
+    return promise;
+}
+
+// Lend the chunk's buffer to JS; the finalizer hands it back to the reader,
+// whose lifetime it extends until then
+static Napi::Value LendChunk(Napi::Env env, const std::shared_ptr<ChunkReader>& reader,
+    const ChunkReader::Chunk& chunk) {
+    if (!chunk.data) return env.Null();
+    auto* owner = new std::shared_ptr<ChunkReader>(reader);
+    return Napi::Buffer<uint8_t>::NewOrCopy(env, chunk.data, chunk.length,
+        [](Napi::Env, uint8_t* data, std::shared_ptr<ChunkReader>* owner) {
+            (*owner)->Return(data);
+            delete owner;
+        }, owner);
+}
+
+static Napi::Value ReadChunk(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Reader ID expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    uint32_t id = info[0].As<Napi::Number>().Uint32Value();
+    auto it = g_readers.find(id);
+    if (it == g_readers.end()) {
+        Napi::Error::New(env, "Chunk reader is closed").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (it->second.reading) {
+        Napi::Error::New(env, "A read is already pending on this reader").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    it->second.reading = true;
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "readChunk");
+    Napi::Promise promise = completion->Promise();
+
+    std::shared_ptr<ChunkReader> reader = it->second.reader;
+    ThreadPool::Shared().Submit([id, reader, completion]() {
+        auto chunk = std::make_shared<ChunkReader::Chunk>();
+        bool ok = reader->Next(chunk.get());
+        std::string hash = chunk->done ? reader->Hash() : std::string();
+
+        completion->Resolve([id, reader, chunk, ok, hash](Napi::Env env) {
+            auto entry = g_readers.find(id);
+            if (entry != g_readers.end()) entry->second.reading = false;
+
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("success", Napi::Boolean::New(env, ok));
+            result.Set("data", ok ? LendChunk(env, reader, *chunk) : env.Null());
+            result.Set("offset", Napi::Number::New(env, static_cast<double>(chunk->offset)));
+            result.Set("done", Napi::Boolean::New(env, chunk->done || !ok));
+            if (!hash.empty()) result.Set("hash", Napi::String::New(env, hash));
+            if (!ok) result.Set("error", Napi::String::New(env, chunk->error));
+            return result;
+        });
+    }, it->second.priority);
+
+    return promise;
+}
+
+static Napi::Value CloseChunkReader(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Reader ID expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    // The reader itself goes once its pending read and lent chunks are done
+    return Napi::Boolean::New(env, g_readers.erase(info[0].As<Napi::Number>().Uint32Value()) > 0);
+}
+
+void InitChunkReaderBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("openChunkReader", Napi::Function::New(env, OpenChunkReader));
+    exports.Set("readChunk", Napi::Function::New(env, ReadChunk));
+    exports.Set("closeChunkReader", Napi::Function::New(env, CloseChunkReader));
+}
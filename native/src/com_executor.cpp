@@ -0,0 +1,129 @@
+/**
+ * COM Executor
+ */
+
+#include "com_executor.h"
+
+#include <algorithm>
+
+// Each apartment holds its own warm controls; past a few the memory cost
+// outweighs the parallelism eDrawings actually gets
+static const size_t kMaxApartments = 4;
+
+ComExecutor::ComExecutor() = default;
+
+ComExecutor& ComExecutor::Shared() {
+    static ComExecutor executor;
+    return executor;
+}
+
+void ComExecutor::Configure(size_t apartmentCount) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_apartments.empty()) return;
+    m_configured = std::clamp<size_t>(apartmentCount, 1, kMaxApartments);
+}
+
+void ComExecutor::SetGrowthLimit(size_t maxApartments) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_growthLimit = std::clamp<size_t>(maxApartments, 1, kMaxApartments);
+}
+
+bool ComExecutor::Start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped) return false;
+    if (!m_apartments.empty()) return true;
+
+    for (size_t i = 0; i < m_configured; i++) {
+        auto apartment = std::make_unique<StaThread>();
+        if (!apartment->Start()) break;
+        m_apartments.push_back(std::move(apartment));
+        m_bound.push_back(0);
+    }
+    return !m_apartments.empty();
+}
+
+void ComExecutor::Stop(const StaThread::Job& teardown) {
+    std::vector<std::unique_ptr<StaThread>> apartments;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped = true;
+        apartments.swap(m_apartments);
+        m_bound.clear();
+    }
+    for (auto& apartment : apartments) {
+        if (teardown) apartment->Invoke(teardown);
+        apartment->Stop();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& apartment : apartments) m_retired.push_back(std::move(apartment));
+}
+
+bool ComExecutor::IsRunning() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_apartments.empty();
+}
+
+size_t ComExecutor::Size() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_apartments.size();
+}
+
+StaThread* ComExecutor::Next() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_apartments.empty()) return nullptr;
+    return m_apartments[m_next++ % m_apartments.size()].get();
+}
+
+StaThread* ComExecutor::At(size_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return index < m_apartments.size() ? m_apartments[index].get() : nullptr;
+}
+
+StaThread* ComExecutor::Bind(bool* started) {
+    *started = false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped || m_apartments.empty()) return nullptr;
+
+    size_t best = 0;
+    for (size_t i = 1; i < m_bound.size(); i++) {
+        if (m_bound[i] < m_bound[best]) best = i;
+    }
+    size_t growthLimit = m_growthLimit ? m_growthLimit : m_configured;
+    if (m_bound[best] > 0 && m_apartments.size() < growthLimit) {
+        // Every apartment is busy with a preview: give this one its own
+        auto apartment = std::make_unique<StaThread>();
+        if (apartment->Start()) {
+            m_apartments.push_back(std::move(apartment));
+            m_bound.push_back(0);
+            best = m_apartments.size() - 1;
+            *started = true;
+        }
+    }
+    m_bound[best]++;
+    return m_apartments[best].get();
+}
+
+void ComExecutor::Unbind(StaThread* apartment) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped) return;
+    for (size_t i = 0; i < m_apartments.size(); i++) {
+        if (m_apartments[i].get() == apartment) {
+            if (m_bound[i] > 0) m_bound[i]--;
+            return;
+        }
+    }
+}
+
+int ComExecutor::IndexOf(StaThread* apartment) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_apartments.size(); i++) {
+        if (m_apartments[i].get() == apartment) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+std::vector<size_t> ComExecutor::Bindings() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bound;
+}
@@ -0,0 +1,77 @@
+/**
+ * COM Executor
+ *
+ * Owns every apartment the addon does COM work on: one or more StaThreads,
+ * each with its own GetMessage loop, job queue and control pool (see
+ * ControlPool::Current). Node's main thread never initializes COM; every
+ * method posts to an apartment instead.
+ *
+ * Each preview is bound to the apartment hosting the fewest live previews.
+ * When every apartment already hosts one and a growth limit above the
+ * configured count was set, another is started, so previews shown side by
+ * side load in parallel instead of queueing behind each other's OpenDoc.
+ * Headless work (renderToBuffer) goes round-robin.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sta_thread.h"
+
+class ComExecutor {
+public:
+    static ComExecutor& Shared();
+
+    // Number of apartments created by Start (1-4, default 1). Ignored once
+    // started.
+    void Configure(size_t apartmentCount);
+
+    // Most apartments Bind may grow to (1-4). Until set, the configured
+    // count: a grown apartment starts without warm controls, so growth is
+    // opt-in. Never stops any.
+    void SetGrowthLimit(size_t maxApartments);
+
+    // Start every apartment; safe to call repeatedly. False if none could be
+    // initialized, or once stopped.
+    bool Start();
+
+    // Run teardown on each apartment (while it can still pump), then stop
+    // and join them all. The StaThreads are kept, not freed: previews
+    // finalized after this still hold them, and their Post/Invoke now fail.
+    void Stop(const StaThread::Job& teardown);
+
+    bool IsRunning();
+    size_t Size();
+
+    // Apartment for the next piece of work
+    StaThread* Next();
+    StaThread* At(size_t index);
+
+    // Apartment for a new preview; pair with Unbind. *started is set when
+    // it was started for this call (its pool is empty, with default limits).
+    // Null once stopped; Unbind of an apartment from before Stop does nothing.
+    StaThread* Bind(bool* started);
+    void Unbind(StaThread* apartment);
+
+    // Position of apartment, or -1 once stopped
+    int IndexOf(StaThread* apartment);
+
+    // Live previews bound to each apartment
+    std::vector<size_t> Bindings();
+
+private:
+    ComExecutor();
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<StaThread>> m_apartments;
+    std::vector<size_t> m_bound;  // parallel to m_apartments
+    std::vector<std::unique_ptr<StaThread>> m_retired;  // stopped; never freed
+    bool m_stopped = false;  // Stop ran: no apartment is started again
+    size_t m_configured = 1;
+    size_t m_growthLimit = 0;  // 0: m_configured
+    std::atomic<size_t> m_next{0};
+};
@@ -0,0 +1,305 @@
+/**
+ * Compound File Reader
+ */
+
+#include "compound_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const uint8_t kSignature[8] = { 0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1 };
+
+static const uint32_t kMaxRegularSector = 0xFFFFFFFA;
+static const uint32_t kEndOfChain = 0xFFFFFFFE;
+static const uint32_t kNoStream = 0xFFFFFFFF;
+
+static const size_t kHeaderSize = 512;
+static const size_t kHeaderDifatCount = 109;
+static const size_t kEntrySize = 128;
+
+static uint16_t LoadU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t LoadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static char16_t FoldCase(char16_t c) {
+    return (c >= u'a' && c <= u'z') ? static_cast<char16_t>(c - (u'a' - u'A')) : c;
+}
+
+static bool NamesEqual(const std::u16string& a, const std::u16string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (FoldCase(a[i]) != FoldCase(b[i])) return false;
+    }
+    return true;
+}
+
+bool MemoryByteSource::Read(uint64_t offset, void* dst, size_t length) const {
+    if (offset > m_size || length > m_size - offset) return false;
+    memcpy(dst, m_data + offset, length);
+    return true;
+}
+
+bool CompoundFile::Open(const ByteSource* source, std::string* error) {
+    m_source = source;
+
+    uint8_t header[kHeaderSize];
+    if (!source || !source->Read(0, header, sizeof(header))) {
+        *error = "File too small to be a compound file";
+        return false;
+    }
+    if (memcmp(header, kSignature, sizeof(kSignature)) != 0) {
+        *error = "Not a compound file";
+        return false;
+    }
+
+    uint16_t majorVersion = LoadU16(header + 0x1A);
+    m_sectorShift = LoadU16(header + 0x1E);
+    m_miniSectorShift = LoadU16(header + 0x20);
+    if (!((majorVersion == 3 && m_sectorShift == 9) || (majorVersion == 4 && m_sectorShift == 12)) ||
+        m_miniSectorShift != 6) {
+        *error = "Unsupported compound file version";
+        return false;
+    }
+
+    // A truncated final sector still counts; Read() bounds the actual bytes
+    uint64_t sectorSize = 1ull << m_sectorShift;
+    uint64_t sectors = (source->Size() + sectorSize - 1) >> m_sectorShift;
+    m_sectorCount = static_cast<uint32_t>(sectors > 0 ? std::min<uint64_t>(sectors - 1, kMaxRegularSector) : 0);
+
+    uint32_t fatSectorCount = LoadU32(header + 0x2C);
+    uint32_t firstDirectorySector = LoadU32(header + 0x30);
+    m_miniStreamCutoff = LoadU32(header + 0x38);
+    uint32_t firstMiniFatSector = LoadU32(header + 0x3C);
+    uint32_t firstDifatSector = LoadU32(header + 0x44);
+
+    if (fatSectorCount > m_sectorCount) {
+        *error = "Corrupt sector allocation table";
+        return false;
+    }
+
+    // The header holds the first 109 FAT sector locations; larger files
+    // chain further DIFAT sectors, each ending in a link to the next
+    m_fatSectors.clear();
+    m_fatSectors.reserve(fatSectorCount);
+    for (size_t i = 0; i < kHeaderDifatCount && m_fatSectors.size() < fatSectorCount; i++) {
+        m_fatSectors.push_back(LoadU32(header + 0x4C + i * 4));
+    }
+
+    uint32_t entriesPerSector = (1u << m_sectorShift) / 4;
+    uint32_t difatSector = firstDifatSector;
+    uint32_t difatVisited = 0;
+    while (m_fatSectors.size() < fatSectorCount) {
+        if (difatSector >= m_sectorCount || ++difatVisited > m_sectorCount) {
+            *error = "Corrupt DIFAT chain";
+            return false;
+        }
+        uint64_t base = SectorOffset(difatSector);
+        for (uint32_t i = 0; i + 1 < entriesPerSector && m_fatSectors.size() < fatSectorCount; i++) {
+            uint32_t fatSector = 0;
+            if (!ReadU32(base + i * 4, &fatSector)) {
+                *error = "Truncated DIFAT sector";
+                return false;
+            }
+            m_fatSectors.push_back(fatSector);
+        }
+        if (!ReadU32(base + (entriesPerSector - 1) * 4, &difatSector)) {
+            *error = "Truncated DIFAT sector";
+            return false;
+        }
+    }
+
+    if (!CollectChain(firstDirectorySector, &m_directorySectors) || m_directorySectors.empty()) {
+        *error = "Corrupt directory chain";
+        return false;
+    }
+
+    m_miniFatSectors.clear();
+    if (firstMiniFatSector != kEndOfChain && !CollectChain(firstMiniFatSector, &m_miniFatSectors)) {
+        *error = "Corrupt mini FAT chain";
+        return false;
+    }
+
+    m_miniStreamLoaded = false;
+    m_miniStreamSectors.clear();
+
+    CompoundEntry root;
+    if (!ReadEntry(0, &root) || root.type != CompoundEntry::Root) {
+        *error = "Missing root directory entry";
+        return false;
+    }
+    return true;
+}
+
+bool CompoundFile::ReadU32(uint64_t offset, uint32_t* value) const {
+    uint8_t bytes[4];
+    if (!m_source->Read(offset, bytes, sizeof(bytes))) return false;
+    *value = LoadU32(bytes);
+    return true;
+}
+
+bool CompoundFile::NextSector(uint32_t sector, uint32_t* next) const {
+    uint32_t perSector = (1u << m_sectorShift) / 4;
+    uint32_t fatIndex = sector / perSector;
+    if (fatIndex >= m_fatSectors.size() || m_fatSectors[fatIndex] >= m_sectorCount) return false;
+    return ReadU32(SectorOffset(m_fatSectors[fatIndex]) + (sector % perSector) * 4, next);
+}
+
+bool CompoundFile::NextMiniSector(uint32_t sector, uint32_t* next) const {
+    uint32_t perSector = (1u << m_sectorShift) / 4;
+    uint32_t fatIndex = sector / perSector;
+    if (fatIndex >= m_miniFatSectors.size()) return false;
+    return ReadU32(SectorOffset(m_miniFatSectors[fatIndex]) + (sector % perSector) * 4, next);
+}
+
+bool CompoundFile::CollectChain(uint32_t start, std::vector<uint32_t>* chain) const {
+    chain->clear();
+    uint32_t sector = start;
+    while (sector != kEndOfChain) {
+        // A chain can't be longer than the file; anything else is a loop
+        if (sector >= m_sectorCount || chain->size() >= m_sectorCount) return false;
+        chain->push_back(sector);
+        if (!NextSector(sector, &sector)) return false;
+    }
+    return true;
+}
+
+bool CompoundFile::ReadEntry(uint32_t id, CompoundEntry* entry) const {
+    uint32_t perSector = (1u << m_sectorShift) / kEntrySize;
+    uint32_t index = id / perSector;
+    if (index >= m_directorySectors.size()) return false;
+
+    uint8_t raw[kEntrySize];
+    uint64_t offset = SectorOffset(m_directorySectors[index]) + (id % perSector) * kEntrySize;
+    if (!m_source->Read(offset, raw, sizeof(raw))) return false;
+
+    // Name length is in bytes and includes the terminator
+    uint16_t nameBytes = LoadU16(raw + 64);
+    size_t nameChars = (nameBytes >= 2 && nameBytes <= 64) ? nameBytes / 2 - 1 : 0;
+
+    entry->id = id;
+    entry->type = static_cast<CompoundEntry::Type>(raw[66]);
+    entry->name.resize(nameChars);
+    for (size_t i = 0; i < nameChars; i++) {
+        entry->name[i] = static_cast<char16_t>(LoadU16(raw + i * 2));
+    }
+    entry->left = LoadU32(raw + 68);
+    entry->right = LoadU32(raw + 72);
+    entry->child = LoadU32(raw + 76);
+    entry->startSector = LoadU32(raw + 116);
+    entry->size = LoadU32(raw + 120);
+    // Version 3 files may leave garbage in the high half of the size
+    if (m_sectorShift == 12) entry->size |= static_cast<uint64_t>(LoadU32(raw + 124)) << 32;
+    return true;
+}
+
+bool CompoundFile::ListChildren(uint32_t storageId, std::vector<CompoundEntry>* children) const {
+    children->clear();
+
+    CompoundEntry storage;
+    if (!ReadEntry(storageId, &storage)) return false;
+    if (storage.type != CompoundEntry::Storage && storage.type != CompoundEntry::Root) return false;
+
+    // Siblings form a binary tree; walk it iteratively with a bound so a
+    // corrupt (cyclic) tree can't spin forever
+    size_t maxEntries = m_directorySectors.size() * ((1u << m_sectorShift) / kEntrySize);
+    std::vector<uint32_t> pending;
+    if (storage.child != kNoStream) pending.push_back(storage.child);
+    size_t visited = 0;
+    while (!pending.empty()) {
+        uint32_t id = pending.back();
+        pending.pop_back();
+        if (++visited > maxEntries) return false;
+
+        CompoundEntry entry;
+        if (!ReadEntry(id, &entry)) return false;
+        if (entry.type != CompoundEntry::Empty) children->push_back(entry);
+        if (entry.right != kNoStream) pending.push_back(entry.right);
+        if (entry.left != kNoStream) pending.push_back(entry.left);
+    }
+    return true;
+}
+
+bool CompoundFile::FindChild(uint32_t storageId, const std::u16string& name, CompoundEntry* entry) const {
+    std::vector<CompoundEntry> children;
+    if (!ListChildren(storageId, &children)) return false;
+    for (const auto& child : children) {
+        if (NamesEqual(child.name, name)) {
+            *entry = child;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CompoundFile::Find(const std::u16string& path, CompoundEntry* entry) const {
+    if (!m_source) return false;
+
+    uint32_t current = 0;
+    size_t start = 0;
+    for (;;) {
+        size_t slash = path.find(u'/', start);
+        std::u16string component = path.substr(start, slash == std::u16string::npos ? std::u16string::npos : slash - start);
+        if (!component.empty()) {
+            if (!FindChild(current, component, entry)) return false;
+            current = entry->id;
+        }
+        if (slash == std::u16string::npos) break;
+        start = slash + 1;
+    }
+    return current != 0 || ReadEntry(0, entry);
+}
+
+bool CompoundFile::EnsureMiniStream() const {
+    if (m_miniStreamLoaded) return true;
+    CompoundEntry root;
+    if (!ReadEntry(0, &root)) return false;
+    if (root.startSector != kEndOfChain && !CollectChain(root.startSector, &m_miniStreamSectors)) {
+        m_miniStreamSectors.clear();
+        return false;
+    }
+    m_miniStreamLoaded = true;
+    return true;
+}
+
+bool CompoundFile::ReadStream(const CompoundEntry& entry, std::vector<uint8_t>* bytes, uint64_t maxBytes) const {
+    if (!m_source || entry.type != CompoundEntry::Stream) return false;
+    if (entry.size > maxBytes || entry.size > m_source->Size()) return false;
+
+    bytes->resize(static_cast<size_t>(entry.size));
+    if (entry.size == 0) return true;
+
+    size_t copied = 0;
+    uint32_t sector = entry.startSector;
+
+    if (entry.size < m_miniStreamCutoff) {
+        if (!EnsureMiniStream()) return false;
+        uint32_t miniSize = 1u << m_miniSectorShift;
+        uint32_t miniPerSector = 1u << (m_sectorShift - m_miniSectorShift);
+        uint64_t limit = static_cast<uint64_t>(m_miniStreamSectors.size()) * miniPerSector;
+        for (uint64_t steps = 0; copied < bytes->size(); steps++) {
+            if (sector >= limit || steps >= limit) return false;
+            uint32_t hostSector = m_miniStreamSectors[sector / miniPerSector];
+            uint64_t offset = SectorOffset(hostSector) + static_cast<uint64_t>(sector % miniPerSector) * miniSize;
+            size_t chunk = std::min<size_t>(miniSize, bytes->size() - copied);
+            if (!m_source->Read(offset, bytes->data() + copied, chunk)) return false;
+            copied += chunk;
+            if (copied < bytes->size() && !NextMiniSector(sector, &sector)) return false;
+        }
+        return true;
+    }
+
+    size_t sectorSize = static_cast<size_t>(1) << m_sectorShift;
+    for (uint64_t steps = 0; copied < bytes->size(); steps++) {
+        if (sector >= m_sectorCount || steps >= m_sectorCount) return false;
+        size_t chunk = std::min(sectorSize, bytes->size() - copied);
+        if (!m_source->Read(SectorOffset(sector), bytes->data() + copied, chunk)) return false;
+        copied += chunk;
+        if (copied < bytes->size() && !NextSector(sector, &sector)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+/**
+ * Compound File Reader
+ *
+ * Read-only parser for OLE compound files (MS-CFB), the container used by
+ * pre-2015 SolidWorks documents. Everything goes through a ByteSource, so
+ * opening a file reads only the header; finding a stream reads only the
+ * directory sectors on the path to it, and reading a stream follows its
+ * sector chain one table entry at a time. Nothing is buffered beyond the
+ * few sector indexes needed to walk the file.
+ *
+ * Platform-neutral: no Win32, COM or N-API here.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Random-access bytes behind a parsed file (a mapped view, a buffer, ...)
+class ByteSource {
+public:
+    virtual ~ByteSource() = default;
+    virtual uint64_t Size() const = 0;
+    // Copy length bytes at offset into dst; false if out of range or unreadable
+    virtual bool Read(uint64_t offset, void* dst, size_t length) const = 0;
+};
+
+class MemoryByteSource : public ByteSource {
+public:
+    MemoryByteSource(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+    uint64_t Size() const override { return m_size; }
+    bool Read(uint64_t offset, void* dst, size_t length) const override;
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+};
+
+struct CompoundEntry {
+    enum Type : uint8_t { Empty = 0, Storage = 1, Stream = 2, Root = 5 };
+
+    uint32_t id = 0;
+    Type type = Empty;
+    std::u16string name;
+    uint32_t left = 0;
+    uint32_t right = 0;
+    uint32_t child = 0;
+    uint32_t startSector = 0;
+    uint64_t size = 0;
+};
+
+class CompoundFile {
+public:
+    // Validates the header and indexes the FAT and directory sector chains.
+    // The source must outlive this object.
+    bool Open(const ByteSource* source, std::string* error);
+
+    // Look up a stream or storage by '/'-separated path, matching names the
+    // way the format does (ASCII case-insensitive)
+    bool Find(const std::u16string& path, CompoundEntry* entry) const;
+
+    // Direct children of a storage (0 is the root), in directory order
+    bool ListChildren(uint32_t storageId, std::vector<CompoundEntry>* children) const;
+
+    // Copy a stream's contents; fails without reading if it exceeds maxBytes
+    bool ReadStream(const CompoundEntry& entry, std::vector<uint8_t>* bytes,
+        uint64_t maxBytes = UINT64_MAX) const;
+
+private:
+    bool ReadU32(uint64_t offset, uint32_t* value) const;
+    bool ReadEntry(uint32_t id, CompoundEntry* entry) const;
+    bool NextSector(uint32_t sector, uint32_t* next) const;
+    bool NextMiniSector(uint32_t sector, uint32_t* next) const;
+    bool CollectChain(uint32_t start, std::vector<uint32_t>* chain) const;
+    bool FindChild(uint32_t storageId, const std::u16string& name, CompoundEntry* entry) const;
+    bool EnsureMiniStream() const;
+
+    uint64_t SectorOffset(uint32_t sector) const {
+        return (static_cast<uint64_t>(sector) + 1) << m_sectorShift;
+    }
+
+    const ByteSource* m_source = nullptr;
+    uint32_t m_sectorShift = 9;
+    uint32_t m_miniSectorShift = 6;
+    uint32_t m_miniStreamCutoff = 4096;
+    uint32_t m_sectorCount = 0;               // sectors the file can actually hold
+    std::vector<uint32_t> m_fatSectors;       // where each FAT sector lives
+    std::vector<uint32_t> m_directorySectors;
+    std::vector<uint32_t> m_miniFatSectors;
+
+    // Sector chain of the root entry's mini stream, built on first use
+    mutable bool m_miniStreamLoaded = false;
+    mutable std::vector<uint32_t> m_miniStreamSectors;
+};
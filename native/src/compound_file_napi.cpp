@@ -0,0 +1,211 @@
+/**
+ * Compound File Bindings
+ *
+ * readPreviewStream(path, streamNames[]) -> Promise<PreviewStreamResult>
+ * readProperties(paths[], { priority, jobId }) -> Promise<PropertiesResult[]>
+ *
+ * Runs on the shared worker pool. The file is memory-mapped, so only the
+ * directory and the one stream that is returned are read - peak memory is
+ * the stream size, not the file size, which also keeps previews cheap over
+ * SMB-mounted vaults.
+ *
+ * readProperties parses each file's property set streams (see
+ * document_properties.h), one pool task per file, and resolves once with
+ * results in input order. A file it cannot read fails with `compound`
+ * telling whether it was a compound file at all; index.js sends those to
+ * the SOLIDWORKS service. Cancelled files fail with error "Cancelled".
+ */
+
+#include "addon.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "document_properties.h"
+#include "native_stats.h"
+#include "thread_pool.h"
+#include "thumbnail_extractor.h"
+
+static int HexDigit(wchar_t c) {
+    if (c >= L'0' && c <= L'9') return c - L'0';
+    if (c >= L'a' && c <= L'f') return c - L'a' + 10;
+    if (c >= L'A' && c <= L'F') return c - L'A' + 10;
+    return -1;
+}
+
+// Stream names copied from JS string literals sometimes arrive escaped
+// ("\\x05PreviewMetaFile"); decode \xNN so they match the real name
+static std::u16string StreamNameFromJs(const Napi::Value& value) {
+    std::wstring_view wide = WideScratch(value);
+    std::u16string name;
+    name.reserve(wide.size());
+    for (size_t i = 0; i < wide.size(); i++) {
+        if (wide[i] == L'\\' && i + 3 < wide.size() && wide[i + 1] == L'x' &&
+            HexDigit(wide[i + 2]) >= 0 && HexDigit(wide[i + 3]) >= 0) {
+            name.push_back(static_cast<char16_t>(HexDigit(wide[i + 2]) * 16 + HexDigit(wide[i + 3])));
+            i += 3;
+        } else {
+            name.push_back(static_cast<char16_t>(wide[i]));
+        }
+    }
+    return name;
+}
+
+
+struct PreviewStreamRequest {
+    std::wstring path;
+    std::vector<std::u16string> names;
+    PreviewStream result;
+};
+
+// readPreviewStream(path: string, streamNames: string[])
+static Napi::Value ReadPreviewStreamJs(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "File path and array of stream names expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto request = std::make_shared<PreviewStreamRequest>();
+    request->path = JsToWide(info[0]);
+
+    Napi::Array names = info[1].As<Napi::Array>();
+    for (uint32_t i = 0; i < names.Length(); i++) {
+        Napi::Value value = names.Get(i);
+        if (!value.IsString()) {
+            Napi::TypeError::New(env, "Stream names must be strings").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        request->names.push_back(StreamNameFromJs(value));
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "readPreviewStream");
+    Napi::Promise promise = completion->Promise();
+
+    ThreadPool::Shared().Submit([request, completion]() {
+        int64_t started = NativeStats::Now();
+        request->result = ReadPreviewStream(request->path, request->names);
+        NativeStats::Record(NativeOp::ReadPreviewStream, started);
+        completion->Resolve([request](Napi::Env env) -> Napi::Value {
+            PreviewStream& stream = request->result;
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("success", Napi::Boolean::New(env, stream.success));
+            if (stream.success) {
+                result.Set("name", Napi::String::New(env, stream.name));
+                result.Set("data", TakeBuffer(env, std::move(stream.data)));
+            } else {
+                result.Set("error", Napi::String::New(env, stream.error));
+            }
+            return result;
+        });
+    });
+
+    return promise;
+}
+
+struct PropertiesBatch {
+    std::vector<std::wstring> paths;
+    std::vector<DocumentProperties> results;
+    JobOptions job;
+    CancelTokenPtr token;
+    std::atomic<size_t> remaining{0};
+    AsyncCompletion* completion = nullptr;
+};
+
+static void SetIfPresent(Napi::Env env, Napi::Object object, const char* key, const std::wstring& value) {
+    if (!value.empty()) object.Set(key, WideToJs(env, value));
+}
+
+static void SetTimeIfPresent(Napi::Env env, Napi::Object object, const char* key, uint64_t filetime) {
+    if (filetime != 0 && filetime <= static_cast<uint64_t>(INT64_MAX)) {
+        object.Set(key, Napi::Number::New(env, FiletimeToEpochMs(static_cast<int64_t>(filetime))));
+    }
+}
+
+static Napi::Value BuildPropertiesResults(Napi::Env env, PropertiesBatch* batch) {
+    Napi::Array results = Napi::Array::New(env, batch->results.size());
+    for (size_t i = 0; i < batch->results.size(); i++) {
+        const DocumentProperties& properties = batch->results[i];
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("path", WideToJs(env, batch->paths[i]));
+        entry.Set("success", Napi::Boolean::New(env, properties.success));
+        if (properties.success) {
+            const DocumentSummary& summary = properties.summary;
+            Napi::Object info = Napi::Object::New(env);
+            SetIfPresent(env, info, "title", summary.title);
+            SetIfPresent(env, info, "subject", summary.subject);
+            SetIfPresent(env, info, "author", summary.author);
+            SetIfPresent(env, info, "keywords", summary.keywords);
+            SetIfPresent(env, info, "comments", summary.comments);
+            SetIfPresent(env, info, "lastSavedBy", summary.lastSavedBy);
+            SetIfPresent(env, info, "revision", summary.revision);
+            SetIfPresent(env, info, "application", summary.application);
+            SetIfPresent(env, info, "category", summary.category);
+            SetIfPresent(env, info, "manager", summary.manager);
+            SetIfPresent(env, info, "company", summary.company);
+            SetTimeIfPresent(env, info, "created", summary.created);
+            SetTimeIfPresent(env, info, "modified", summary.modified);
+
+            Napi::Object custom = Napi::Object::New(env);
+            for (const auto& property : properties.custom) {
+                custom.Set(WideToJs(env, property.name), WideToJs(env, property.value));
+            }
+            entry.Set("source", Napi::String::New(env, "native"));
+            entry.Set("summary", info);
+            entry.Set("fileProperties", custom);
+        } else {
+            entry.Set("compound", Napi::Boolean::New(env, properties.compound));
+            entry.Set("error", Napi::String::New(env, properties.error));
+        }
+        results.Set(static_cast<uint32_t>(i), entry);
+    }
+    return results;
+}
+
+// readProperties(paths: string[] | path table, options?: { priority?: 'visible' | 'normal' | 'prefetch',
+//                jobId?: number })
+static Napi::Value ReadPropertiesJs(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto batch = std::make_shared<PropertiesBatch>();
+    if (!ReadPathTable(info[0], &batch->paths)) return env.Null();
+    if (info.Length() >= 2 && !ReadJobOptions(env, info[1], &batch->job)) return env.Null();
+
+    batch->results.resize(batch->paths.size());
+    batch->remaining = batch->paths.size();
+    batch->completion = AsyncCompletion::Create(env, "readProperties");
+    Napi::Promise promise = batch->completion->Promise();
+
+    if (batch->paths.empty()) {
+        batch->completion->Resolve([](Napi::Env env) { return Napi::Array::New(env); });
+        return promise;
+    }
+
+    batch->token = CancelToken::Create(batch->job.jobId, batch->paths);
+    for (size_t i = 0; i < batch->paths.size(); i++) {
+        ThreadPool::Shared().Submit([batch, i]() {
+            if (batch->token->IsCancelled(batch->paths[i])) {
+                batch->results[i].error = kCancelledError;
+            } else {
+                ScopedNativeTimer timer(NativeOp::ReadProperties);
+                batch->results[i] = ReadDocumentProperties(batch->paths[i]);
+            }
+            if (--batch->remaining == 0) {
+                batch->token.reset();  // finished: no longer cancellable
+                batch->completion->Resolve([batch](Napi::Env env) {
+                    return BuildPropertiesResults(env, batch.get());
+                });
+            }
+        }, batch->job.priority);
+    }
+
+    return promise;
+}
+
+void InitCompoundFileBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("readPreviewStream", Napi::Function::New(env, ReadPreviewStreamJs));
+    exports.Set("readProperties", Napi::Function::New(env, ReadPropertiesJs));
+}
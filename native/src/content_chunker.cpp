@@ -0,0 +1,149 @@
+/**
+ * Content-Defined Chunking
+ */
+
+#include "content_chunker.h"
+
+#include <algorithm>
+
+#include "chunk_reader.h"
+
+static const size_t kMinimumSize = 64;
+static const size_t kMaximumSize = 64 * 1024 * 1024;
+
+// Reads per ChunkFile: the file streams through one reader buffer at a time
+static const size_t kReadSize = 4 * 1024 * 1024;
+
+// Normalization level 1: one mask bit more before the average, one fewer after
+static const int kNormalization = 1;
+
+struct GearTable {
+    uint64_t values[256];
+
+    GearTable() {
+        // splitmix64 from a fixed seed: the same table on every machine and build
+        uint64_t state = 0x6564726177696e67ull;
+        for (uint64_t& value : values) {
+            state += 0x9E3779B97F4A7C15ull;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            value = z ^ (z >> 31);
+        }
+    }
+};
+
+static const GearTable kGear;
+
+// The top bits: under `hash << 1` they depend on the last 64 bytes, where
+// the low bits would see only the last few
+static uint64_t TopBitsMask(int bits) {
+    bits = std::clamp(bits, 1, 63);
+    return ~0ull << (64 - bits);
+}
+
+static int Log2(size_t value) {
+    int bits = 0;
+    while (value > 1) {
+        value >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+ContentChunker::ContentChunker(const ChunkerParams& params) : m_params(params) {
+    m_params.avgSize = std::clamp(m_params.avgSize, kMinimumSize, kMaximumSize);
+    int bits = Log2(m_params.avgSize);
+    m_params.avgSize = static_cast<size_t>(1) << bits;
+    m_params.minSize = std::clamp(m_params.minSize, kMinimumSize, m_params.avgSize);
+    m_params.maxSize = std::clamp(m_params.maxSize, m_params.avgSize, kMaximumSize);
+
+    m_maskSmall = TopBitsMask(bits + kNormalization);
+    m_maskLarge = TopBitsMask(bits - kNormalization);
+}
+
+void ContentChunker::Update(const uint8_t* data, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        size_t spanStart = i;
+
+        // Below the minimum no boundary is possible: don't even hash
+        if (m_length < m_params.minSize) {
+            size_t skip = std::min(m_params.minSize - m_length, length - i);
+            i += skip;
+            m_length += skip;
+        }
+
+        bool cut = false;
+        if (m_length >= m_params.minSize) {
+            uint64_t hash = m_hash;
+            size_t chunkLength = m_length;
+            while (i < length) {
+                if (chunkLength >= m_params.maxSize) {
+                    cut = true;
+                    break;
+                }
+                hash = (hash << 1) + kGear.values[data[i]];
+                i++;
+                chunkLength++;
+                uint64_t mask = chunkLength <= m_params.avgSize ? m_maskSmall : m_maskLarge;
+                if ((hash & mask) == 0) {
+                    cut = true;
+                    break;
+                }
+            }
+            m_hash = hash;
+            m_length = chunkLength;
+        }
+
+        m_sha.Update(data + spanStart, i - spanStart);
+        if (cut) Cut();
+    }
+}
+
+void ContentChunker::Cut() {
+    if (m_length == 0) return;
+    ContentChunk chunk;
+    chunk.offset = m_chunkStart;
+    chunk.length = static_cast<uint32_t>(m_length);
+    m_sha.Final(chunk.hash);
+    m_chunks.push_back(chunk);
+
+    m_chunkStart += m_length;
+    m_length = 0;
+    m_hash = 0;
+    m_sha.Reset();
+}
+
+void ContentChunker::Final() {
+    Cut();
+}
+
+ChunkedFile ChunkFile(const std::wstring& path, const ChunkerParams& params, CancelTokenPtr token) {
+    ChunkedFile result;
+    ContentChunker chunker(params);
+    result.params = chunker.Params();
+
+    std::shared_ptr<ChunkReader> reader = ChunkReader::Open(path, kReadSize, token, &result.error);
+    if (!reader) return result;
+
+    for (;;) {
+        ChunkReader::Chunk chunk;
+        if (!reader->Next(&chunk)) {
+            result.error = chunk.error;
+            return result;
+        }
+        if (chunk.data) {
+            chunker.Update(chunk.data, chunk.length);
+            reader->Return(chunk.data);
+            result.size += chunk.length;
+        }
+        if (chunk.done) break;
+    }
+    chunker.Final();
+
+    result.success = true;
+    result.hash = reader->Hash();
+    result.chunks = std::move(chunker.Chunks());
+    return result;
+}
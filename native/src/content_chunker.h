@@ -0,0 +1,83 @@
+/**
+ * Content-Defined Chunking
+ *
+ * FastCDC: a Gear rolling hash picks chunk boundaries from the bytes
+ * themselves, so an edit moves only the boundaries next to it and the
+ * chunks of two revisions of the same file line up everywhere else. A
+ * storage layer keyed by chunk hash then only needs the chunks it has not
+ * seen. Normalized chunking (a stricter mask before the average size, a
+ * looser one after it) keeps chunk sizes close to the average, and the
+ * bytes before the minimum size are never hashed.
+ *
+ * Every chunk also gets a SHA-256 (SHA extensions when present) in the
+ * same pass. The Gear table is generated from a fixed seed: changing it,
+ * or the mask layout, changes every boundary and so every stored chunk.
+ *
+ * Platform-neutral apart from ChunkFile, which streams the file through
+ * a ChunkReader.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "job_registry.h"
+#include "sha256.h"
+
+struct ChunkerParams {
+    size_t minSize = 16 * 1024;
+    size_t avgSize = 64 * 1024;   // rounded down to a power of two
+    size_t maxSize = 256 * 1024;
+};
+
+struct ContentChunk {
+    uint64_t offset = 0;
+    uint32_t length = 0;
+    uint8_t hash[Sha256::kDigestSize];
+};
+
+class ContentChunker {
+public:
+    // Sizes are clamped to 64 B-64 MB, with min <= avg <= max
+    explicit ContentChunker(const ChunkerParams& params);
+
+    // Feed the next bytes of the stream, in order, in pieces of any size
+    void Update(const uint8_t* data, size_t length);
+
+    // Close the last (short) chunk; no Update after this
+    void Final();
+
+    const std::vector<ContentChunk>& Chunks() const { return m_chunks; }
+    std::vector<ContentChunk>& Chunks() { return m_chunks; }
+
+    const ChunkerParams& Params() const { return m_params; }
+
+private:
+    void Cut();
+
+    ChunkerParams m_params;
+    uint64_t m_maskSmall = 0;  // before avgSize: harder to match
+    uint64_t m_maskLarge = 0;  // after it: easier
+
+    uint64_t m_hash = 0;
+    uint64_t m_chunkStart = 0;
+    size_t m_length = 0;  // bytes in the current chunk so far
+    Sha256 m_sha;
+    std::vector<ContentChunk> m_chunks;
+};
+
+struct ChunkedFile {
+    bool success = false;
+    std::string error;
+    uint64_t size = 0;
+    std::string hash;  // SHA-256 of the whole file, lowercase hex
+    std::vector<ContentChunk> chunks;
+    ChunkerParams params;  // as clamped
+};
+
+// Chunk a whole file in one sequential unbuffered read. Stops with
+// "Cancelled" once the token cancels the path.
+ChunkedFile ChunkFile(const std::wstring& path, const ChunkerParams& params, CancelTokenPtr token);
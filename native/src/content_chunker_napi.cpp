@@ -0,0 +1,120 @@
+/**
+ * Content-Defined Chunking Bindings
+ *
+ * chunkFile(path, { minSize, avgSize, maxSize, priority, jobId })
+ *   -> Promise<{ success, size, hash, count, minSize, avgSize, maxSize,
+ *                offsets, lengths, hashes, buffer, error? }>
+ *
+ * Chunk columns share one ArrayBuffer (`buffer`):
+ *
+ *   offsets  Float64Array  byte offset of each chunk in the file
+ *   hashes   Uint8Array    32 bytes of SHA-256 per chunk, chunk i at i * 32
+ *   lengths  Uint32Array   chunk length in bytes
+ *
+ * `hash` is the SHA-256 of the whole file, hex. The sizes echo the
+ * parameters as clamped; a store must chunk every revision with the same
+ * ones for chunks to match.
+ */
+
+#include "addon.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "content_chunker.h"
+#include "native_stats.h"
+#include "thread_pool.h"
+
+static bool ReadSizeOption(Napi::Env env, const Napi::Object& options, const char* name, size_t* out) {
+    Napi::Value value = options.Get(name);
+    if (value.IsUndefined()) return true;
+    if (!value.IsNumber() || value.As<Napi::Number>().DoubleValue() <= 0) {
+        Napi::TypeError::New(env, std::string(name) + " must be a positive number").ThrowAsJavaScriptException();
+        return false;
+    }
+    *out = static_cast<size_t>(value.As<Napi::Number>().Int64Value());
+    return true;
+}
+
+static Napi::Value BuildChunkedFile(Napi::Env env, const ChunkedFile& file) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, file.success));
+    if (!file.success) {
+        result.Set("error", Napi::String::New(env, file.error));
+        return result;
+    }
+
+    // Widest element first, so every column lands aligned without padding
+    size_t count = file.chunks.size();
+    size_t hashesAt = count * sizeof(double);
+    size_t lengthsAt = hashesAt + count * Sha256::kDigestSize;
+    std::vector<uint8_t> bytes(lengthsAt + count * sizeof(uint32_t));
+    double* offsets = reinterpret_cast<double*>(bytes.data());
+    uint32_t* lengths = reinterpret_cast<uint32_t*>(bytes.data() + lengthsAt);
+    for (size_t i = 0; i < count; i++) {
+        const ContentChunk& chunk = file.chunks[i];
+        offsets[i] = static_cast<double>(chunk.offset);
+        memcpy(bytes.data() + hashesAt + i * Sha256::kDigestSize, chunk.hash, Sha256::kDigestSize);
+        lengths[i] = chunk.length;
+    }
+
+    Napi::Buffer<uint8_t> packed = TakeBuffer(env, std::move(bytes));
+    Napi::ArrayBuffer buffer = packed.ArrayBuffer();
+    size_t base = packed.ByteOffset();
+
+    result.Set("size", Napi::Number::New(env, static_cast<double>(file.size)));
+    result.Set("hash", Napi::String::New(env, file.hash));
+    result.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+    result.Set("minSize", Napi::Number::New(env, static_cast<double>(file.params.minSize)));
+    result.Set("avgSize", Napi::Number::New(env, static_cast<double>(file.params.avgSize)));
+    result.Set("maxSize", Napi::Number::New(env, static_cast<double>(file.params.maxSize)));
+    result.Set("buffer", buffer);
+    result.Set("offsets", Napi::Float64Array::New(env, count, buffer, base));
+    result.Set("hashes", Napi::Uint8Array::New(env, count * Sha256::kDigestSize, buffer, base + hashesAt));
+    result.Set("lengths", Napi::Uint32Array::New(env, count, buffer, base + lengthsAt));
+    return result;
+}
+
+static Napi::Value ChunkFileAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::wstring path;
+    if (!ReadArgs(info, "File path expected", &path)) return env.Null();
+    ChunkerParams params;
+    JobOptions job;
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (!ReadSizeOption(env, options, "minSize", &params.minSize) ||
+            !ReadSizeOption(env, options, "avgSize", &params.avgSize) ||
+            !ReadSizeOption(env, options, "maxSize", &params.maxSize) ||
+            !ReadJobOptions(env, options, &job)) {
+            return env.Null();
+        }
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "chunkFile");
+    Napi::Promise promise = completion->Promise();
+
+    CancelTokenPtr token = CancelToken::Create(job.jobId, path);
+    ThreadPool::Shared().Submit([path, params, token, completion]() {
+        auto file = std::make_shared<ChunkedFile>();
+        if (token->IsCancelled(path)) {
+            file->error = kCancelledError;
+        } else {
+            int64_t started = NativeStats::Now();
+            *file = ChunkFile(path, params, token);
+            NativeStats::Record(NativeOp::ChunkFile, started);
+        }
+        completion->Resolve([file](Napi::Env env) {
+            return BuildChunkedFile(env, *file);
+        });
+    }, job.priority);
+
+    return promise;
+}
+
+void InitContentChunkerBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("chunkFile", Napi::Function::New(env, ChunkFileAsync));
+}
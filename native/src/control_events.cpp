@@ -0,0 +1,239 @@
+/**
+ * eDrawings Control Events
+ *
+ * The source interface is discovered from the control's coclass type info
+ * (IProvideClassInfo) rather than hard-coding an IID, and event DISPIDs are
+ * resolved to names through that same type info.
+ */
+
+#include "control_events.h"
+
+#include <ocidl.h>
+#include <algorithm>
+#include <cwctype>
+
+// Find the [default, source] dispinterface of the control's coclass
+static bool FindSourceInterface(IUnknown* pControl, IID* pIid, ITypeInfo** ppSourceInfo) {
+    IProvideClassInfo* pProvide = nullptr;
+    if (FAILED(pControl->QueryInterface(IID_IProvideClassInfo, (void**)&pProvide))) {
+        return false;
+    }
+
+    ITypeInfo* pClassInfo = nullptr;
+    HRESULT hr = pProvide->GetClassInfo(&pClassInfo);
+    pProvide->Release();
+    if (FAILED(hr) || !pClassInfo) return false;
+
+    bool found = false;
+    TYPEATTR* pClassAttr = nullptr;
+    if (SUCCEEDED(pClassInfo->GetTypeAttr(&pClassAttr))) {
+        for (UINT i = 0; i < pClassAttr->cImplTypes && !found; i++) {
+            INT flags = 0;
+            if (FAILED(pClassInfo->GetImplTypeFlags(i, &flags))) continue;
+            if (!(flags & IMPLTYPEFLAG_FDEFAULT) || !(flags & IMPLTYPEFLAG_FSOURCE)) continue;
+
+            HREFTYPE hRef = 0;
+            ITypeInfo* pSourceInfo = nullptr;
+            if (FAILED(pClassInfo->GetRefTypeOfImplType(i, &hRef)) ||
+                FAILED(pClassInfo->GetRefTypeInfo(hRef, &pSourceInfo))) {
+                continue;
+            }
+
+            TYPEATTR* pSourceAttr = nullptr;
+            if (SUCCEEDED(pSourceInfo->GetTypeAttr(&pSourceAttr))) {
+                *pIid = pSourceAttr->guid;
+                pSourceInfo->ReleaseTypeAttr(pSourceAttr);
+                *ppSourceInfo = pSourceInfo;
+                found = true;
+            } else {
+                pSourceInfo->Release();
+            }
+        }
+        pClassInfo->ReleaseTypeAttr(pClassAttr);
+    }
+    pClassInfo->Release();
+    return found;
+}
+
+// Event arguments arrive in reverse order: rgvarg[cArgs - 1] is the first
+static VARIANTARG* EventArg(DISPPARAMS* params, UINT index) {
+    if (!params || index >= params->cArgs) return nullptr;
+    return &params->rgvarg[params->cArgs - 1 - index];
+}
+
+// Notifications between OpenDoc and the final event, recognised by name
+// since the source interface is only known at run time
+static bool IsLoadProgressEvent(const wchar_t* name) {
+    std::wstring lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](wchar_t c) { return static_cast<wchar_t>(towlower(c)); });
+    return lower.find(L"loading") != std::wstring::npos || lower.find(L"progress") != std::wstring::npos;
+}
+
+static std::wstring EventArgString(DISPPARAMS* params, UINT index) {
+    VARIANTARG* arg = EventArg(params, index);
+    if (!arg) return std::wstring();
+
+    VARIANT converted;
+    VariantInit(&converted);
+    if (FAILED(VariantChangeType(&converted, arg, 0, VT_BSTR)) || !converted.bstrVal) {
+        VariantClear(&converted);
+        return std::wstring();
+    }
+    std::wstring value(converted.bstrVal, SysStringLen(converted.bstrVal));
+    VariantClear(&converted);
+    return value;
+}
+
+static long EventArgLong(DISPPARAMS* params, UINT index) {
+    VARIANTARG* arg = EventArg(params, index);
+    if (!arg) return 0;
+
+    VARIANT converted;
+    VariantInit(&converted);
+    long value = 0;
+    if (SUCCEEDED(VariantChangeType(&converted, arg, 0, VT_I4))) {
+        value = converted.lVal;
+    }
+    VariantClear(&converted);
+    return value;
+}
+
+ControlEventSink* ControlEventSink::Connect(IUnknown* pControl) {
+    if (!pControl) return nullptr;
+
+    IID sourceIid = IID_NULL;
+    ITypeInfo* pSourceInfo = nullptr;
+    if (!FindSourceInterface(pControl, &sourceIid, &pSourceInfo)) {
+        return nullptr;
+    }
+
+    IConnectionPointContainer* pContainer = nullptr;
+    if (FAILED(pControl->QueryInterface(IID_IConnectionPointContainer, (void**)&pContainer))) {
+        pSourceInfo->Release();
+        return nullptr;
+    }
+
+    IConnectionPoint* pConnectionPoint = nullptr;
+    HRESULT hr = pContainer->FindConnectionPoint(sourceIid, &pConnectionPoint);
+    pContainer->Release();
+    if (FAILED(hr) || !pConnectionPoint) {
+        pSourceInfo->Release();
+        return nullptr;
+    }
+
+    ControlEventSink* sink = new ControlEventSink();
+    sink->m_sourceIid = sourceIid;
+    sink->m_pSourceInfo = pSourceInfo;
+    sink->m_pConnectionPoint = pConnectionPoint;
+
+    if (FAILED(pConnectionPoint->Advise(sink, &sink->m_cookie))) {
+        sink->Release();
+        return nullptr;
+    }
+    return sink;
+}
+
+void ControlEventSink::Disconnect() {
+    m_listener = nullptr;
+    if (m_pConnectionPoint) {
+        if (m_cookie) {
+            m_pConnectionPoint->Unadvise(m_cookie);
+            m_cookie = 0;
+        }
+        m_pConnectionPoint->Release();
+        m_pConnectionPoint = nullptr;
+    }
+    Release();
+}
+
+void ControlEventSink::CancelPending(const std::wstring& reason) {
+    if (!m_listener) return;
+
+    LoadListener listener = std::move(m_listener);
+    m_listener = nullptr;
+
+    LoadEvent event;
+    event.type = LoadEvent::Type::Failed;
+    event.errorMessage = reason;
+    listener(event);
+}
+
+ControlEventSink::~ControlEventSink() {
+    if (m_pSourceInfo) {
+        m_pSourceInfo->Release();
+        m_pSourceInfo = nullptr;
+    }
+}
+
+STDMETHODIMP ControlEventSink::QueryInterface(REFIID riid, void** ppv) {
+    if (!ppv) return E_POINTER;
+    if (riid == IID_IUnknown || riid == IID_IDispatch || riid == m_sourceIid) {
+        *ppv = static_cast<IDispatch*>(this);
+        AddRef();
+        return S_OK;
+    }
+    *ppv = nullptr;
+    return E_NOINTERFACE;
+}
+
+STDMETHODIMP_(ULONG) ControlEventSink::AddRef() {
+    return ++m_refCount;  // apartment-bound: only ever called on the STA
+}
+
+STDMETHODIMP_(ULONG) ControlEventSink::Release() {
+    ULONG count = --m_refCount;
+    if (count == 0) delete this;
+    return count;
+}
+
+STDMETHODIMP ControlEventSink::GetTypeInfoCount(UINT* pctinfo) {
+    if (!pctinfo) return E_POINTER;
+    *pctinfo = 0;
+    return S_OK;
+}
+
+STDMETHODIMP ControlEventSink::GetTypeInfo(UINT, LCID, ITypeInfo**) {
+    return E_NOTIMPL;
+}
+
+STDMETHODIMP ControlEventSink::GetIDsOfNames(REFIID, LPOLESTR*, UINT, LCID, DISPID*) {
+    return E_NOTIMPL;
+}
+
+STDMETHODIMP ControlEventSink::Invoke(DISPID dispIdMember, REFIID, LCID, WORD,
+    DISPPARAMS* pDispParams, VARIANT*, EXCEPINFO*, UINT*) {
+
+    if (!m_listener || !m_pSourceInfo) return S_OK;
+
+    BSTR name = nullptr;
+    UINT nameCount = 0;
+    if (FAILED(m_pSourceInfo->GetNames(dispIdMember, &name, 1, &nameCount)) || !name) {
+        return S_OK;
+    }
+
+    LoadEvent event;
+    bool handled = true;
+    if (_wcsicmp(name, L"OnFinishedLoadingDocument") == 0) {
+        event.type = LoadEvent::Type::Complete;
+        event.fileName = EventArgString(pDispParams, 0);
+    } else if (_wcsicmp(name, L"OnFailedLoadingDocument") == 0) {
+        event.type = LoadEvent::Type::Failed;
+        event.fileName = EventArgString(pDispParams, 0);
+        event.errorCode = EventArgLong(pDispParams, 1);
+        event.errorMessage = EventArgString(pDispParams, 2);
+    } else if (IsLoadProgressEvent(name)) {
+        event.type = LoadEvent::Type::Progress;
+        event.stage = name;
+    } else {
+        handled = false;  // printing / selection events aren't used yet
+    }
+    SysFreeString(name);
+
+    if (handled) {
+        // Copy first: the listener may replace itself once a load settles
+        LoadListener listener = m_listener;
+        listener(event);
+    }
+    return S_OK;
+}
@@ -0,0 +1,68 @@
+/**
+ * eDrawings Control Events
+ *
+ * IDispatch sink for the control's default source interface. OpenDoc
+ * returns before the model is parsed; completion is reported through
+ * OnFinishedLoadingDocument / OnFailedLoadingDocument, which this sink
+ * forwards to a listener on the apartment thread. Any other loading or
+ * progress notification the control raises in between comes through as a
+ * Progress event named by its `stage`.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <functional>
+#include <string>
+
+struct LoadEvent {
+    enum class Type { Progress, Complete, Failed };
+
+    Type type = Type::Progress;
+    std::wstring fileName;
+    std::wstring stage;  // Progress: the control event's name, or "open" as OpenDoc is issued
+    long errorCode = 0;
+    std::wstring errorMessage;
+};
+
+using LoadListener = std::function<void(const LoadEvent&)>;
+
+class ControlEventSink : public IDispatch {
+public:
+    // Advise a new sink on the control's default source interface.
+    // Returns nullptr when the control exposes no connection point.
+    static ControlEventSink* Connect(IUnknown* pControl);
+
+    // Unadvise and drop the caller's reference
+    void Disconnect();
+
+    void SetListener(LoadListener listener) { m_listener = std::move(listener); }
+
+    // Settle a pending load as failed (document closed, preview released)
+    void CancelPending(const std::wstring& reason);
+
+    // IUnknown
+    STDMETHODIMP QueryInterface(REFIID riid, void** ppv) override;
+    STDMETHODIMP_(ULONG) AddRef() override;
+    STDMETHODIMP_(ULONG) Release() override;
+
+    // IDispatch
+    STDMETHODIMP GetTypeInfoCount(UINT* pctinfo) override;
+    STDMETHODIMP GetTypeInfo(UINT iTInfo, LCID lcid, ITypeInfo** ppTInfo) override;
+    STDMETHODIMP GetIDsOfNames(REFIID riid, LPOLESTR* rgszNames, UINT cNames,
+        LCID lcid, DISPID* rgDispId) override;
+    STDMETHODIMP Invoke(DISPID dispIdMember, REFIID riid, LCID lcid, WORD wFlags,
+        DISPPARAMS* pDispParams, VARIANT* pVarResult, EXCEPINFO* pExcepInfo,
+        UINT* puArgErr) override;
+
+private:
+    ControlEventSink() = default;
+    ~ControlEventSink();
+
+    ULONG m_refCount = 1;
+    IID m_sourceIid = IID_NULL;
+    ITypeInfo* m_pSourceInfo = nullptr;
+    IConnectionPoint* m_pConnectionPoint = nullptr;
+    DWORD m_cookie = 0;
+    LoadListener m_listener;
+};
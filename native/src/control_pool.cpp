@@ -0,0 +1,495 @@
+/**
+ * eDrawings Control Pool
+ *
+ * Controls are created inside a hidden top-level "parking" window. Acquire
+ * moves the container under the caller's window with SetParent; Release
+ * moves it back and hides it so the next preview starts warm.
+ *
+ * A control's document memory is the growth in process private bytes
+ * between BeginDocument and EndDocument. The control is in-proc, so there
+ * is no separate working set to read; loads running on other apartments at
+ * the same time inflate the figure, which only makes eviction earlier.
+ */
+
+#include "control_pool.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "memory_guard.h"
+#include "native_stats.h"
+
+// eDrawings control CLSID
+// {22945A69-1191-4DCF-9E6F-409BDE94D101} - eDrawings control
+static const CLSID CLSID_EModelViewControl =
+    {0x22945A69, 0x1191, 0x4DCF, {0x9E, 0x6F, 0x40, 0x9B, 0xDE, 0x94, 0xD1, 0x01}};
+
+static const wchar_t* kContainerClass = L"EDrawingsContainer";
+static const wchar_t* kParkingClass = L"EDrawingsParking";
+
+// Hard upper bound so a bad argument can't spin up dozens of controls
+static const size_t kMaxPoolSize = 8;
+
+// Preloads are parked at a typical preview size; the take re-sizes them
+static const int kPreloadWidth = 800;
+static const int kPreloadHeight = 600;
+
+static void RegisterWindowClasses() {
+    // Classes are process-wide; every apartment's pool shares them
+    static std::once_flag registered;
+    std::call_once(registered, []() {
+        WNDCLASSEXW wc = {};
+        wc.cbSize = sizeof(WNDCLASSEXW);
+        wc.lpfnWndProc = DefWindowProcW;
+        wc.hInstance = GetModuleHandle(nullptr);
+        wc.lpszClassName = kContainerClass;
+        wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        RegisterClassExW(&wc);
+
+        wc.lpszClassName = kParkingClass;
+        wc.hbrBackground = nullptr;
+        RegisterClassExW(&wc);
+    });
+}
+
+HRESULT InvokeControl(PooledControl* control, const std::wstring& name,
+    const std::vector<DispatchValue>& args, DispatchValue* result) {
+    if (!control || !control->pDispatch) return E_POINTER;
+    return InvokeCached(control->pDispatch, DispatchCache::ForClass(CLSID_EModelViewControl),
+        control->args, name, args, result);
+}
+
+static bool SamePath(const std::wstring& a, const std::wstring& b) {
+    return CompareStringOrdinal(a.c_str(), static_cast<int>(a.size()),
+        b.c_str(), static_cast<int>(b.size()), TRUE) == CSTR_EQUAL;
+}
+
+// Last write time and size, to notice a file saved since it was loaded
+static bool FileStamp(const std::wstring& path, FILETIME* writeTime, uint64_t* size) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data)) return false;
+    *writeTime = data.ftLastWriteTime;
+    *size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    return true;
+}
+
+static thread_local ControlPool* t_currentPool = nullptr;
+
+ControlPool& ControlPool::Current() {
+    if (!t_currentPool) t_currentPool = new ControlPool();
+    return *t_currentPool;
+}
+
+void ControlPool::DestroyCurrent() {
+    if (!t_currentPool) return;
+    t_currentPool->Shutdown();
+    delete t_currentPool;
+    t_currentPool = nullptr;
+}
+
+void ControlPool::Shutdown() {
+    m_preload = nullptr;
+    m_preloadPath.clear();
+    for (auto& control : m_controls) {
+        DestroyControl(control.get());
+    }
+    m_controls.clear();
+    if (m_hwndParking) {
+        DestroyWindow(m_hwndParking);
+        m_hwndParking = nullptr;
+    }
+}
+
+HWND ControlPool::EnsureParkingWindow() {
+    if (m_hwndParking && IsWindow(m_hwndParking)) return m_hwndParking;
+
+    RegisterWindowClasses();
+
+    // A never-shown popup rather than HWND_MESSAGE: message-only windows
+    // can't own visible children, and parked controls must stay renderable.
+    m_hwndParking = CreateWindowExW(
+        WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
+        kParkingClass,
+        L"",
+        WS_POPUP,
+        0, 0, 0, 0,
+        nullptr,
+        nullptr,
+        GetModuleHandle(nullptr),
+        nullptr
+    );
+    return m_hwndParking;
+}
+
+std::unique_ptr<PooledControl> ControlPool::CreateControl() {
+    HWND hwndParking = EnsureParkingWindow();
+    if (!hwndParking) return nullptr;
+
+    ScopedNativeTimer timer(NativeOp::CreateControl);
+    auto control = std::make_unique<PooledControl>();
+
+    control->hwndContainer = CreateWindowExW(
+        0,
+        kContainerClass,
+        L"",
+        WS_CHILD | WS_CLIPCHILDREN,
+        0, 0, 400, 300,
+        hwndParking,
+        nullptr,
+        GetModuleHandle(nullptr),
+        nullptr
+    );
+
+    if (!control->hwndContainer) {
+        return nullptr;
+    }
+
+    HRESULT hr = CoCreateInstance(
+        CLSID_EModelViewControl,
+        nullptr,
+        CLSCTX_INPROC_SERVER,
+        IID_IUnknown,
+        (void**)&control->pControl
+    );
+
+    if (FAILED(hr) || !control->pControl) {
+        DestroyControl(control.get());
+        return nullptr;
+    }
+
+    // Get IDispatch for calling methods
+    hr = control->pControl->QueryInterface(IID_IDispatch, (void**)&control->pDispatch);
+    if (FAILED(hr)) {
+        DestroyControl(control.get());
+        return nullptr;
+    }
+
+    // First control of the class fills the DISPID cache from its type info
+    DispatchCache::ForClass(CLSID_EModelViewControl).Populate(control->pDispatch);
+
+    // Load completion events; optional, loads still work without them
+    control->events = ControlEventSink::Connect(control->pControl);
+
+    return control;
+}
+
+void ControlPool::DestroyControl(PooledControl* control) {
+    if (!control) return;
+    if (control->events) {
+        control->events->CancelPending(L"Preview destroyed");
+        control->events->Disconnect();
+        control->events = nullptr;
+    }
+    if (control->pDispatch) {
+        control->pDispatch->Release();
+        control->pDispatch = nullptr;
+    }
+    if (control->pControl) {
+        control->pControl->Release();
+        control->pControl = nullptr;
+    }
+    if (control->hwndContainer) {
+        DestroyWindow(control->hwndContainer);
+        control->hwndContainer = nullptr;
+    }
+}
+
+size_t ControlPool::Prewarm(size_t count) {
+    m_capacity = std::min(count, kMaxPoolSize);
+
+    while (IdleCount() < m_capacity) {
+        auto control = CreateControl();
+        if (!control) break;  // eDrawings not installed / not registered
+        m_controls.push_back(std::move(control));
+    }
+    return IdleCount();
+}
+
+PooledControl* ControlPool::Lease() {
+    PooledControl* control = nullptr;
+
+    for (auto& candidate : m_controls) {
+        if (!candidate->inUse && candidate->documentPath.empty()) {
+            control = candidate.get();
+            break;
+        }
+    }
+
+    // Closing a resident is still cheaper than creating a control cold
+    if (!control) {
+        control = OldestResident();
+        if (control) {
+            CloseDocument(control);
+            MemoryGuard::Shared().RecordDocumentEvicted();
+        }
+    }
+
+    if (!control) {
+        auto created = CreateControl();
+        if (!created) return nullptr;
+        control = created.get();
+        m_controls.push_back(std::move(created));
+    }
+
+    control->inUse = true;
+    control->lease = ++m_nextLease;
+    return control;
+}
+
+PooledControl* ControlPool::Acquire(HWND parentHwnd) {
+    PooledControl* control = Lease();
+    if (!control) return nullptr;
+    SetParent(control->hwndContainer, parentHwnd);
+    ShowWindow(control->hwndContainer, SW_SHOWNA);
+    return control;
+}
+
+PooledControl* ControlPool::AcquireOffscreen(int width, int height) {
+    PooledControl* control = Lease();
+    if (!control) return nullptr;
+    // Visible within an invisible parent: laid out and drawable, never on screen
+    SetWindowPos(control->hwndContainer, nullptr, 0, 0, width, height,
+        SWP_NOZORDER | SWP_NOACTIVATE | SWP_SHOWWINDOW);
+    return control;
+}
+
+void ControlPool::Release(PooledControl* control) {
+    if (!control) return;
+
+    auto it = std::find_if(m_controls.begin(), m_controls.end(),
+        [control](const std::unique_ptr<PooledControl>& c) { return c.get() == control; });
+    if (it == m_controls.end()) return;
+
+    // Clear first: cancelling the load below re-enters EndPreload
+    if (control == m_preload) {
+        m_preload = nullptr;
+        m_preloadPath.clear();
+        m_preloadReady = false;
+    }
+
+    // A load still running is abandoned, which also forgets its document
+    if (control->events) {
+        control->events->CancelPending(L"Preview released");
+    }
+
+    control->inUse = false;
+
+    if (!control->documentPath.empty() && m_residentLimit > 0) {
+        ShowWindow(control->hwndContainer, SW_HIDE);
+        SetParent(control->hwndContainer, EnsureParkingWindow());
+        control->lastUsed = ++m_useClock;
+        EnforceResidentLimits();
+        return;
+    }
+
+    // Drop the document so a parked control doesn't pin a large assembly
+    CloseDocument(control);
+
+    if (IdleCount() > m_capacity) {
+        DestroyControl(control);
+        m_controls.erase(it);
+        return;
+    }
+
+    ShowWindow(control->hwndContainer, SW_HIDE);
+    SetParent(control->hwndContainer, EnsureParkingWindow());
+}
+
+void ControlPool::CloseDocument(PooledControl* control) {
+    if (control->pDispatch) {
+        DispatchValue unused;
+        unused.kind = DispatchValue::Kind::String;
+        InvokeControl(control, L"CloseActiveDoc", { unused });
+    }
+    control->documentPath.clear();
+    control->documentBytes = 0;
+}
+
+void ControlPool::Discard(PooledControl* control) {
+    auto it = std::find_if(m_controls.begin(), m_controls.end(),
+        [control](const std::unique_ptr<PooledControl>& c) { return c.get() == control; });
+    if (it == m_controls.end()) return;
+    DestroyControl(control);
+    m_controls.erase(it);
+}
+
+PooledControl* ControlPool::OldestResident() const {
+    PooledControl* oldest = nullptr;
+    for (const auto& candidate : m_controls) {
+        if (candidate->inUse || candidate->documentPath.empty()) continue;
+        if (!oldest || candidate->lastUsed < oldest->lastUsed) oldest = candidate.get();
+    }
+    return oldest;
+}
+
+void ControlPool::EnforceResidentLimits() {
+    for (;;) {
+        size_t count = 0;
+        uint64_t bytes = 0;
+        for (const auto& candidate : m_controls) {
+            if (candidate->inUse || candidate->documentPath.empty()) continue;
+            count++;
+            bytes += candidate->documentBytes;
+        }
+        if (count <= m_residentLimit && bytes <= m_residentBytesLimit) return;
+        PooledControl* oldest = OldestResident();
+        if (!oldest) return;
+
+        CloseDocument(oldest);
+        MemoryGuard::Shared().RecordDocumentEvicted();
+        if (IdleCount() > m_capacity) Discard(oldest);
+    }
+}
+
+void ControlPool::TrimForMemory(uint64_t targetBytes) {
+    auto satisfied = [targetBytes]() {
+        return targetBytes > 0 && MemoryGuard::CommitBytes() <= targetBytes;
+    };
+    if (satisfied()) return;
+
+    // Speculative work goes first; a finished preload parks as a resident
+    CancelPreload();
+
+    while (!satisfied()) {
+        PooledControl* oldest = OldestResident();
+        if (!oldest) break;
+        CloseDocument(oldest);
+        MemoryGuard::Shared().RecordDocumentEvicted();
+    }
+
+    // Still over: warm controls cost memory too. Previews in use are never
+    // touched; the pool refills on the next Prewarm or cold Acquire.
+    while (!satisfied()) {
+        auto it = std::find_if(m_controls.begin(), m_controls.end(),
+            [](const std::unique_ptr<PooledControl>& c) { return !c->inUse; });
+        if (it == m_controls.end()) break;
+        DestroyControl(it->get());
+        m_controls.erase(it);
+        MemoryGuard::Shared().RecordControlEvicted();
+    }
+}
+
+void ControlPool::BeginDocument(PooledControl* control) {
+    if (!control) return;
+    control->documentPath.clear();
+    control->documentBytes = 0;
+    control->loadBaseline = MemoryGuard::CommitBytes();
+}
+
+void ControlPool::EndDocument(PooledControl* control, const std::wstring& path, bool success) {
+    if (!control || !control->inUse) return;
+    if (!success || !FileStamp(path, &control->documentWriteTime, &control->documentSize)) {
+        control->documentPath.clear();
+        control->documentBytes = 0;
+        return;
+    }
+    uint64_t now = MemoryGuard::CommitBytes();
+    control->documentBytes = now > control->loadBaseline ? now - control->loadBaseline : 0;
+    control->documentPath = path;
+}
+
+PooledControl* ControlPool::TakeResident(const std::wstring& path, HWND parentHwnd) {
+    for (auto& candidate : m_controls) {
+        PooledControl* control = candidate.get();
+        if (control->inUse || control->documentPath.empty() || !SamePath(control->documentPath, path)) {
+            continue;
+        }
+
+        FILETIME writeTime;
+        uint64_t size = 0;
+        if (!FileStamp(path, &writeTime, &size) ||
+            CompareFileTime(&writeTime, &control->documentWriteTime) != 0 ||
+            size != control->documentSize) {
+            // Saved (or gone) since it was loaded: the resident copy is stale
+            CloseDocument(control);
+            if (IdleCount() > m_capacity) Discard(control);
+            return nullptr;
+        }
+
+        control->inUse = true;
+        control->lease = ++m_nextLease;
+        SetParent(control->hwndContainer, parentHwnd);
+        ShowWindow(control->hwndContainer, SW_SHOWNA);
+        return control;
+    }
+    return nullptr;
+}
+
+void ControlPool::SetResidentLimits(size_t count, uint64_t bytes) {
+    m_residentLimit = std::min(count, kMaxPoolSize);
+    m_residentBytesLimit = bytes;
+    EnforceResidentLimits();
+}
+
+PooledControl* ControlPool::BeginPreload(const std::wstring& path) {
+    if (m_preload && SamePath(m_preloadPath, path)) return nullptr;
+    CancelPreload();
+
+    PooledControl* control = AcquireOffscreen(kPreloadWidth, kPreloadHeight);
+    if (!control) return nullptr;
+    BeginDocument(control);
+    m_preload = control;
+    m_preloadPath = path;
+    m_preloadReady = false;
+    return control;
+}
+
+void ControlPool::EndPreload(PooledControl* control, bool success) {
+    if (!control || control != m_preload) return;
+    EndDocument(control, m_preloadPath, success);
+    if (success) {
+        m_preloadReady = true;
+    } else {
+        Release(control);
+    }
+}
+
+PooledControl* ControlPool::TakePreloaded(const std::wstring& path, HWND parentHwnd, bool* ready) {
+    if (!m_preload || !SamePath(m_preloadPath, path)) return nullptr;
+
+    PooledControl* control = m_preload;
+    *ready = m_preloadReady;
+    m_preload = nullptr;
+    m_preloadPath.clear();
+    m_preloadReady = false;
+
+    // A new lease, so jobs queued for the preload can tell it has moved on
+    control->lease = ++m_nextLease;
+    SetParent(control->hwndContainer, parentHwnd);
+    ShowWindow(control->hwndContainer, SW_SHOWNA);
+    return control;
+}
+
+void ControlPool::CancelPreload(const std::wstring& path) {
+    if (!m_preload) return;
+    if (!path.empty() && !SamePath(m_preloadPath, path)) return;
+    Release(m_preload);
+}
+
+bool ControlPool::IsPreloaded(const std::wstring& path) const {
+    return m_preload && SamePath(m_preloadPath, path);
+}
+
+bool ControlPool::IsPreloadReady(const std::wstring& path) const {
+    return m_preloadReady && IsPreloaded(path);
+}
+
+bool ControlPool::Owns(const PooledControl* control, uint64_t lease) const {
+    if (!control || lease == 0) return false;
+    for (const auto& candidate : m_controls) {
+        if (candidate.get() == control) {
+            return candidate->inUse && candidate->lease == lease;
+        }
+    }
+    return false;
+}
+
+size_t ControlPool::IdleCount() const {
+    return std::count_if(m_controls.begin(), m_controls.end(),
+        [](const std::unique_ptr<PooledControl>& c) { return !c->inUse && c->documentPath.empty(); });
+}
+
+size_t ControlPool::ResidentCount() const {
+    return std::count_if(m_controls.begin(), m_controls.end(),
+        [](const std::unique_ptr<PooledControl>& c) { return !c->inUse && !c->documentPath.empty(); });
+}
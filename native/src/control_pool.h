@@ -0,0 +1,174 @@
+/**
+ * eDrawings Control Pool
+ *
+ * Keeps a small number of hidden, already-instantiated eDrawings controls
+ * parked in an invisible window so previews can re-parent a warm control
+ * instead of paying RegisterClassExW / CreateWindowExW / CoCreateInstance
+ * every time the user switches files.
+ *
+ * One control per pool can also hold a preloaded document: the file the
+ * user is likely to open next, opened in the parking window ahead of time
+ * and handed to the preview that asks for it with the model already built.
+ *
+ * Released controls keep their document open while residency allows: the
+ * most recently used ones stay parked with the model built, bounded by a
+ * document count and by the memory their loads added, so reopening a file
+ * a preview just let go of is a re-parent instead of a re-parse. Resident
+ * controls are reused (least recently used first) when no blank one is
+ * idle.
+ *
+ * Not thread-safe: each apartment (see com_executor.h) has its own pool,
+ * reached through Current(), and its controls must only be touched from
+ * that thread.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "control_events.h"
+#include "dispatch_cache.h"
+
+// Residency defaults for one apartment's pool
+static const size_t kDefaultResidentDocuments = 2;
+static const uint64_t kDefaultResidentBytes = 512ull * 1024 * 1024;
+
+// A container window plus the eDrawings control living in it
+struct PooledControl {
+    HWND hwndContainer = nullptr;
+    IUnknown* pControl = nullptr;
+    IDispatch* pDispatch = nullptr;
+    ControlEventSink* events = nullptr;  // null if the control has no source interface
+    bool inUse = false;
+    uint64_t lease = 0;  // bumped on every Acquire so stale jobs can tell
+    DispatchArgs args;   // reused argument slots for InvokeControl
+
+    // The fully loaded document, if any; see BeginDocument / EndDocument
+    std::wstring documentPath;
+    uint64_t documentBytes = 0;      // private bytes its load added (approximate)
+    FILETIME documentWriteTime = {};
+    uint64_t documentSize = 0;
+    uint64_t loadBaseline = 0;       // private bytes when the load started
+    uint64_t lastUsed = 0;           // residency LRU clock
+};
+
+class ControlPool {
+public:
+    // The calling apartment's pool, created on first use
+    static ControlPool& Current();
+
+    // Shut down and free the calling apartment's pool
+    static void DestroyCurrent();
+
+    // Set how many idle controls are kept warm and create them now.
+    // Returns the number of idle controls available afterwards.
+    size_t Prewarm(size_t count);
+
+    // Hand out a control re-parented into parentHwnd. Uses a warm control
+    // when one is idle, otherwise creates one cold. Returns nullptr if the
+    // eDrawings control cannot be created.
+    PooledControl* Acquire(HWND parentHwnd);
+
+    // Hand out a control that stays in the (never shown) parking window,
+    // sized to width x height, for headless rendering.
+    PooledControl* AcquireOffscreen(int width, int height);
+
+    // Hide the control and park it for reuse. A loaded document stays open
+    // as a resident while the limits allow; otherwise it is closed, and
+    // blank controls beyond the configured capacity are destroyed.
+    void Release(PooledControl* control);
+
+    // Bracket an OpenDoc on a leased control: Begin forgets any previous
+    // document and samples memory, End records path as loaded (on success)
+    // so a later Release can keep it resident.
+    void BeginDocument(PooledControl* control);
+    void EndDocument(PooledControl* control, const std::wstring& path, bool success);
+
+    // Hand out the parked control that still has path loaded, re-parented
+    // into parentHwnd. nullptr if none does, or if the file changed on disk
+    // since it was loaded (that resident is closed).
+    PooledControl* TakeResident(const std::wstring& path, HWND parentHwnd);
+
+    // At most `count` resident documents, together adding at most `bytes`.
+    // Trims at once; a count of 0 turns residency off.
+    void SetResidentLimits(size_t count, uint64_t bytes);
+
+    // Memory pressure (see memory_guard.h): drop the preload, then close
+    // residents least recently used first, then destroy idle controls,
+    // until process commit is at most targetBytes. 0 drops all of them.
+    void TrimForMemory(uint64_t targetBytes);
+
+    // Lease a parked control to preload path on, replacing any previous
+    // preload. The caller runs OpenDoc and reports through EndPreload.
+    // Returns nullptr if path is already preloaded (or loading) or no
+    // control is available.
+    PooledControl* BeginPreload(const std::wstring& path);
+
+    // The preload on control finished loading; a failed one is released.
+    // Ignored if the preload was dropped or taken meanwhile.
+    void EndPreload(PooledControl* control, bool success);
+
+    // Hand out the control preloading path, re-parented into parentHwnd.
+    // *ready says whether its load already completed; if not, the caller
+    // waits for the control's own completion event. nullptr if no preload
+    // matches.
+    PooledControl* TakePreloaded(const std::wstring& path, HWND parentHwnd, bool* ready);
+
+    // Drop the preload if it is for path (any path when empty)
+    void CancelPreload(const std::wstring& path = std::wstring());
+
+    bool IsPreloaded(const std::wstring& path) const;
+
+    // The preload for path has finished loading
+    bool IsPreloadReady(const std::wstring& path) const;
+
+    // True if control is still alive and leased under this lease number.
+    // Jobs queued before a release use this to avoid touching a control
+    // that has since been handed to another preview.
+    bool Owns(const PooledControl* control, uint64_t lease) const;
+
+    // Destroy every control, in use or not. Called (through DestroyCurrent)
+    // on each apartment before it shuts down.
+    void Shutdown();
+
+    // Parked controls with no document; residents are counted separately
+    size_t IdleCount() const;
+    size_t ResidentCount() const;
+    size_t Capacity() const { return m_capacity; }
+
+private:
+    ControlPool() = default;
+    ControlPool(const ControlPool&) = delete;
+    ControlPool& operator=(const ControlPool&) = delete;
+
+    PooledControl* Lease();
+    std::unique_ptr<PooledControl> CreateControl();
+    void DestroyControl(PooledControl* control);
+    HWND EnsureParkingWindow();
+    void CloseDocument(PooledControl* control);
+    void EnforceResidentLimits();
+    PooledControl* OldestResident() const;
+    void Discard(PooledControl* control);
+
+    std::vector<std::unique_ptr<PooledControl>> m_controls;
+    size_t m_capacity = 2;
+    uint64_t m_nextLease = 0;
+    HWND m_hwndParking = nullptr;
+
+    size_t m_residentLimit = kDefaultResidentDocuments;
+    uint64_t m_residentBytesLimit = kDefaultResidentBytes;
+    uint64_t m_useClock = 0;
+
+    PooledControl* m_preload = nullptr;  // leased, parked, loading m_preloadPath
+    std::wstring m_preloadPath;
+    bool m_preloadReady = false;
+};
+
+// Call a member on a pooled control through the shared eDrawings DISPID
+// cache. Must run on the control's apartment.
+HRESULT InvokeControl(PooledControl* control, const std::wstring& name,
+    const std::vector<DispatchValue>& args, DispatchValue* result = nullptr);
@@ -0,0 +1,400 @@
+/**
+ * Bulk Copy Engine
+ */
+
+#include "copy_engine.h"
+
+#include <windows.h>
+#include <algorithm>
+#include <future>
+#include <memory>
+
+#include "aligned_buffer_pool.h"
+#include "native_stats.h"
+#include "sha256.h"
+#include "unbuffered_io.h"
+
+// Per-slot buffer size: large enough to keep the disk streaming, and a
+// multiple of every sector size, as unbuffered I/O requires
+static const DWORD kChunkSize = 1024 * 1024;
+
+// Unbuffered writes are rounded up to this; the destination is truncated
+// to the real length afterwards. Covers 512-byte and 4K-sector disks.
+static const DWORD kSectorAlign = 4096;
+
+// Files at least this large (when not hashed) go through CopyFile2
+static const uint64_t kLargeFileBytes = 64ull * 1024 * 1024;
+
+// Copies contend for the same disks; past this they only seek
+static const size_t kDefaultConcurrency = 4;
+static const size_t kMaxConcurrency = 16;
+
+struct CopyEngine::Job {
+    std::vector<CopyPair> pairs;
+    CopyOptions options;
+    ResultCallback onResult;
+    DoneCallback onDone;
+    CancelTokenPtr token;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> slots{0};
+};
+
+// Reused for every file a slot copies
+struct CopyEngine::Slot {
+    uint8_t* buffers[2] = {};
+    OVERLAPPED read = {};
+    OVERLAPPED write = {};
+};
+
+CopyEngine& CopyEngine::Shared() {
+    static CopyEngine engine;
+    return engine;
+}
+
+CopyEngine::CopyEngine() : m_workers(kMaxConcurrency) {}
+
+void CopyEngine::CopyFiles(std::vector<CopyPair> pairs, const CopyOptions& options,
+    ResultCallback onResult, DoneCallback onDone, CancelTokenPtr token) {
+    auto* job = new Job();
+    job->pairs = std::move(pairs);
+    job->options = options;
+    job->onResult = std::move(onResult);
+    job->onDone = std::move(onDone);
+    job->token = std::move(token);
+
+    size_t concurrency = options.concurrency == 0 ? kDefaultConcurrency : options.concurrency;
+    size_t slots = std::min(std::clamp<size_t>(concurrency, 1, kMaxConcurrency), job->pairs.size());
+
+    if (slots == 0 || m_stopping) {
+        for (size_t i = 0; i < job->pairs.size(); i++) {
+            CopyResult result;
+            result.error = "Copy engine not running";
+            job->onResult(i, std::move(result));
+        }
+        job->onDone();
+        delete job;
+        return;
+    }
+
+    job->slots = slots;
+    for (size_t i = 0; i < slots; i++) {
+        m_workers.Submit([this, job]() { RunSlot(job); });
+    }
+}
+
+void CopyEngine::Shutdown() {
+    m_stopping = true;
+    m_workers.Shutdown();
+}
+
+void CopyEngine::RunSlot(Job* job) {
+    Slot slot;
+    slot.read.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    slot.write.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    for (uint8_t*& buffer : slot.buffers) {
+        buffer = AlignedBufferPool::Shared().Acquire(kChunkSize);
+    }
+    bool ready = slot.read.hEvent && slot.write.hEvent && slot.buffers[0] && slot.buffers[1];
+
+    // A slot that could not set up leaves its share of the pairs to the others
+    while (ready) {
+        AwaitTurn(job);
+        size_t index = job->next++;
+        if (index >= job->pairs.size()) break;
+        CopyResult result;
+        if (IsCancelled(job, index)) {
+            result.error = kCancelledError;
+        } else {
+            result = CopyOne(job, &slot, index);
+        }
+        job->onResult(index, std::move(result));
+    }
+
+    for (uint8_t* buffer : slot.buffers) {
+        AlignedBufferPool::Shared().Release(buffer, kChunkSize);
+    }
+    if (slot.read.hEvent) CloseHandle(slot.read.hEvent);
+    if (slot.write.hEvent) CloseHandle(slot.write.hEvent);
+
+    if (--job->slots > 0) return;
+
+    // Last slot out: fail whatever no slot was able to take
+    for (size_t index = job->next++; index < job->pairs.size(); index = job->next++) {
+        CopyResult result;
+        result.error = "Out of memory";
+        job->onResult(index, std::move(result));
+    }
+    job->onDone();
+    delete job;
+}
+
+void CopyEngine::AwaitTurn(Job* job) {
+    // Only the turn comes from the pool; the copy stays on this thread. A
+    // turn the pool drops at shutdown breaks the promise, which ends the wait.
+    auto turn = std::make_shared<std::promise<void>>();
+    std::future<void> ready = turn->get_future();
+    ThreadPool::Shared().Submit([turn]() { turn->set_value(); }, job->options.priority);
+    ready.wait();
+}
+
+bool CopyEngine::IsCancelled(Job* job, size_t index) const {
+    if (m_stopping) return true;
+    if (!job->token) return false;
+    const CopyPair& pair = job->pairs[index];
+    return job->token->IsCancelled(pair.source) || job->token->IsCancelled(pair.destination);
+}
+
+// Create dir and any missing parents
+static bool EnsureDirectory(const std::wstring& dir) {
+    if (dir.empty()) return false;
+    DWORD attributes = GetFileAttributesW(dir.c_str());
+    if (attributes != INVALID_FILE_ATTRIBUTES) return (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+
+    size_t separator = dir.find_last_of(L"\\/");
+    if (separator != std::wstring::npos && separator > 0) {
+        EnsureDirectory(dir.substr(0, separator));
+    }
+    return CreateDirectoryW(dir.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+static void EnsureParentDirectory(const std::wstring& path) {
+    size_t separator = path.find_last_of(L"\\/");
+    if (separator != std::wstring::npos && separator > 0) {
+        EnsureDirectory(path.substr(0, separator));
+    }
+}
+
+static const char* OpenError(DWORD error) {
+    return error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND
+        ? "File not found" : "Could not open file";
+}
+
+CopyResult CopyEngine::CopyOne(Job* job, Slot* slot, size_t index) {
+    const CopyPair& pair = job->pairs[index];
+    int64_t started = NativeStats::Now();
+
+    CopyResult result;
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(pair.source.c_str(), GetFileExInfoStandard, &data)) {
+        result.error = OpenError(GetLastError());
+        return result;
+    }
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+        result.error = "Source is a directory";
+        return result;
+    }
+    uint64_t size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+
+    EnsureParentDirectory(pair.destination);
+    if (!job->options.verifyHash && size >= kLargeFileBytes) {
+        result = CopyWithCopyFile2(job, index);
+    } else {
+        result = CopyOverlapped(job, slot, index, size);
+    }
+
+    NativeStats::Record(NativeOp::CopyFile, started);
+    return result;
+}
+
+// CopyFile2 polls this between chunks
+static COPYFILE2_MESSAGE_ACTION CALLBACK CopyFile2Progress(const COPYFILE2_MESSAGE*, PVOID context) {
+    const auto* cancelled = static_cast<const std::function<bool()>*>(context);
+    return (*cancelled)() ? COPYFILE2_PROGRESS_CANCEL : COPYFILE2_PROGRESS_CONTINUE;
+}
+
+CopyResult CopyEngine::CopyWithCopyFile2(Job* job, size_t index) {
+    const CopyPair& pair = job->pairs[index];
+    std::function<bool()> cancelled = [this, job, index]() { return IsCancelled(job, index); };
+
+    COPYFILE2_EXTENDED_PARAMETERS params = {};
+    params.dwSize = sizeof(params);
+    params.dwCopyFlags = COPY_FILE_NO_BUFFERING | (job->options.overwrite ? 0 : COPY_FILE_FAIL_IF_EXISTS);
+    params.pProgressRoutine = CopyFile2Progress;
+    params.pvCallbackContext = &cancelled;
+
+    CopyResult result;
+    result.copyFile2 = true;
+    HRESULT hr = CopyFile2(pair.source.c_str(), pair.destination.c_str(), &params);
+    if (SUCCEEDED(hr)) {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (GetFileAttributesExW(pair.destination.c_str(), GetFileExInfoStandard, &data)) {
+            result.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        }
+        result.success = true;
+    } else if (hr == HRESULT_FROM_WIN32(ERROR_REQUEST_ABORTED)) {
+        result.error = kCancelledError;  // CopyFile2 removes the partial file itself
+    } else if (hr == HRESULT_FROM_WIN32(ERROR_FILE_EXISTS)) {
+        result.error = "Destination exists";
+    } else if (hr == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) || hr == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND)) {
+        result.error = "File not found";
+    } else {
+        result.error = "Copy failed";
+    }
+    return result;
+}
+
+static HANDLE OpenDestination(const std::wstring& path, bool overwrite, bool* unbuffered) {
+    DWORD disposition = overwrite ? CREATE_ALWAYS : CREATE_NEW;
+    *unbuffered = true;
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, disposition,
+        FILE_FLAG_OVERLAPPED | FILE_FLAG_NO_BUFFERING, nullptr);
+    if (file != INVALID_HANDLE_VALUE) return file;
+
+    DWORD error = GetLastError();
+    if (error != ERROR_INVALID_PARAMETER && error != ERROR_NOT_SUPPORTED) return INVALID_HANDLE_VALUE;
+    *unbuffered = false;
+    file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, disposition, FILE_FLAG_OVERLAPPED, nullptr);
+    if (file == INVALID_HANDLE_VALUE) SetLastError(error);
+    return file;
+}
+
+static void SetOffset(OVERLAPPED* overlapped, uint64_t offset) {
+    HANDLE event = overlapped->hEvent;
+    ZeroMemory(overlapped, sizeof(*overlapped));
+    overlapped->hEvent = event;
+    overlapped->Offset = static_cast<DWORD>(offset);
+    overlapped->OffsetHigh = static_cast<DWORD>(offset >> 32);
+}
+
+// Start reading a chunk. A read that fails at once with end of file (the
+// file shrank) leaves *pending false and is not an error.
+static const char* IssueRead(HANDLE file, OVERLAPPED* overlapped, uint8_t* buffer, bool* pending) {
+    *pending = false;
+    if (!ReadFile(file, buffer, kChunkSize, nullptr, overlapped)) {
+        DWORD error = GetLastError();
+        if (error == ERROR_HANDLE_EOF) return nullptr;
+        if (error != ERROR_IO_PENDING) return "Read failed";
+    }
+    *pending = true;
+    return nullptr;
+}
+
+// Wait for an issued read or write. End of file reads as zero bytes.
+static bool Finish(HANDLE file, OVERLAPPED* overlapped, DWORD* bytes) {
+    *bytes = 0;
+    if (GetOverlappedResult(file, overlapped, bytes, TRUE)) return true;
+    return GetLastError() == ERROR_HANDLE_EOF;
+}
+
+CopyResult CopyEngine::CopyOverlapped(Job* job, Slot* slot, size_t index, uint64_t size) {
+    const CopyPair& pair = job->pairs[index];
+    CopyResult result;
+
+    bool sourceUnbuffered = false;
+    HANDLE source = OpenForUnbufferedRead(pair.source, &sourceUnbuffered);
+    if (source == INVALID_HANDLE_VALUE) {
+        result.error = OpenError(GetLastError());
+        return result;
+    }
+
+    bool destinationUnbuffered = false;
+    HANDLE destination = OpenDestination(pair.destination, job->options.overwrite, &destinationUnbuffered);
+    if (destination == INVALID_HANDLE_VALUE) {
+        DWORD error = GetLastError();
+        CloseHandle(source);
+        result.error = error == ERROR_FILE_EXISTS ? "Destination exists" : "Could not create destination";
+        return result;
+    }
+
+    // One allocation up front instead of growing the file chunk by chunk
+    FILE_ALLOCATION_INFO allocation = {};
+    allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+    SetFileInformationByHandle(destination, FileAllocationInfo, &allocation, sizeof(allocation));
+
+    Sha256 sha;
+    uint64_t offset = 0;
+    const char* error = nullptr;
+    bool readPending = false;
+    bool writePending = false;
+    DWORD writeLength = 0;
+    int current = 0;
+
+    // Double-buffered: chunk n is hashed while chunk n+1 is read and chunk
+    // n is written
+    if (size > 0) {
+        SetOffset(&slot->read, 0);
+        error = IssueRead(source, &slot->read, slot->buffers[0], &readPending);
+    }
+
+    while (readPending && !error) {
+        DWORD got = 0;
+        readPending = false;
+        if (!Finish(source, &slot->read, &got)) {
+            error = "Read failed";
+            break;
+        }
+
+        // The other buffer is the next read target: its write must be done
+        if (writePending) {
+            DWORD written = 0;
+            writePending = false;
+            if (!Finish(destination, &slot->write, &written) || written != writeLength) {
+                error = "Write failed";
+                break;
+            }
+        }
+        if (got == 0) break;
+
+        uint8_t* data = slot->buffers[current];
+        writeLength = destinationUnbuffered ? (got + kSectorAlign - 1) / kSectorAlign * kSectorAlign : got;
+        SetOffset(&slot->write, offset);
+        if (!WriteFile(destination, data, writeLength, nullptr, &slot->write) && GetLastError() != ERROR_IO_PENDING) {
+            error = "Write failed";
+            break;
+        }
+        writePending = true;
+        offset += got;
+
+        // A short read is end of file, even if the file shrank
+        bool last = got < kChunkSize || offset >= size;
+        if (!last && IsCancelled(job, index)) {
+            error = kCancelledError;
+        } else if (!last) {
+            SetOffset(&slot->read, offset);
+            error = IssueRead(source, &slot->read, slot->buffers[1 - current], &readPending);
+        }
+
+        if (job->options.verifyHash) sha.Update(data, got);
+        current = 1 - current;
+    }
+
+    // Nothing may still target the slot's buffers once this returns
+    DWORD ignored = 0;
+    if (readPending) {
+        CancelIoEx(source, &slot->read);
+        Finish(source, &slot->read, &ignored);
+    }
+    if (writePending) {
+        DWORD written = 0;
+        if ((!Finish(destination, &slot->write, &written) || written != writeLength) && !error) {
+            error = "Write failed";
+        }
+    }
+
+    if (!error) {
+        // Trim the sector padding, then carry over timestamps and attributes
+        FILE_END_OF_FILE_INFO end = {};
+        end.EndOfFile.QuadPart = static_cast<LONGLONG>(offset);
+        FILE_BASIC_INFO basic = {};
+        if (!SetFileInformationByHandle(destination, FileEndOfFileInfo, &end, sizeof(end))) {
+            error = "Write failed";
+        } else if (GetFileInformationByHandleEx(source, FileBasicInfo, &basic, sizeof(basic))) {
+            basic.ChangeTime.QuadPart = 0;
+            SetFileInformationByHandle(destination, FileBasicInfo, &basic, sizeof(basic));
+        }
+    }
+
+    CloseHandle(source);
+    CloseHandle(destination);
+
+    if (error) {
+        DeleteFileW(pair.destination.c_str());
+        result.error = error;
+        return result;
+    }
+
+    result.success = true;
+    result.size = offset;
+    if (job->options.verifyHash) result.hash = sha.FinalHex();
+    return result;
+}
@@ -0,0 +1,88 @@
+/**
+ * Bulk Copy Engine
+ *
+ * Copies many files at once, each slot copying one file after another on
+ * the engine's own threads (so a long copy never occupies the thumbnail
+ * workers). Each file still waits for a turn on the shared ThreadPool at
+ * the batch's priority, so visible work goes ahead of a prefetch copy
+ * between files. Two paths:
+ *
+ *   - Large files, when no hash is wanted, go through CopyFile2 with
+ *     COPY_FILE_NO_BUFFERING: the kernel's own copy, which keeps metadata
+ *     and streams and stays out of the system cache.
+ *   - Everything else is copied by the slot itself: unbuffered overlapped
+ *     reads and writes into two page-aligned buffers per slot, so the next
+ *     read and the previous write are in flight while the current chunk is
+ *     hashed. With verifyHash the SHA-256 of the bytes copied comes back
+ *     with the result, and no second read of either file is needed.
+ *
+ * Missing destination folders are created. A failed or cancelled copy
+ * deletes its partial destination. N-API free; callbacks run on the
+ * engine's threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "job_registry.h"
+#include "thread_pool.h"
+
+struct CopyPair {
+    std::wstring source;
+    std::wstring destination;
+};
+
+struct CopyOptions {
+    size_t concurrency = 0;  // files in flight, 1-16 (0: 4)
+    bool verifyHash = false;
+    bool overwrite = true;
+    JobPriority priority = JobPriority::Normal;  // turn on the shared pool before each file
+};
+
+struct CopyResult {
+    bool success = false;
+    std::string error;
+    std::string hash;  // lowercase hex, with verifyHash
+    uint64_t size = 0;
+    bool copyFile2 = false;  // went through CopyFile2 rather than the slot's own loop
+};
+
+class CopyEngine {
+public:
+    // Called once per file, in completion order, from an engine thread
+    using ResultCallback = std::function<void(size_t index, CopyResult&& result)>;
+    // Called once after the last result
+    using DoneCallback = std::function<void()>;
+
+    static CopyEngine& Shared();
+
+    // Queue a set of copies; returns immediately. Files the token cancels
+    // (by source or destination) fail as "Cancelled", mid-file ones at
+    // their next chunk.
+    void CopyFiles(std::vector<CopyPair> pairs, const CopyOptions& options,
+        ResultCallback onResult, DoneCallback onDone, CancelTokenPtr token = nullptr);
+
+    // Cancel running copies and join the threads. Queued batches are dropped.
+    void Shutdown();
+
+private:
+    struct Job;
+    struct Slot;
+
+    CopyEngine();
+
+    void RunSlot(Job* job);
+    void AwaitTurn(Job* job);
+    bool IsCancelled(Job* job, size_t index) const;
+    CopyResult CopyOne(Job* job, Slot* slot, size_t index);
+    CopyResult CopyWithCopyFile2(Job* job, size_t index);
+    CopyResult CopyOverlapped(Job* job, Slot* slot, size_t index, uint64_t size);
+
+    ThreadPool m_workers;
+    std::atomic<bool> m_stopping{false};
+};
@@ -0,0 +1,154 @@
+/**
+ * Bulk Copy Bindings
+ *
+ * copyBatch(pairs: [{ from, to }], { concurrency, verifyHash, overwrite, jobId })
+ *   -> Promise<{ copied, failed, cancelled, bytes, elapsedMs,
+ *                results: [{ index, from, to, success, size, hash?, method, error? }] }>
+ *
+ * Files are copied on the CopyEngine's threads; see copy_engine.h for
+ * which path a file takes. `method` is 'copyFile2' or 'overlapped'.
+ */
+
+#include "addon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "copy_engine.h"
+
+static const uint32_t kMaxConcurrency = 16;
+
+struct CopyBatch {
+    std::vector<std::wstring> from;  // echoed back as given
+    std::vector<std::wstring> to;
+    AsyncCompletion* completion = nullptr;
+    std::chrono::steady_clock::time_point started;
+
+    std::mutex mutex;
+    std::vector<CopyResult> results;
+    size_t copied = 0;
+    size_t failed = 0;
+    size_t cancelled = 0;  // included in failed
+    uint64_t bytes = 0;
+};
+
+static Napi::Value BuildCopySummary(Napi::Env env, CopyBatch* batch, double elapsedMs) {
+    Napi::Array results = Napi::Array::New(env, batch->results.size());
+    for (size_t i = 0; i < batch->results.size(); i++) {
+        const CopyResult& result = batch->results[i];
+        Napi::Object object = Napi::Object::New(env);
+        object.Set("index", Napi::Number::New(env, static_cast<double>(i)));
+        object.Set("from", WideToJs(env, batch->from[i]));
+        object.Set("to", WideToJs(env, batch->to[i]));
+        object.Set("success", Napi::Boolean::New(env, result.success));
+        object.Set("size", Napi::Number::New(env, static_cast<double>(result.size)));
+        object.Set("method", Napi::String::New(env, result.copyFile2 ? "copyFile2" : "overlapped"));
+        if (!result.hash.empty()) object.Set("hash", Napi::String::New(env, result.hash));
+        if (!result.success) object.Set("error", Napi::String::New(env, result.error));
+        results.Set(static_cast<uint32_t>(i), object);
+    }
+
+    Napi::Object summary = Napi::Object::New(env);
+    summary.Set("copied", Napi::Number::New(env, static_cast<double>(batch->copied)));
+    summary.Set("failed", Napi::Number::New(env, static_cast<double>(batch->failed)));
+    summary.Set("cancelled", Napi::Number::New(env, static_cast<double>(batch->cancelled)));
+    summary.Set("bytes", Napi::Number::New(env, static_cast<double>(batch->bytes)));
+    summary.Set("elapsedMs", Napi::Number::New(env, elapsedMs));
+    summary.Set("results", results);
+    return summary;
+}
+
+static bool ReadPathProperty(const Napi::Object& pair, const char* name, std::wstring* out) {
+    Napi::Value value = pair.Get(name);
+    if (!value.IsString()) return false;
+    out->assign(WideScratch(value));
+    return !out->empty();
+}
+
+// copyBatch(pairs: Array<{ from: string, to: string }>,
+//           options?: { concurrency?: number, verifyHash?: boolean, overwrite?: boolean, jobId?: number })
+static Napi::Value CopyBatchFiles(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Array of { from, to } pairs expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    auto batch = std::make_shared<CopyBatch>();
+    std::vector<CopyPair> pairs;
+    std::vector<std::wstring> tokenPaths;
+
+    Napi::Array array = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value value = array.Get(i);
+        std::wstring from;
+        std::wstring to;
+        if (!value.IsObject() || !ReadPathProperty(value.As<Napi::Object>(), "from", &from) ||
+            !ReadPathProperty(value.As<Napi::Object>(), "to", &to)) {
+            Napi::TypeError::New(env, "Each pair needs string from and to paths").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        CopyPair pair;
+        pair.source = from;
+        pair.destination = to;
+        tokenPaths.push_back(pair.source);
+        tokenPaths.push_back(pair.destination);
+        pairs.push_back(std::move(pair));
+        batch->from.push_back(std::move(from));
+        batch->to.push_back(std::move(to));
+    }
+
+    CopyOptions options;
+    JobOptions job;
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object object = info[1].As<Napi::Object>();
+        Napi::Value value = object.Get("concurrency");
+        if (value.IsNumber()) {
+            options.concurrency = std::clamp<uint32_t>(value.As<Napi::Number>().Uint32Value(), 1, kMaxConcurrency);
+        }
+        value = object.Get("verifyHash");
+        if (value.IsBoolean()) options.verifyHash = value.As<Napi::Boolean>().Value();
+        value = object.Get("overwrite");
+        if (value.IsBoolean()) options.overwrite = value.As<Napi::Boolean>().Value();
+        if (!ReadJobOptions(env, object, &job)) return env.Null();
+        options.priority = job.priority;
+    }
+
+    batch->results.resize(pairs.size());
+    batch->completion = AsyncCompletion::Create(env, "copyBatch");
+    batch->started = std::chrono::steady_clock::now();
+    Napi::Promise promise = batch->completion->Promise();
+
+    // Cancelling a folder reaches copies out of it and into it
+    CancelTokenPtr token = CancelToken::Create(job.jobId, tokenPaths);
+    CopyEngine::Shared().CopyFiles(std::move(pairs), options,
+        [batch](size_t index, CopyResult&& result) {
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (result.success) {
+                batch->copied++;
+                batch->bytes += result.size;
+            } else {
+                batch->failed++;
+                if (result.error == kCancelledError) batch->cancelled++;
+            }
+            batch->results[index] = std::move(result);
+        },
+        [batch]() {
+            double elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - batch->started).count();
+            batch->completion->Resolve([batch, elapsedMs](Napi::Env env) {
+                return BuildCopySummary(env, batch.get(), elapsedMs);
+            });
+        }, std::move(token));
+
+    return promise;
+}
+
+void InitCopyBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("copyBatch", Napi::Function::New(env, CopyBatchFiles));
+}
@@ -0,0 +1,184 @@
+/**
+ * Directory Tree Enumeration
+ */
+
+#include "directory_tree.h"
+
+#include <windows.h>
+
+// The SMB redirector caps a single query at 64 KB
+static const DWORD kQueryBufferSize = 64 * 1024;
+
+struct PendingDirectory {
+    std::wstring path;
+    uint32_t entry;  // index in DirectoryTree::entries, kTreeRoot for the root
+};
+
+// \\?\ form so deep vault trees are not cut off at MAX_PATH
+static std::wstring ExtendedPath(std::wstring path) {
+    for (auto& c : path) {
+        if (c == L'/') c = L'\\';
+    }
+    if (path.compare(0, 4, L"\\\\?\\") == 0) return path;
+    if (path.compare(0, 2, L"\\\\") == 0) return L"\\\\?\\UNC\\" + path.substr(2);
+    if (path.size() >= 3 && path[1] == L':' && path[2] == L'\\') return L"\\\\?\\" + path;
+    return path;
+}
+
+static std::wstring JoinPath(const std::wstring& directory, const wchar_t* name, size_t length) {
+    std::wstring path = directory;
+    if (path.empty() || path.back() != L'\\') path.push_back(L'\\');
+    path.append(name, length);
+    return path;
+}
+
+class TreeBuilder {
+public:
+    TreeBuilder(DirectoryTree* tree, const TreeOptions& options) : m_tree(tree), m_options(options) {}
+
+    // False if the directory could not be opened at all
+    bool ReadDirectory(const std::wstring& path, uint32_t parent);
+
+    std::vector<PendingDirectory>& Pending() { return m_pending; }
+
+private:
+    bool ReadWithHandle(HANDLE directory, const std::wstring& path, uint32_t parent, bool* unsupported);
+    bool ReadWithFind(const std::wstring& path, uint32_t parent);
+
+    // False once maxEntries is reached
+    bool Add(const std::wstring& directory, uint32_t parent, const wchar_t* name, size_t length,
+        uint32_t attributes, uint64_t size, int64_t lastWriteTime, uint64_t fileId);
+
+    DirectoryTree* m_tree;
+    const TreeOptions& m_options;
+    std::vector<PendingDirectory> m_pending;
+    std::vector<uint64_t> m_buffer;  // 8-byte aligned, as the query requires
+};
+
+bool TreeBuilder::Add(const std::wstring& directory, uint32_t parent, const wchar_t* name, size_t length,
+    uint32_t attributes, uint64_t size, int64_t lastWriteTime, uint64_t fileId) {
+    if (length == 1 && name[0] == L'.') return true;
+    if (length == 2 && name[0] == L'.' && name[1] == L'.') return true;
+    if (m_options.skipHidden && (name[0] == L'.' || (attributes & FILE_ATTRIBUTE_HIDDEN))) return true;
+
+    if (m_options.maxEntries && m_tree->entries.size() >= m_options.maxEntries) {
+        m_tree->truncated = true;
+        return false;
+    }
+
+    TreeEntry entry;
+    entry.parent = parent;
+    entry.nameOffset = static_cast<uint32_t>(m_tree->names.size());
+    entry.attributes = attributes;
+    entry.size = (attributes & FILE_ATTRIBUTE_DIRECTORY) ? 0 : size;
+    entry.lastWriteTime = lastWriteTime;
+    entry.fileId = fileId;
+
+    int utf8Length = WideCharToMultiByte(CP_UTF8, 0, name, static_cast<int>(length), nullptr, 0, nullptr, nullptr);
+    if (utf8Length > 0) {
+        m_tree->names.resize(entry.nameOffset + utf8Length);
+        WideCharToMultiByte(CP_UTF8, 0, name, static_cast<int>(length),
+            &m_tree->names[entry.nameOffset], utf8Length, nullptr, nullptr);
+    }
+    entry.nameLength = static_cast<uint32_t>(m_tree->names.size()) - entry.nameOffset;
+
+    uint32_t index = static_cast<uint32_t>(m_tree->entries.size());
+    m_tree->entries.push_back(entry);
+
+    if ((attributes & FILE_ATTRIBUTE_DIRECTORY) && !(attributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+        m_pending.push_back({ JoinPath(directory, name, length), index });
+    }
+    return true;
+}
+
+bool TreeBuilder::ReadWithHandle(HANDLE directory, const std::wstring& path, uint32_t parent, bool* unsupported) {
+    if (m_buffer.empty()) m_buffer.resize(kQueryBufferSize / sizeof(uint64_t));
+
+    FILE_INFO_BY_HANDLE_CLASS infoClass = FileIdBothDirectoryRestartInfo;
+    for (;;) {
+        if (!GetFileInformationByHandleEx(directory, infoClass, m_buffer.data(), kQueryBufferSize)) {
+            DWORD error = GetLastError();
+            // Only the first query can tell us the class is not supported
+            *unsupported = infoClass == FileIdBothDirectoryRestartInfo &&
+                (error == ERROR_INVALID_PARAMETER || error == ERROR_INVALID_FUNCTION || error == ERROR_NOT_SUPPORTED);
+            return error == ERROR_NO_MORE_FILES;
+        }
+        infoClass = FileIdBothDirectoryInfo;
+
+        auto* cursor = reinterpret_cast<const uint8_t*>(m_buffer.data());
+        for (;;) {
+            auto* info = reinterpret_cast<const FILE_ID_BOTH_DIR_INFO*>(cursor);
+            if (!Add(path, parent, info->FileName, info->FileNameLength / sizeof(wchar_t), info->FileAttributes,
+                    static_cast<uint64_t>(info->EndOfFile.QuadPart), info->LastWriteTime.QuadPart,
+                    static_cast<uint64_t>(info->FileId.QuadPart))) {
+                return true;
+            }
+            if (info->NextEntryOffset == 0) break;
+            cursor += info->NextEntryOffset;
+        }
+    }
+}
+
+bool TreeBuilder::ReadWithFind(const std::wstring& path, uint32_t parent) {
+    WIN32_FIND_DATAW data;
+    HANDLE find = FindFirstFileExW(JoinPath(path, L"*", 1).c_str(), FindExInfoBasic, &data,
+        FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE) return GetLastError() == ERROR_FILE_NOT_FOUND;
+
+    do {
+        uint64_t size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        int64_t lastWrite = static_cast<int64_t>(
+            (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime);
+        if (!Add(path, parent, data.cFileName, wcslen(data.cFileName), data.dwFileAttributes, size, lastWrite, 0)) {
+            break;
+        }
+    } while (FindNextFileW(find, &data));
+
+    FindClose(find);
+    return true;
+}
+
+bool TreeBuilder::ReadDirectory(const std::wstring& path, uint32_t parent) {
+    HANDLE directory = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (directory == INVALID_HANDLE_VALUE) return ReadWithFind(path, parent);
+
+    bool unsupported = false;
+    bool ok = ReadWithHandle(directory, path, parent, &unsupported);
+    CloseHandle(directory);
+    return unsupported ? ReadWithFind(path, parent) : ok;
+}
+
+DirectoryTree EnumerateTree(const std::wstring& root, const TreeOptions& options) {
+    DirectoryTree tree;
+    std::wstring rootPath = ExtendedPath(root);
+
+    DWORD attributes = GetFileAttributesW(rootPath.c_str());
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        tree.error = "Directory not found";
+        return tree;
+    }
+    if (!(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        tree.error = "Not a directory";
+        return tree;
+    }
+
+    TreeBuilder builder(&tree, options);
+    if (!builder.ReadDirectory(rootPath, DirectoryTree::kTreeRoot)) {
+        tree.error = "Could not read directory";
+        return tree;
+    }
+
+    // Depth-first via an explicit stack: vault trees can be deeper than is
+    // comfortable to recurse on a worker stack
+    auto& pending = builder.Pending();
+    while (!pending.empty() && !tree.truncated) {
+        PendingDirectory next = std::move(pending.back());
+        pending.pop_back();
+        if (!builder.ReadDirectory(next.path, next.entry)) tree.unreadable++;
+    }
+
+    tree.success = true;
+    return tree;
+}
@@ -0,0 +1,49 @@
+/**
+ * Directory Tree Enumeration
+ *
+ * Lists a whole folder tree with metadata in one pass. Each directory is
+ * opened once and drained with GetFileInformationByHandleEx(
+ * FileIdBothDirectoryInfo) into a 64 KB buffer, which returns size,
+ * times, attributes and the NTFS file ID alongside every name - no
+ * per-file stat. File systems that reject the handle-based query fall back
+ * to FindFirstFileExW(FindExInfoBasic, FIND_FIRST_EX_LARGE_FETCH), without
+ * file IDs.
+ *
+ * Entries are stored flat, parents before children, with names in one
+ * UTF-8 blob, so the bindings can hand the result to JS as columns.
+ * Reparse points (junctions, symlinks) are listed but not followed.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct TreeEntry {
+    uint32_t parent;      // index of the containing directory, kTreeRoot at the top
+    uint32_t nameOffset;  // into DirectoryTree::names
+    uint32_t nameLength;
+    uint32_t attributes;  // FILE_ATTRIBUTE_*
+    uint64_t size;
+    int64_t lastWriteTime;  // FILETIME ticks
+    uint64_t fileId;        // 0 when the file system did not report one
+};
+
+struct DirectoryTree {
+    static const uint32_t kTreeRoot = 0xFFFFFFFF;
+
+    bool success = false;
+    std::string error;
+    std::vector<TreeEntry> entries;
+    std::string names;          // UTF-8, not separated
+    uint32_t unreadable = 0;    // subdirectories that could not be opened
+    bool truncated = false;     // stopped at maxEntries
+};
+
+struct TreeOptions {
+    bool skipHidden = true;   // names starting with '.' and FILE_ATTRIBUTE_HIDDEN
+    uint32_t maxEntries = 0;  // 0 = no limit
+};
+
+DirectoryTree EnumerateTree(const std::wstring& root, const TreeOptions& options);
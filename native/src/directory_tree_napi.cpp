@@ -0,0 +1,179 @@
+/**
+ * Directory Tree Bindings
+ *
+ * enumerateTree(root, { skipHidden, want, maxEntries }) -> Promise<DirectoryTree>
+ *
+ * The tree is walked on the shared worker pool and comes back as columns
+ * rather than one object per entry: every column is a typed-array view
+ * into a single ArrayBuffer (`buffer`, transferable as one piece).
+ *
+ *   parents      Uint32Array    containing directory's index, 0xFFFFFFFF at the root
+ *   nameOffsets  Uint32Array    count + 1 byte offsets into `names`
+ *   names        Uint8Array     UTF-8, entry i is names[nameOffsets[i], nameOffsets[i + 1])
+ *   kinds        Uint8Array     1 = directory, 0 = file
+ *   size         Float64Array   bytes                       (want 'size')
+ *   mtime        Float64Array   ms since the Unix epoch     (want 'mtime')
+ *   attrs        Uint32Array    FILE_ATTRIBUTE_*            (want 'attrs')
+ *   fileId       BigUint64Array NTFS file ID, 0n if unknown (want 'fileId')
+ *
+ * Parents always precede their children.
+ */
+
+#include "addon.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "directory_tree.h"
+#include "native_stats.h"
+#include "thread_pool.h"
+
+enum TreeColumn : uint32_t {
+    kColumnSize = 1u << 0,
+    kColumnMtime = 1u << 1,
+    kColumnAttrs = 1u << 2,
+    kColumnFileId = 1u << 3,
+};
+
+struct TreeRequest {
+    std::wstring root;
+    TreeOptions options;
+    uint32_t columns = kColumnSize | kColumnMtime;
+    DirectoryTree tree;
+};
+
+// Columns packed back to back; each section starts on an 8-byte boundary
+// so every typed array can view it in place
+class ColumnWriter {
+public:
+    template <typename T>
+    size_t Reserve(size_t count) {
+        size_t offset = (m_bytes.size() + 7) & ~static_cast<size_t>(7);
+        m_bytes.resize(offset + count * sizeof(T));
+        return offset;
+    }
+
+    template <typename T>
+    T* At(size_t offset) { return reinterpret_cast<T*>(m_bytes.data() + offset); }
+
+    std::vector<uint8_t>& Bytes() { return m_bytes; }
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+template <typename T>
+static void SetColumn(Napi::Env env, Napi::Object result, const char* name, Napi::ArrayBuffer buffer,
+    size_t base, size_t offset, size_t count) {
+    result.Set(name, Napi::TypedArrayOf<T>::New(env, count, buffer, base + offset));
+}
+
+static Napi::Value BuildTree(Napi::Env env, TreeRequest* request) {
+    DirectoryTree& tree = request->tree;
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, tree.success));
+    if (!tree.success) {
+        result.Set("error", Napi::String::New(env, tree.error));
+        return result;
+    }
+
+    size_t count = tree.entries.size();
+    uint32_t columns = request->columns;
+    ColumnWriter writer;
+
+    size_t parents = writer.Reserve<uint32_t>(count);
+    size_t nameOffsets = writer.Reserve<uint32_t>(count + 1);
+    size_t kinds = writer.Reserve<uint8_t>(count);
+    size_t sizes = (columns & kColumnSize) ? writer.Reserve<double>(count) : 0;
+    size_t mtimes = (columns & kColumnMtime) ? writer.Reserve<double>(count) : 0;
+    size_t attrs = (columns & kColumnAttrs) ? writer.Reserve<uint32_t>(count) : 0;
+    size_t fileIds = (columns & kColumnFileId) ? writer.Reserve<uint64_t>(count) : 0;
+    size_t names = writer.Reserve<uint8_t>(tree.names.size());
+
+    for (size_t i = 0; i < count; i++) {
+        const TreeEntry& entry = tree.entries[i];
+        writer.At<uint32_t>(parents)[i] = entry.parent;
+        writer.At<uint32_t>(nameOffsets)[i] = entry.nameOffset;
+        writer.At<uint8_t>(kinds)[i] = (entry.attributes & FILE_ATTRIBUTE_DIRECTORY) ? 1 : 0;
+        if (columns & kColumnSize) writer.At<double>(sizes)[i] = static_cast<double>(entry.size);
+        if (columns & kColumnMtime) {
+            writer.At<double>(mtimes)[i] = FiletimeToEpochMs(entry.lastWriteTime);
+        }
+        if (columns & kColumnAttrs) writer.At<uint32_t>(attrs)[i] = entry.attributes;
+        if (columns & kColumnFileId) writer.At<uint64_t>(fileIds)[i] = entry.fileId;
+    }
+    writer.At<uint32_t>(nameOffsets)[count] = static_cast<uint32_t>(tree.names.size());
+    if (!tree.names.empty()) memcpy(writer.At<uint8_t>(names), tree.names.data(), tree.names.size());
+
+    Napi::Buffer<uint8_t> packed = TakeBuffer(env, std::move(writer.Bytes()));
+    Napi::ArrayBuffer buffer = packed.ArrayBuffer();
+    size_t base = packed.ByteOffset();
+
+    result.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+    result.Set("truncated", Napi::Boolean::New(env, tree.truncated));
+    result.Set("unreadable", Napi::Number::New(env, tree.unreadable));
+    result.Set("buffer", buffer);
+    SetColumn<uint32_t>(env, result, "parents", buffer, base, parents, count);
+    SetColumn<uint32_t>(env, result, "nameOffsets", buffer, base, nameOffsets, count + 1);
+    SetColumn<uint8_t>(env, result, "names", buffer, base, names, tree.names.size());
+    SetColumn<uint8_t>(env, result, "kinds", buffer, base, kinds, count);
+    if (columns & kColumnSize) SetColumn<double>(env, result, "size", buffer, base, sizes, count);
+    if (columns & kColumnMtime) SetColumn<double>(env, result, "mtime", buffer, base, mtimes, count);
+    if (columns & kColumnAttrs) SetColumn<uint32_t>(env, result, "attrs", buffer, base, attrs, count);
+    if (columns & kColumnFileId) SetColumn<uint64_t>(env, result, "fileId", buffer, base, fileIds, count);
+    return result;
+}
+
+// enumerateTree(root: string, options?: { skipHidden?: boolean, want?: string[], maxEntries?: number })
+static Napi::Value EnumerateTreeJs(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto request = std::make_shared<TreeRequest>();
+    if (!ReadArgs(info, "Root directory expected", &request->root)) return env.Null();
+
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        Napi::Value skipHidden = options.Get("skipHidden");
+        if (skipHidden.IsBoolean()) request->options.skipHidden = skipHidden.As<Napi::Boolean>().Value();
+        Napi::Value maxEntries = options.Get("maxEntries");
+        if (maxEntries.IsNumber()) request->options.maxEntries = maxEntries.As<Napi::Number>().Uint32Value();
+
+        Napi::Value want = options.Get("want");
+        if (want.IsArray()) {
+            Napi::Array fields = want.As<Napi::Array>();
+            request->columns = 0;
+            for (uint32_t i = 0; i < fields.Length(); i++) {
+                Napi::Value field = fields.Get(i);
+                std::string name = field.IsString() ? field.As<Napi::String>().Utf8Value() : "";
+                if (name == "size") request->columns |= kColumnSize;
+                else if (name == "mtime") request->columns |= kColumnMtime;
+                else if (name == "attrs") request->columns |= kColumnAttrs;
+                else if (name == "fileId") request->columns |= kColumnFileId;
+                else {
+                    Napi::TypeError::New(env, "Unknown field in want: " + name).ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+            }
+        }
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "enumerateTree");
+    Napi::Promise promise = completion->Promise();
+
+    ThreadPool::Shared().Submit([request, completion]() {
+        int64_t started = NativeStats::Now();
+        request->tree = EnumerateTree(request->root, request->options);
+        NativeStats::Record(NativeOp::EnumerateTree, started);
+        completion->Resolve([request](Napi::Env env) {
+            return BuildTree(env, request.get());
+        });
+    });
+
+    return promise;
+}
+
+void InitDirectoryTreeBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("enumerateTree", Napi::Function::New(env, EnumerateTreeJs));
+}
@@ -0,0 +1,504 @@
+/**
+ * Directory Watcher
+ */
+
+#include "directory_watcher.h"
+
+#include <windows.h>
+#include <algorithm>
+#include <cstring>
+
+// The SMB redirector caps change notifications at 64 KB
+static const DWORD kNotifyBufferSize = 64 * 1024;
+
+// Distinct paths held between deliveries before collapsing to an overflow
+static const size_t kMaxPending = 4096;
+
+// Continuous churn still delivers after this many debounce intervals
+static const uint64_t kMaxLatencyIntervals = 4;
+
+static const DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+    FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+// Completion keys: reads carry the watch's OVERLAPPED, start packets the new
+// watch and stop packets its ID (it may already have closed itself)
+static const ULONG_PTR kReadKey = 0;
+static const ULONG_PTR kStartKey = 1;
+static const ULONG_PTR kStopKey = 2;
+static const ULONG_PTR kShutdownKey = 3;
+
+// FILE_NOTIFY_EXTENDED_INFORMATION and ReadDirectoryChangesExW are Windows
+// 10 1709+ and only declared for matching NTDDI targets, so both are
+// mirrored here and the function is resolved at runtime
+struct NotifyExtendedInformation {
+    DWORD NextEntryOffset;
+    DWORD Action;
+    LARGE_INTEGER CreationTime;
+    LARGE_INTEGER LastModificationTime;
+    LARGE_INTEGER LastChangeTime;
+    LARGE_INTEGER LastAccessTime;
+    LARGE_INTEGER AllocatedLength;
+    LARGE_INTEGER FileSize;
+    DWORD FileAttributes;
+    DWORD ReparsePointTag;
+    LARGE_INTEGER FileId;
+    LARGE_INTEGER ParentFileId;
+    DWORD FileNameLength;
+    WCHAR FileName[1];
+};
+
+static const int kReadDirectoryNotifyExtendedInformation = 2;
+
+using ReadDirectoryChangesExFn = BOOL(WINAPI*)(HANDLE, LPVOID, DWORD, BOOL, DWORD, LPDWORD,
+    LPOVERLAPPED, LPOVERLAPPED_COMPLETION_ROUTINE, int);
+
+static ReadDirectoryChangesExFn ResolveReadDirectoryChangesEx() {
+    HMODULE kernel = GetModuleHandleW(L"kernel32.dll");
+    return kernel ? reinterpret_cast<ReadDirectoryChangesExFn>(GetProcAddress(kernel, "ReadDirectoryChangesExW"))
+                  : nullptr;
+}
+
+static ReadDirectoryChangesExFn ReadChangesEx() {
+    static const ReadDirectoryChangesExFn readChangesEx = ResolveReadDirectoryChangesEx();
+    return readChangesEx;
+}
+
+// How a volume that has ReadDirectoryChangesExW but not extended
+// information (FAT, many SMB redirectors) turns the request down, either
+// when it is issued or as its completion
+static bool IsExtendedUnsupported(DWORD error) {
+    return error == ERROR_INVALID_FUNCTION || error == ERROR_INVALID_PARAMETER || error == ERROR_NOT_SUPPORTED;
+}
+
+struct PendingEvent {
+    WatchEvent event;
+    bool live = true;  // false once coalesced away
+};
+
+struct DirectoryWatcher::WatchState {
+    OVERLAPPED overlapped = {};  // first member: completions hand it back
+    uint32_t id = 0;
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    WatchOptions options;
+    BatchCallback onBatch;
+    ClosedCallback onClosed;
+    std::vector<uint64_t> buffer;  // DWORD-aligned notification buffer
+    bool reading = false;
+    bool closing = false;
+    bool extended = false;  // FILE_NOTIFY_EXTENDED_INFORMATION; cleared if the volume refuses it
+
+    std::vector<PendingEvent> pending;
+    std::unordered_map<std::string, size_t> pendingByPath;
+    bool overflowed = false;
+    uint64_t firstEventMs = 0;
+    uint64_t lastEventMs = 0;
+
+    // Old half of a rename, waiting for its new name
+    bool renamePending = false;
+    bool renameIgnored = false;
+    WatchEvent renameFrom;
+
+    bool HasPending() const { return overflowed || !pending.empty(); }
+
+    uint64_t Deadline() const {
+        uint64_t debounce = options.debounceMs;
+        return std::min(lastEventMs + debounce, firstEventMs + debounce * kMaxLatencyIntervals);
+    }
+};
+
+static std::string RelativeUtf8(const wchar_t* name, size_t length) {
+    int size = WideCharToMultiByte(CP_UTF8, 0, name, static_cast<int>(length), nullptr, 0, nullptr, nullptr);
+    std::string utf8(size > 0 ? size : 0, '\0');
+    if (size > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, name, static_cast<int>(length), &utf8[0], size, nullptr, nullptr);
+    }
+    std::replace(utf8.begin(), utf8.end(), '\\', '/');
+    return utf8;
+}
+
+static bool EndsWithNoCase(const std::string& value, const char* suffix) {
+    size_t length = strlen(suffix);
+    if (value.size() < length) return false;
+    return _strnicmp(value.c_str() + value.size() - length, suffix, length) == 0;
+}
+
+// Same exclusions as the chokidar watcher this replaces
+static bool IsIgnored(const std::string& path, const WatchOptions& options) {
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) end = path.size();
+        std::string component = path.substr(start, end - start);
+
+        if (options.skipHidden && !component.empty() && component[0] == '.') return true;
+        if (options.skipTemp) {
+            if (component.compare(0, 2, "~$") == 0) return true;
+            if (_stricmp(component.c_str(), "desktop.ini") == 0) return true;
+            if (_stricmp(component.c_str(), "thumbs.db") == 0) return true;
+            if (_stricmp(component.c_str(), "$RECYCLE.BIN") == 0) return true;
+            if (_stricmp(component.c_str(), "System Volume Information") == 0) return true;
+            if (_stricmp(component.c_str(), "node_modules") == 0) return true;
+        }
+        start = end + 1;
+    }
+    return options.skipTemp &&
+        (EndsWithNoCase(path, ".tmp") || EndsWithNoCase(path, ".swp") || EndsWithNoCase(path, ".download"));
+}
+
+DirectoryWatcher& DirectoryWatcher::Shared() {
+    static DirectoryWatcher watcher;
+    return watcher;
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    Shutdown();
+}
+
+bool DirectoryWatcher::EnsureStarted() {
+    // Caller holds m_mutex
+    if (m_port) return true;
+    m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!m_port) return false;
+    m_thread = std::thread(&DirectoryWatcher::ThreadLoop, this);
+    return true;
+}
+
+uint32_t DirectoryWatcher::Watch(const std::wstring& root, const WatchOptions& options,
+    BatchCallback onBatch, ClosedCallback onClosed, std::string* error) {
+    HANDLE directory = CreateFileW(root.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (directory == INVALID_HANDLE_VALUE) {
+        DWORD lastError = GetLastError();
+        *error = lastError == ERROR_FILE_NOT_FOUND || lastError == ERROR_PATH_NOT_FOUND
+            ? "Directory not found" : "Could not open directory";
+        return 0;
+    }
+
+    auto* watch = new WatchState();
+    watch->directory = directory;
+    watch->options = options;
+    watch->onBatch = std::move(onBatch);
+    watch->onClosed = std::move(onClosed);
+    watch->buffer.resize(kNotifyBufferSize / sizeof(uint64_t));
+    watch->extended = ReadChangesEx() != nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopping || !EnsureStarted() || !CreateIoCompletionPort(directory, m_port, kReadKey, 0)) {
+        CloseHandle(directory);
+        delete watch;
+        *error = "Could not start watcher";
+        return 0;
+    }
+
+    watch->id = m_nextId++;
+    m_watches[watch->id] = watch;
+    // The watcher thread owns the watch from here on
+    PostQueuedCompletionStatus(m_port, 0, kStartKey, reinterpret_cast<LPOVERLAPPED>(watch));
+    return watch->id;
+}
+
+bool DirectoryWatcher::Unwatch(uint32_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_watches.count(id)) return false;
+    PostQueuedCompletionStatus(m_port, 0, kStopKey, reinterpret_cast<LPOVERLAPPED>(static_cast<uintptr_t>(id)));
+    return true;
+}
+
+void DirectoryWatcher::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_stopping = true;
+        if (!m_port) return;
+        PostQueuedCompletionStatus(m_port, 0, kShutdownKey, nullptr);
+    }
+    if (m_thread.joinable()) m_thread.join();
+    CloseHandle(m_port);
+    m_port = nullptr;
+}
+
+void DirectoryWatcher::ThreadLoop() {
+    bool shuttingDown = false;
+    for (;;) {
+        if (shuttingDown && m_active.empty()) return;
+
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = nullptr;
+        BOOL ok = GetQueuedCompletionStatus(m_port, &bytes, &key, &overlapped, FlushDue());
+        DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+
+        if (!overlapped) {
+            if (key == kShutdownKey && ok) {
+                shuttingDown = true;
+                std::vector<WatchState*> active = m_active;
+                for (WatchState* watch : active) Stop(watch);
+                continue;
+            }
+            if (error == WAIT_TIMEOUT) continue;
+            return;
+        }
+
+        if (key == kStartKey) {
+            auto* watch = reinterpret_cast<WatchState*>(overlapped);
+            m_active.push_back(watch);
+            if (shuttingDown) Stop(watch);
+            else IssueRead(watch);
+            continue;
+        }
+        if (key == kStopKey) {
+            auto id = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(overlapped));
+            auto found = std::find_if(m_active.begin(), m_active.end(),
+                [id](WatchState* watch) { return watch->id == id; });
+            if (found != m_active.end()) Stop(*found);
+            continue;
+        }
+
+        WatchState* watch = CONTAINING_RECORD(overlapped, WatchState, overlapped);
+        watch->reading = false;
+        if (watch->closing) {
+            Close(watch);
+        } else if (!ok && watch->extended && IsExtendedUnsupported(error)) {
+            // Refused on completion rather than when issued: the same fallback
+            watch->extended = false;
+            IssueRead(watch);
+        } else if (!ok && error != ERROR_NOTIFY_ENUM_DIR) {
+            // Typically the watched directory itself was deleted or renamed
+            WatchEvent event;
+            event.type = WatchEventType::Error;
+            Flush(watch);
+            watch->onBatch({ event });
+            Close(watch);
+        } else {
+            if (!ok || bytes == 0) {
+                // The kernel buffer overflowed: individual events are lost
+                watch->overflowed = true;
+                watch->lastEventMs = GetTickCount64();
+                if (watch->firstEventMs == 0) watch->firstEventMs = watch->lastEventMs;
+            } else {
+                OnNotification(watch, bytes);
+            }
+            IssueRead(watch);
+        }
+    }
+}
+
+void DirectoryWatcher::IssueRead(WatchState* watch) {
+    BOOL ok = FALSE;
+    if (watch->extended) {
+        ZeroMemory(&watch->overlapped, sizeof(watch->overlapped));
+        ok = ReadChangesEx()(watch->directory, watch->buffer.data(), kNotifyBufferSize, watch->options.recursive,
+            kNotifyFilter, nullptr, &watch->overlapped, nullptr, kReadDirectoryNotifyExtendedInformation);
+        // Plain notifications for this watch from now on: names only
+        if (!ok && IsExtendedUnsupported(GetLastError())) watch->extended = false;
+    }
+    if (!watch->extended) {
+        ZeroMemory(&watch->overlapped, sizeof(watch->overlapped));
+        ok = ReadDirectoryChangesW(watch->directory, watch->buffer.data(), kNotifyBufferSize,
+            watch->options.recursive, kNotifyFilter, nullptr, &watch->overlapped, nullptr);
+    }
+    if (ok) {
+        watch->reading = true;
+        return;
+    }
+
+    WatchEvent event;
+    event.type = WatchEventType::Error;
+    Flush(watch);
+    watch->onBatch({ event });
+    Close(watch);
+}
+
+void DirectoryWatcher::OnNotification(WatchState* watch, unsigned long bytes) {
+    auto* cursor = reinterpret_cast<const uint8_t*>(watch->buffer.data());
+    auto* end = cursor + bytes;
+
+    while (cursor < end) {
+        WatchEvent event;
+        DWORD action;
+        DWORD next;
+        if (watch->extended) {
+            auto* info = reinterpret_cast<const NotifyExtendedInformation*>(cursor);
+            action = info->Action;
+            next = info->NextEntryOffset;
+            event.path = RelativeUtf8(info->FileName, info->FileNameLength / sizeof(wchar_t));
+            event.isDirectory = (info->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+            event.size = event.isDirectory ? 0 : static_cast<uint64_t>(info->FileSize.QuadPart);
+            event.lastWriteTime = info->LastModificationTime.QuadPart;
+            event.fileId = static_cast<uint64_t>(info->FileId.QuadPart);
+        } else {
+            auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+            action = info->Action;
+            next = info->NextEntryOffset;
+            event.path = RelativeUtf8(info->FileName, info->FileNameLength / sizeof(wchar_t));
+        }
+
+        bool ignored = IsIgnored(event.path, watch->options);
+        switch (action) {
+            case FILE_ACTION_ADDED:
+                event.type = WatchEventType::Added;
+                if (!ignored) Record(watch, std::move(event));
+                break;
+            case FILE_ACTION_REMOVED:
+                event.type = WatchEventType::Removed;
+                event.lastWriteTime = 0;
+                if (!ignored) Record(watch, std::move(event));
+                break;
+            case FILE_ACTION_MODIFIED:
+                // A directory "changes" whenever a child does; the child's own
+                // event is the useful one
+                event.type = WatchEventType::Modified;
+                if (!ignored && !event.isDirectory) Record(watch, std::move(event));
+                break;
+            case FILE_ACTION_RENAMED_OLD_NAME:
+                watch->renamePending = true;
+                watch->renameIgnored = ignored;
+                watch->renameFrom = std::move(event);
+                break;
+            case FILE_ACTION_RENAMED_NEW_NAME:
+                if (watch->renamePending && !watch->renameIgnored && !ignored) {
+                    event.type = WatchEventType::Renamed;
+                    event.oldPath = watch->renameFrom.path;
+                    Record(watch, std::move(event));
+                } else if (watch->renamePending && !watch->renameIgnored) {
+                    // Renamed to something ignored: gone as far as callers care
+                    watch->renameFrom.type = WatchEventType::Removed;
+                    Record(watch, std::move(watch->renameFrom));
+                } else if (!ignored) {
+                    // Save-via-temp-file: the real name appears
+                    event.type = WatchEventType::Added;
+                    Record(watch, std::move(event));
+                }
+                watch->renamePending = false;
+                break;
+        }
+
+        if (next == 0) break;
+        cursor += next;
+    }
+}
+
+void DirectoryWatcher::Record(WatchState* watch, WatchEvent&& event) {
+    watch->lastEventMs = GetTickCount64();
+    if (!watch->HasPending()) watch->firstEventMs = watch->lastEventMs;
+    if (watch->overflowed) return;
+
+    // A rename touching paths that already have events is settled as a
+    // removal of the old path plus an addition of the new one
+    if (event.type == WatchEventType::Renamed &&
+        (watch->pendingByPath.count(event.path) || watch->pendingByPath.count(event.oldPath))) {
+        WatchEvent removed;
+        removed.type = WatchEventType::Removed;
+        removed.path = std::move(event.oldPath);
+        removed.isDirectory = event.isDirectory;
+        event.type = WatchEventType::Added;
+        event.oldPath.clear();
+        Record(watch, std::move(removed));
+        Record(watch, std::move(event));
+        return;
+    }
+
+    auto found = watch->pendingByPath.find(event.path);
+    if (found == watch->pendingByPath.end()) {
+        if (watch->pendingByPath.size() >= kMaxPending) {
+            // Bounded memory: give up on detail and ask for a rescan
+            watch->overflowed = true;
+            watch->pending.clear();
+            watch->pendingByPath.clear();
+            return;
+        }
+        watch->pendingByPath.emplace(event.path, watch->pending.size());
+        watch->pending.push_back({ std::move(event), true });
+        return;
+    }
+
+    PendingEvent& existing = watch->pending[found->second];
+    if (!existing.live) {
+        existing.event = std::move(event);
+        existing.live = true;
+        return;
+    }
+
+    WatchEventType before = existing.event.type;
+    WatchEventType after = event.type;
+    if (before == WatchEventType::Added && after == WatchEventType::Removed) {
+        existing.live = false;
+    } else if ((before == WatchEventType::Added || before == WatchEventType::Renamed) &&
+               after == WatchEventType::Modified) {
+        // Still new (or still renamed); only the metadata moves on
+        event.type = before;
+        event.oldPath = std::move(existing.event.oldPath);
+        existing.event = std::move(event);
+    } else if (before == WatchEventType::Removed && after == WatchEventType::Added) {
+        event.type = WatchEventType::Modified;
+        existing.event = std::move(event);
+    } else if (before == WatchEventType::Renamed && after == WatchEventType::Removed) {
+        // Renamed away and then deleted: the old path is what disappeared
+        event.path = existing.event.oldPath;
+        existing.live = false;
+        Record(watch, std::move(event));
+    } else {
+        existing.event = std::move(event);
+    }
+}
+
+void DirectoryWatcher::Flush(WatchState* watch) {
+    if (!watch->HasPending()) return;
+
+    std::vector<WatchEvent> events;
+    if (watch->overflowed) {
+        WatchEvent overflow;
+        overflow.type = WatchEventType::Overflow;
+        events.push_back(std::move(overflow));
+    } else {
+        events.reserve(watch->pending.size());
+        for (auto& pending : watch->pending) {
+            if (pending.live) events.push_back(std::move(pending.event));
+        }
+    }
+
+    watch->pending.clear();
+    watch->pendingByPath.clear();
+    watch->overflowed = false;
+    watch->firstEventMs = 0;
+    if (!events.empty()) watch->onBatch(std::move(events));
+}
+
+unsigned long DirectoryWatcher::FlushDue() {
+    uint64_t now = GetTickCount64();
+    uint64_t wait = INFINITE;
+    for (WatchState* watch : m_active) {
+        if (!watch->HasPending()) continue;
+        uint64_t deadline = watch->Deadline();
+        if (deadline <= now) {
+            Flush(watch);
+        } else {
+            wait = std::min<uint64_t>(wait, deadline - now);
+        }
+    }
+    return static_cast<unsigned long>(wait);
+}
+
+void DirectoryWatcher::Stop(WatchState* watch) {
+    if (watch->closing) return;
+    watch->closing = true;
+    Flush(watch);
+    // Close once the cancelled read comes back, never under it
+    if (watch->reading) {
+        CancelIoEx(watch->directory, &watch->overlapped);
+    } else {
+        Close(watch);
+    }
+}
+
+void DirectoryWatcher::Close(WatchState* watch) {
+    CloseHandle(watch->directory);
+    m_active.erase(std::remove(m_active.begin(), m_active.end(), watch), m_active.end());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_watches.erase(watch->id);
+    }
+    watch->onClosed();
+    delete watch;
+}
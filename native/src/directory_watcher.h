@@ -0,0 +1,93 @@
+/**
+ * Directory Watcher
+ *
+ * Recursive change notifications for whole vaults without per-file state.
+ * Every watch is one directory handle with a single overlapped
+ * ReadDirectoryChangesExW (extended information: file ID, size, times)
+ * outstanding, and all watches complete on one I/O completion port
+ * drained by one thread. A watch on a volume that refuses extended
+ * information (FAT, many SMB shares) falls back to ReadDirectoryChangesW,
+ * whose events carry names only.
+ *
+ * Events are coalesced per path on that thread (added + modified is added,
+ * added + removed is nothing, old + new name is one rename) and delivered
+ * once a watch has been quiet for its debounce interval, or at the latest
+ * after four intervals of continuous churn. Memory is bounded by the
+ * number of distinct paths touched between deliveries; past kMaxPending
+ * they are dropped for a single overflow event, as is a kernel buffer
+ * overflow - the caller rescans.
+ *
+ * N-API free; callbacks run on the watcher thread.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class WatchEventType { Added, Removed, Modified, Renamed, Overflow, Error };
+
+struct WatchEvent {
+    WatchEventType type = WatchEventType::Modified;
+    std::string path;     // relative to the watch root, '/'-separated, UTF-8
+    std::string oldPath;  // Renamed only
+    bool isDirectory = false;
+    uint64_t size = 0;
+    int64_t lastWriteTime = 0;  // FILETIME ticks, 0 for removals
+    uint64_t fileId = 0;
+};
+
+struct WatchOptions {
+    bool recursive = true;
+    uint32_t debounceMs = 200;
+    bool skipHidden = true;  // any path component starting with '.'
+    bool skipTemp = true;    // ~$ lock files, *.tmp / *.swp / *.download, desktop.ini, thumbs.db
+};
+
+class DirectoryWatcher {
+public:
+    using BatchCallback = std::function<void(std::vector<WatchEvent>&& events)>;
+    // Runs once after the last batch; the watch is gone
+    using ClosedCallback = std::function<void()>;
+
+    static DirectoryWatcher& Shared();
+
+    // Returns a watch ID, or 0 with *error set
+    uint32_t Watch(const std::wstring& root, const WatchOptions& options,
+        BatchCallback onBatch, ClosedCallback onClosed, std::string* error);
+
+    // Pending events are delivered first. False if the ID is unknown.
+    bool Unwatch(uint32_t id);
+
+    // Close every watch and join the thread
+    void Shutdown();
+
+private:
+    struct WatchState;
+
+    DirectoryWatcher() = default;
+    ~DirectoryWatcher();
+
+    bool EnsureStarted();
+    void ThreadLoop();
+    void IssueRead(WatchState* watch);
+    void OnNotification(WatchState* watch, unsigned long bytes);
+    void Record(WatchState* watch, WatchEvent&& event);
+    void Flush(WatchState* watch);
+    void Stop(WatchState* watch);
+    void Close(WatchState* watch);
+    unsigned long FlushDue();
+
+    std::mutex m_mutex;
+    void* m_port = nullptr;
+    std::thread m_thread;
+    uint32_t m_nextId = 1;
+    std::unordered_map<uint32_t, WatchState*> m_watches;  // guarded by m_mutex
+    std::vector<WatchState*> m_active;                     // watcher thread only
+    bool m_stopping = false;
+};
@@ -0,0 +1,127 @@
+/**
+ * Directory Watcher Bindings
+ *
+ * watchDirectory(root, { recursive, debounceMs, skipHidden, skipTemp }, onEvents) -> { success, id }
+ * unwatchDirectory(id) -> boolean
+ *
+ * Each watch owns one ThreadSafeFunction over onEvents; the watcher thread
+ * hands it whole debounced batches, never single events. The function is
+ * released once the watch closes, so an active watch keeps the event loop
+ * alive the way fs.watch does.
+ */
+
+#include "addon.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "directory_watcher.h"
+
+static const uint32_t kMinDebounceMs = 10;
+static const uint32_t kMaxDebounceMs = 60000;
+
+static const char* EventTypeName(WatchEventType type) {
+    switch (type) {
+        case WatchEventType::Added: return "added";
+        case WatchEventType::Removed: return "removed";
+        case WatchEventType::Renamed: return "renamed";
+        case WatchEventType::Overflow: return "overflow";
+        case WatchEventType::Error: return "error";
+        default: return "modified";
+    }
+}
+
+static Napi::Array BuildWatchEvents(Napi::Env env, const std::vector<WatchEvent>& events) {
+    Napi::Array array = Napi::Array::New(env, events.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        const WatchEvent& event = events[i];
+        Napi::Object object = Napi::Object::New(env);
+        object.Set("type", Napi::String::New(env, EventTypeName(event.type)));
+        if (event.type != WatchEventType::Overflow && event.type != WatchEventType::Error) {
+            object.Set("path", Napi::String::New(env, event.path));
+            if (event.type == WatchEventType::Renamed) {
+                object.Set("oldPath", Napi::String::New(env, event.oldPath));
+            }
+            object.Set("isDirectory", Napi::Boolean::New(env, event.isDirectory));
+            object.Set("size", Napi::Number::New(env, static_cast<double>(event.size)));
+            if (event.lastWriteTime > 0) {
+                object.Set("mtime", Napi::Number::New(env, FiletimeToEpochMs(event.lastWriteTime)));
+            }
+            if (event.fileId) object.Set("fileId", Napi::BigInt::New(env, event.fileId));
+        }
+        array.Set(static_cast<uint32_t>(i), object);
+    }
+    return array;
+}
+
+// watchDirectory(root: string, options?: { recursive?, debounceMs?, skipHidden?, skipTemp? },
+//                onEvents: (events) => void)
+static Napi::Value WatchDirectory(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsString() || !info[2].IsFunction()) {
+        Napi::TypeError::New(env, "Directory and event callback expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    WatchOptions options;
+    if (info[1].IsObject()) {
+        Napi::Object object = info[1].As<Napi::Object>();
+        Napi::Value value = object.Get("recursive");
+        if (value.IsBoolean()) options.recursive = value.As<Napi::Boolean>().Value();
+        value = object.Get("debounceMs");
+        if (value.IsNumber()) {
+            options.debounceMs = std::clamp<uint32_t>(value.As<Napi::Number>().Uint32Value(),
+                kMinDebounceMs, kMaxDebounceMs);
+        }
+        value = object.Get("skipHidden");
+        if (value.IsBoolean()) options.skipHidden = value.As<Napi::Boolean>().Value();
+        value = object.Get("skipTemp");
+        if (value.IsBoolean()) options.skipTemp = value.As<Napi::Boolean>().Value();
+    }
+
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, info[2].As<Napi::Function>(), "watchDirectory", 0, 1);
+
+    std::string error;
+    uint32_t id = DirectoryWatcher::Shared().Watch(
+        JsToWide(info[0]), options,
+        [tsfn](std::vector<WatchEvent>&& events) mutable {
+            auto* batch = new std::vector<WatchEvent>(std::move(events));
+            napi_status status = tsfn.BlockingCall(batch,
+                [](Napi::Env env, Napi::Function callback, std::vector<WatchEvent>* batch) {
+                    if (env != nullptr) callback.Call({ BuildWatchEvents(env, *batch) });
+                    delete batch;
+                });
+            if (status != napi_ok) delete batch;
+        },
+        [tsfn]() mutable {
+            tsfn.Release();
+        },
+        &error);
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("success", Napi::Boolean::New(env, id != 0));
+    if (id != 0) {
+        result.Set("id", Napi::Number::New(env, id));
+    } else {
+        tsfn.Release();
+        result.Set("error", Napi::String::New(env, error));
+    }
+    return result;
+}
+
+static Napi::Value UnwatchDirectory(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Watch ID expected").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return Napi::Boolean::New(env, DirectoryWatcher::Shared().Unwatch(info[0].As<Napi::Number>().Uint32Value()));
+}
+
+void InitDirectoryWatcherBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("watchDirectory", Napi::Function::New(env, WatchDirectory));
+    exports.Set("unwatchDirectory", Napi::Function::New(env, UnwatchDirectory));
+}
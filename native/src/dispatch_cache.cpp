@@ -0,0 +1,321 @@
+/**
+ * Dispatch Cache
+ *
+ * The eDrawings control is a dual interface, so the type info it returns
+ * from IDispatch::GetTypeInfo describes every member up front. One walk of
+ * that type info replaces a GetIDsOfNames round trip on every call.
+ */
+
+#include "dispatch_cache.h"
+
+#include <memory>
+
+#include "native_stats.h"
+
+static std::wstring LowerName(const wchar_t* name, UINT length) {
+    std::wstring lowered(name, length);
+    if (!lowered.empty()) {
+        CharLowerBuffW(&lowered[0], static_cast<DWORD>(lowered.size()));
+    }
+    return lowered;
+}
+
+DispatchValue DispatchValue::FromVariant(const VARIANT& variant) {
+    DispatchValue value;
+    VARIANT converted;
+    VariantInit(&converted);
+
+    switch (variant.vt) {
+        case VT_EMPTY:
+        case VT_NULL:
+            break;
+        case VT_BOOL:
+            value.kind = Kind::Bool;
+            value.boolValue = variant.boolVal != VARIANT_FALSE;
+            break;
+        case VT_BSTR:
+            value.kind = Kind::String;
+            if (variant.bstrVal) {
+                value.stringValue.assign(variant.bstrVal, SysStringLen(variant.bstrVal));
+            }
+            break;
+        case VT_I1: case VT_I2: case VT_I4: case VT_INT:
+        case VT_UI1: case VT_UI2:
+            if (SUCCEEDED(VariantChangeType(&converted, &variant, 0, VT_I4))) {
+                value.kind = Kind::Int;
+                value.intValue = converted.lVal;
+            }
+            break;
+        case VT_UI4: case VT_UINT: case VT_I8: case VT_UI8:
+        case VT_R4: case VT_R8: case VT_CY: case VT_DATE: case VT_DECIMAL:
+            if (SUCCEEDED(VariantChangeType(&converted, &variant, 0, VT_R8))) {
+                value.kind = Kind::Double;
+                value.doubleValue = converted.dblVal;
+            }
+            break;
+        default:
+            if (SUCCEEDED(VariantChangeType(&converted, &variant, 0, VT_BSTR)) && converted.bstrVal) {
+                value.kind = Kind::String;
+                value.stringValue.assign(converted.bstrVal, SysStringLen(converted.bstrVal));
+            }
+            break;
+    }
+
+    VariantClear(&converted);
+    return value;
+}
+
+DispatchCache& DispatchCache::ForClass(REFCLSID clsid) {
+    static std::mutex registryMutex;
+    static std::vector<std::pair<CLSID, std::unique_ptr<DispatchCache>>> registry;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& entry : registry) {
+        if (IsEqualCLSID(entry.first, clsid)) return *entry.second;
+    }
+    registry.emplace_back(clsid, std::unique_ptr<DispatchCache>(new DispatchCache()));
+    return *registry.back().second;
+}
+
+void DispatchCache::Populate(IDispatch* pDispatch) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_populated || !pDispatch) return;
+    m_populated = true;
+    ScopedNativeTimer timer(NativeOp::PopulateDispatch);
+
+    ITypeInfo* pTypeInfo = nullptr;
+    if (FAILED(pDispatch->GetTypeInfo(0, LOCALE_USER_DEFAULT, &pTypeInfo)) || !pTypeInfo) {
+        return;  // no type info: every lookup goes through GetIDsOfNames once
+    }
+
+    TYPEATTR* pAttr = nullptr;
+    if (FAILED(pTypeInfo->GetTypeAttr(&pAttr))) {
+        pTypeInfo->Release();
+        return;
+    }
+
+    // For a dual interface, walk the dispinterface half so memids are DISPIDs
+    if (pAttr->typekind == TKIND_INTERFACE && (pAttr->wTypeFlags & TYPEFLAG_FDUAL)) {
+        HREFTYPE hRef = 0;
+        ITypeInfo* pDispInfo = nullptr;
+        if (SUCCEEDED(pTypeInfo->GetRefTypeOfImplType(static_cast<UINT>(-1), &hRef)) &&
+            SUCCEEDED(pTypeInfo->GetRefTypeInfo(hRef, &pDispInfo))) {
+            pTypeInfo->ReleaseTypeAttr(pAttr);
+            pTypeInfo->Release();
+            pTypeInfo = pDispInfo;
+            if (FAILED(pTypeInfo->GetTypeAttr(&pAttr))) {
+                pTypeInfo->Release();
+                return;
+            }
+        }
+    }
+
+    for (UINT i = 0; i < pAttr->cFuncs; i++) {
+        FUNCDESC* pFunc = nullptr;
+        if (FAILED(pTypeInfo->GetFuncDesc(i, &pFunc))) continue;
+
+        BSTR name = nullptr;
+        if (SUCCEEDED(pTypeInfo->GetDocumentation(pFunc->memid, &name, nullptr, nullptr, nullptr)) && name) {
+            DispatchMember& member = m_members[LowerName(name, SysStringLen(name))];
+            member.dispid = pFunc->memid;
+            switch (pFunc->invkind) {
+                case INVOKE_FUNC: member.canCall = true; break;
+                case INVOKE_PROPERTYGET:
+                    member.canGet = true;
+                    member.getArgs = pFunc->cParams;
+                    break;
+                case INVOKE_PROPERTYPUT:
+                case INVOKE_PROPERTYPUTREF:
+                    member.canPut = true;
+                    member.putArgs = pFunc->cParams;
+                    break;
+            }
+            SysFreeString(name);
+        }
+        pTypeInfo->ReleaseFuncDesc(pFunc);
+    }
+
+    for (UINT i = 0; i < pAttr->cVars; i++) {
+        VARDESC* pVar = nullptr;
+        if (FAILED(pTypeInfo->GetVarDesc(i, &pVar))) continue;
+
+        BSTR name = nullptr;
+        if (SUCCEEDED(pTypeInfo->GetDocumentation(pVar->memid, &name, nullptr, nullptr, nullptr)) && name) {
+            DispatchMember& member = m_members[LowerName(name, SysStringLen(name))];
+            member.dispid = pVar->memid;
+            member.canGet = true;
+            member.canPut = !(pVar->wVarFlags & VARFLAG_FREADONLY);
+            member.getArgs = 0;
+            member.putArgs = 1;
+            SysFreeString(name);
+        }
+        pTypeInfo->ReleaseVarDesc(pVar);
+    }
+
+    pTypeInfo->ReleaseTypeAttr(pAttr);
+    pTypeInfo->Release();
+}
+
+bool DispatchCache::Lookup(IDispatch* pDispatch, const std::wstring& name, DispatchMember* member) {
+    std::wstring key = LowerName(name.c_str(), static_cast<UINT>(name.size()));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_members.find(key);
+    if (it == m_members.end()) {
+        // Not in the type info (late-bound member): ask once, remember the
+        // answer either way so misses don't repeat the round trip
+        DispatchMember resolved;
+        LPOLESTR names = const_cast<LPOLESTR>(name.c_str());
+        ScopedNativeTimer timer(NativeOp::GetIDsOfNames);
+        if (pDispatch && SUCCEEDED(pDispatch->GetIDsOfNames(IID_NULL, &names, 1,
+                LOCALE_USER_DEFAULT, &resolved.dispid))) {
+            resolved.canCall = resolved.canGet = resolved.canPut = true;
+        } else {
+            resolved.dispid = DISPID_UNKNOWN;
+        }
+        it = m_members.emplace(key, resolved).first;
+    }
+
+    if (it->second.dispid == DISPID_UNKNOWN) return false;
+    *member = it->second;
+    return true;
+}
+
+size_t DispatchCache::Size() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_members.size();
+}
+
+DispatchArgs::~DispatchArgs() {
+    for (auto& slot : m_slots) {
+        VariantClear(&slot);
+    }
+}
+
+bool DispatchArgs::FillString(VARIANTARG* slot, StringBuffer* buffer, const std::wstring& value) {
+    UINT length = static_cast<UINT>(value.size());
+    if (slot->vt == VT_BSTR && slot->bstrVal && slot->bstrVal == buffer->bstr && length <= buffer->capacity) {
+        // Fits: rewrite the characters and the BSTR's length prefix (the
+        // byte count stored just before them)
+        wmemcpy(slot->bstrVal, value.c_str(), length);
+        slot->bstrVal[length] = L'\0';
+        reinterpret_cast<UINT*>(slot->bstrVal)[-1] = length * sizeof(OLECHAR);
+        return true;
+    }
+
+    VariantClear(slot);
+    buffer->bstr = nullptr;
+    buffer->capacity = 0;
+    BSTR bstr = SysAllocStringLen(value.c_str(), length);
+    if (!bstr) return false;
+    slot->vt = VT_BSTR;
+    slot->bstrVal = bstr;
+    buffer->bstr = bstr;
+    buffer->capacity = length;
+    return true;
+}
+
+VARIANTARG* DispatchArgs::Fill(const std::vector<DispatchValue>& values) {
+    size_t count = values.size();
+
+    if (m_slots.size() > count) {
+        for (size_t i = count; i < m_slots.size(); i++) {
+            VariantClear(&m_slots[i]);
+        }
+    }
+    size_t oldSize = m_slots.size();
+    m_slots.resize(count);
+    m_strings.resize(count);
+    for (size_t i = oldSize; i < count; i++) {
+        VariantInit(&m_slots[i]);
+        m_strings[i] = StringBuffer();
+    }
+
+    // IDispatch expects arguments last-to-first
+    for (size_t i = 0; i < count; i++) {
+        const DispatchValue& value = values[count - 1 - i];
+        VARIANTARG& slot = m_slots[i];
+
+        if (value.kind == DispatchValue::Kind::String) {
+            FillString(&slot, &m_strings[i], value.stringValue);
+            continue;
+        }
+
+        VariantClear(&slot);
+        m_strings[i] = StringBuffer();
+        switch (value.kind) {
+            case DispatchValue::Kind::Bool:
+                slot.vt = VT_BOOL;
+                slot.boolVal = value.boolValue ? VARIANT_TRUE : VARIANT_FALSE;
+                break;
+            case DispatchValue::Kind::Int:
+                slot.vt = VT_I4;
+                slot.lVal = value.intValue;
+                break;
+            case DispatchValue::Kind::Double:
+                slot.vt = VT_R8;
+                slot.dblVal = value.doubleValue;
+                break;
+            default:
+                // Omitted optional parameter
+                slot.vt = VT_ERROR;
+                slot.scode = DISP_E_PARAMNOTFOUND;
+                break;
+        }
+    }
+
+    return m_slots.empty() ? nullptr : m_slots.data();
+}
+
+HRESULT InvokeCached(IDispatch* pDispatch, DispatchCache& cache, DispatchArgs& args,
+    const std::wstring& name, const std::vector<DispatchValue>& values,
+    DispatchValue* result) {
+
+    if (!pDispatch) return E_POINTER;
+
+    DispatchMember member;
+    if (!cache.Lookup(pDispatch, name, &member)) {
+        return DISP_E_UNKNOWNNAME;
+    }
+
+    DISPPARAMS params = {};
+    params.cArgs = static_cast<UINT>(values.size());
+    params.rgvarg = args.Fill(values);
+
+    // The type info says which of get and put takes this many arguments;
+    // without it, zero args read and one writes
+    int argCount = static_cast<int>(values.size());
+    bool isPut = member.canPut && !member.canCall &&
+        argCount == (member.putArgs >= 0 ? member.putArgs : 1);
+    bool isGet = !isPut && member.canGet && !member.canCall &&
+        (member.getArgs >= 0 ? argCount <= member.getArgs : argCount == 0);
+
+    DISPID putId = DISPID_PROPERTYPUT;
+    WORD flags = DISPATCH_METHOD;
+    if (isPut) {
+        flags = DISPATCH_PROPERTYPUT;
+        params.cNamedArgs = 1;
+        params.rgdispidNamedArgs = &putId;
+    } else if (isGet) {
+        flags = DISPATCH_PROPERTYGET;
+    } else if (member.canGet) {
+        flags = DISPATCH_METHOD | DISPATCH_PROPERTYGET;
+    }
+
+    VARIANT varResult;
+    VariantInit(&varResult);
+    EXCEPINFO excepInfo = {};
+
+    HRESULT hr = pDispatch->Invoke(member.dispid, IID_NULL, LOCALE_USER_DEFAULT, flags,
+        &params, isPut ? nullptr : &varResult, &excepInfo, nullptr);
+
+    if (SUCCEEDED(hr) && result) {
+        *result = DispatchValue::FromVariant(varResult);
+    }
+
+    VariantClear(&varResult);
+    SysFreeString(excepInfo.bstrSource);
+    SysFreeString(excepInfo.bstrDescription);
+    SysFreeString(excepInfo.bstrHelpFile);
+    return hr;
+}
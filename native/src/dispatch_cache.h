@@ -0,0 +1,98 @@
+/**
+ * Dispatch Cache
+ *
+ * DISPIDs for every method and property of a coclass, read once from its
+ * ITypeInfo, plus a reusable VARIANTARG buffer so repeated calls don't
+ * allocate a fresh BSTR per string argument.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A JS-compatible value on its way to or from IDispatch::Invoke
+struct DispatchValue {
+    enum class Kind { Empty, Bool, Int, Double, String };
+
+    Kind kind = Kind::Empty;
+    bool boolValue = false;
+    int32_t intValue = 0;
+    double doubleValue = 0.0;
+    std::wstring stringValue;
+
+    static DispatchValue FromVariant(const VARIANT& variant);
+};
+
+struct DispatchMember {
+    DISPID dispid = DISPID_UNKNOWN;
+    bool canCall = false;      // INVOKE_FUNC
+    bool canGet = false;       // INVOKE_PROPERTYGET
+    bool canPut = false;       // INVOKE_PROPERTYPUT / PUTREF
+    // Arguments the get and put descriptions take (put counts the value);
+    // -1 when unknown, for members found only through GetIDsOfNames
+    int getArgs = -1;
+    int putArgs = -1;
+};
+
+class DispatchCache {
+public:
+    // One cache per coclass, shared by every control of that class
+    static DispatchCache& ForClass(REFCLSID clsid);
+
+    // Read all member names from the object's type info. Runs once per
+    // class; later calls return immediately.
+    void Populate(IDispatch* pDispatch);
+
+    // Resolve a member by (case-insensitive) name. Names missing from the
+    // type info fall back to GetIDsOfNames once and are remembered.
+    bool Lookup(IDispatch* pDispatch, const std::wstring& name, DispatchMember* member);
+
+    size_t Size();
+
+private:
+    DispatchCache() = default;
+
+    std::mutex m_mutex;
+    bool m_populated = false;
+    std::unordered_map<std::wstring, DispatchMember> m_members;
+};
+
+// Per-object argument slots reused across calls. String slots keep their
+// BSTR and overwrite it in place while the new string fits; only a longer
+// one allocates.
+class DispatchArgs {
+public:
+    DispatchArgs() = default;
+    ~DispatchArgs();
+
+    DispatchArgs(const DispatchArgs&) = delete;
+    DispatchArgs& operator=(const DispatchArgs&) = delete;
+
+    // Fill slots (in IDispatch's reversed order) and return the array
+    VARIANTARG* Fill(const std::vector<DispatchValue>& values);
+
+private:
+    struct StringBuffer {
+        BSTR bstr = nullptr;  // what the slot held when Fill last ran: a callee may have replaced it
+        UINT capacity = 0;    // characters, excluding the terminator
+    };
+
+    bool FillString(VARIANTARG* slot, StringBuffer* buffer, const std::wstring& value);
+
+    std::vector<VARIANTARG> m_slots;
+    std::vector<StringBuffer> m_strings;
+};
+
+// Invoke a member through the cache. A property is written when the args
+// match its put description (the value included) and read when they fit
+// its get description, indexed properties included; methods are called.
+// Members known only by name fall back to zero args reading and one
+// writing.
+HRESULT InvokeCached(IDispatch* pDispatch, DispatchCache& cache, DispatchArgs& args,
+    const std::wstring& name, const std::vector<DispatchValue>& values,
+    DispatchValue* result);
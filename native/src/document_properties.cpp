@@ -0,0 +1,354 @@
+/**
+ * Document Property Reader
+ */
+
+#include "document_properties.h"
+
+#include <windows.h>
+#include <cstring>
+
+#include "compound_file.h"
+#include "mapped_file.h"
+
+static const char16_t* kSummaryStreamName = u"\x05SummaryInformation";
+static const char16_t* kDocSummaryStreamName = u"\x05DocumentSummaryInformation";
+
+// Property set streams are a few KB; anything this big is not one
+static const uint64_t kMaxPropertyStreamBytes = 1 << 20;
+
+// FMTIDs in their on-disk (little-endian GUID) byte order
+static const uint8_t kFmtidSummary[16] = {  // F29F85E0-4FF9-1068-AB91-08002B27B3D9
+    0xE0, 0x85, 0x9F, 0xF2, 0xF9, 0x4F, 0x68, 0x10, 0xAB, 0x91, 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 };
+static const uint8_t kFmtidDocSummary[16] = {  // D5CDD502-2E9C-101B-9397-08002B2CF9AE
+    0x02, 0xD5, 0xCD, 0xD5, 0x9C, 0x2E, 0x1B, 0x10, 0x93, 0x97, 0x08, 0x00, 0x2B, 0x2C, 0xF9, 0xAE };
+static const uint8_t kFmtidUserDefined[16] = {  // D5CDD505-2E9C-101B-9397-08002B2CF9AE
+    0x05, 0xD5, 0xCD, 0xD5, 0x9C, 0x2E, 0x1B, 0x10, 0x93, 0x97, 0x08, 0x00, 0x2B, 0x2C, 0xF9, 0xAE };
+
+static const uint32_t kPidDictionary = 0;
+static const uint32_t kPidCodePage = 1;
+static const uint32_t kCodePageUtf16 = 1200;
+
+// Variant types a property set can hold that are read as text here
+enum : uint16_t {
+    kVtI2 = 2, kVtI4 = 3, kVtR4 = 4, kVtR8 = 5, kVtDate = 7, kVtBool = 11,
+    kVtI1 = 16, kVtUi1 = 17, kVtUi2 = 18, kVtUi4 = 19, kVtI8 = 20, kVtUi8 = 21,
+    kVtInt = 22, kVtUint = 23, kVtLpstr = 30, kVtLpwstr = 31, kVtFiletime = 64,
+};
+
+// FILETIME ticks per day, and days from 1601-01-01 to the VT_DATE epoch (1899-12-30)
+static const double kTicksPerDay = 864000000000.0;
+static const double kDateEpochDays = 109205.0;
+
+// Bounds-checked little-endian reads within one section
+struct SectionReader {
+    const uint8_t* data;
+    size_t size;
+
+    bool Has(size_t offset, size_t length) const {
+        return offset <= size && length <= size - offset;
+    }
+    bool U16(size_t offset, uint16_t* value) const {
+        if (!Has(offset, 2)) return false;
+        *value = static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+        return true;
+    }
+    bool U32(size_t offset, uint32_t* value) const {
+        if (!Has(offset, 4)) return false;
+        std::memcpy(value, data + offset, 4);
+        return true;
+    }
+    bool U64(size_t offset, uint64_t* value) const {
+        if (!Has(offset, 8)) return false;
+        std::memcpy(value, data + offset, 8);
+        return true;
+    }
+};
+
+static void TrimNulls(std::wstring* text) {
+    while (!text->empty() && text->back() == L'\0') text->pop_back();
+}
+
+// A code page string of `bytes` bytes; UTF-16 when the set's code page says so
+static bool DecodeString(const SectionReader& reader, size_t offset, size_t bytes, uint32_t codePage,
+    std::wstring* out) {
+
+    if (!reader.Has(offset, bytes)) return false;
+    const char* chars = reinterpret_cast<const char*>(reader.data + offset);
+
+    if (codePage == kCodePageUtf16) {
+        out->assign(reinterpret_cast<const wchar_t*>(chars), bytes / sizeof(wchar_t));
+    } else if (bytes == 0) {
+        out->clear();
+    } else {
+        UINT cp = codePage == 0 ? CP_ACP : codePage;
+        int length = MultiByteToWideChar(cp, 0, chars, static_cast<int>(bytes), nullptr, 0);
+        if (length <= 0) return false;
+        out->resize(length);
+        MultiByteToWideChar(cp, 0, chars, static_cast<int>(bytes), &(*out)[0], length);
+    }
+    TrimNulls(out);
+    return true;
+}
+
+static std::wstring FormatFiletime(uint64_t filetime) {
+    FILETIME ft;
+    ft.dwLowDateTime = static_cast<DWORD>(filetime);
+    ft.dwHighDateTime = static_cast<DWORD>(filetime >> 32);
+    SYSTEMTIME st;
+    if (!FileTimeToSystemTime(&ft, &st)) return std::wstring();
+
+    wchar_t text[32];
+    swprintf_s(text, L"%04u-%02u-%02uT%02u:%02u:%02uZ",
+        st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+    return text;
+}
+
+static std::wstring FormatDouble(double value) {
+    wchar_t text[32];
+    swprintf_s(text, L"%.15g", value);
+    return text;
+}
+
+// Decode one typed value; false for types and layouts not read here
+static bool DecodeValue(const SectionReader& reader, size_t offset, uint32_t codePage, PropertySetValue* value) {
+    uint16_t type = 0;
+    if (!reader.U16(offset, &type)) return false;
+    size_t at = offset + 4;  // type, then 2 bytes of padding
+
+    uint16_t u16 = 0;
+    uint32_t u32 = 0;
+    uint64_t u64 = 0;
+    switch (type) {
+    case kVtI2:
+        if (!reader.U16(at, &u16)) return false;
+        value->text = std::to_wstring(static_cast<int16_t>(u16));
+        return true;
+    case kVtUi2:
+        if (!reader.U16(at, &u16)) return false;
+        value->text = std::to_wstring(u16);
+        return true;
+    case kVtI1:
+    case kVtUi1:
+        if (!reader.Has(at, 1)) return false;
+        value->text = type == kVtI1 ? std::to_wstring(static_cast<int8_t>(reader.data[at]))
+                                    : std::to_wstring(reader.data[at]);
+        return true;
+    case kVtBool:
+        if (!reader.U16(at, &u16)) return false;
+        value->text = u16 ? L"Yes" : L"No";
+        return true;
+    case kVtI4:
+    case kVtInt:
+        if (!reader.U32(at, &u32)) return false;
+        value->text = std::to_wstring(static_cast<int32_t>(u32));
+        return true;
+    case kVtUi4:
+    case kVtUint:
+        if (!reader.U32(at, &u32)) return false;
+        value->text = std::to_wstring(u32);
+        return true;
+    case kVtI8:
+        if (!reader.U64(at, &u64)) return false;
+        value->text = std::to_wstring(static_cast<int64_t>(u64));
+        return true;
+    case kVtUi8:
+        if (!reader.U64(at, &u64)) return false;
+        value->text = std::to_wstring(u64);
+        return true;
+    case kVtR4: {
+        float f = 0;
+        if (!reader.Has(at, 4)) return false;
+        std::memcpy(&f, reader.data + at, 4);
+        value->text = FormatDouble(f);
+        return true;
+    }
+    case kVtR8: {
+        double d = 0;
+        if (!reader.Has(at, 8)) return false;
+        std::memcpy(&d, reader.data + at, 8);
+        value->text = FormatDouble(d);
+        return true;
+    }
+    case kVtDate: {
+        double days = 0;
+        if (!reader.Has(at, 8)) return false;
+        std::memcpy(&days, reader.data + at, 8);
+        if (!(days > -kDateEpochDays && days < 2958466.0)) return false;  // 1601 to 9999
+        value->filetime = static_cast<uint64_t>((days + kDateEpochDays) * kTicksPerDay);
+        value->text = FormatFiletime(value->filetime);
+        return !value->text.empty();
+    }
+    case kVtFiletime:
+        if (!reader.U64(at, &u64)) return false;
+        value->filetime = u64;
+        value->text = u64 ? FormatFiletime(u64) : std::wstring();
+        return true;
+    case kVtLpstr:
+        if (!reader.U32(at, &u32)) return false;
+        return DecodeString(reader, at + 4, u32, codePage, &value->text);
+    case kVtLpwstr:
+        if (!reader.U32(at, &u32) || u32 > reader.size / sizeof(wchar_t)) return false;
+        return DecodeString(reader, at + 4, static_cast<size_t>(u32) * sizeof(wchar_t), kCodePageUtf16,
+            &value->text);
+    default:
+        return false;
+    }
+}
+
+// The dictionary (property 0) of a named section: id -> name
+static void DecodeDictionary(const SectionReader& reader, size_t offset, uint32_t codePage,
+    std::vector<PropertySetValue>* names) {
+
+    uint32_t count = 0;
+    if (!reader.U32(offset, &count)) return;
+    size_t at = offset + 4;
+    for (uint32_t i = 0; i < count; i++) {
+        PropertySetValue entry;
+        uint32_t length = 0;
+        if (!reader.U32(at, &entry.id) || !reader.U32(at + 4, &length)) return;
+        at += 8;
+
+        // Lengths count characters, NUL included; UTF-16 names pad to 4 bytes
+        size_t bytes = codePage == kCodePageUtf16 ? static_cast<size_t>(length) * 2 : length;
+        if (length > reader.size || !DecodeString(reader, at, bytes, codePage, &entry.name)) return;
+        at += codePage == kCodePageUtf16 ? (bytes + 3) & ~static_cast<size_t>(3) : bytes;
+        names->push_back(std::move(entry));
+    }
+}
+
+static bool ParseSection(const SectionReader& reader, PropertySetSection* section) {
+    uint32_t size = 0;
+    uint32_t count = 0;
+    if (!reader.U32(0, &size) || !reader.U32(4, &count)) return false;
+    if (size < 8 || size > reader.size || count > (size - 8) / 8) return false;
+    SectionReader body = { reader.data, size };
+
+    // The code page decides how every string, dictionary names too, is read
+    uint32_t dictionaryOffset = 0;
+    bool hasDictionary = false;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t id = 0;
+        uint32_t offset = 0;
+        body.U32(8 + i * 8, &id);
+        body.U32(12 + i * 8, &offset);
+        uint16_t type = 0;
+        uint16_t codePage = 0;
+        if (id == kPidCodePage && body.U16(offset, &type) && type == kVtI2 && body.U16(offset + 4, &codePage)) {
+            section->codePage = codePage;
+        } else if (id == kPidDictionary) {
+            dictionaryOffset = offset;
+            hasDictionary = true;
+        }
+    }
+
+    std::vector<PropertySetValue> names;
+    if (hasDictionary) DecodeDictionary(body, dictionaryOffset, section->codePage, &names);
+
+    for (uint32_t i = 0; i < count; i++) {
+        PropertySetValue value;
+        uint32_t offset = 0;
+        body.U32(8 + i * 8, &value.id);
+        body.U32(12 + i * 8, &offset);
+        if (value.id == kPidDictionary || value.id == kPidCodePage || value.id >= 0x80000000u) continue;
+        if (!DecodeValue(body, offset, section->codePage, &value)) continue;
+
+        for (const auto& name : names) {
+            if (name.id == value.id) {
+                value.name = name.name;
+                break;
+            }
+        }
+        section->values.push_back(std::move(value));
+    }
+    return true;
+}
+
+bool ParsePropertySetStream(const uint8_t* data, size_t size, std::vector<PropertySetSection>* sections) {
+    SectionReader stream = { data, size };
+    uint16_t byteOrder = 0;
+    uint32_t count = 0;
+    if (!stream.U16(0, &byteOrder) || byteOrder != 0xFFFE || !stream.U32(24, &count)) return false;
+    if (count == 0 || count > (size - 28) / 20) return false;
+
+    for (uint32_t i = 0; i < count; i++) {
+        size_t entry = 28 + static_cast<size_t>(i) * 20;
+        uint32_t offset = 0;
+        if (!stream.U32(entry + 16, &offset) || offset >= size) return false;
+
+        PropertySetSection section;
+        std::memcpy(section.fmtid, data + entry, sizeof(section.fmtid));
+        SectionReader reader = { data + offset, size - offset };
+        if (ParseSection(reader, &section)) sections->push_back(std::move(section));
+    }
+    return true;
+}
+
+static bool ReadPropertySets(const CompoundFile& file, const char16_t* name,
+    std::vector<PropertySetSection>* sections) {
+
+    CompoundEntry entry;
+    std::vector<uint8_t> bytes;
+    if (!file.Find(name, &entry) || entry.type != CompoundEntry::Stream) return false;
+    if (!file.ReadStream(entry, &bytes, kMaxPropertyStreamBytes)) return false;
+    return ParsePropertySetStream(bytes.data(), bytes.size(), sections);
+}
+
+static void ApplySummary(const PropertySetSection& section, DocumentSummary* summary) {
+    for (const auto& value : section.values) {
+        switch (value.id) {
+        case 2: summary->title = value.text; break;
+        case 3: summary->subject = value.text; break;
+        case 4: summary->author = value.text; break;
+        case 5: summary->keywords = value.text; break;
+        case 6: summary->comments = value.text; break;
+        case 8: summary->lastSavedBy = value.text; break;
+        case 9: summary->revision = value.text; break;
+        case 12: summary->created = value.filetime; break;
+        case 13: summary->modified = value.filetime; break;
+        case 18: summary->application = value.text; break;
+        }
+    }
+}
+
+static void ApplyDocSummary(const PropertySetSection& section, DocumentSummary* summary) {
+    for (const auto& value : section.values) {
+        switch (value.id) {
+        case 2: summary->category = value.text; break;
+        case 14: summary->manager = value.text; break;
+        case 15: summary->company = value.text; break;
+        }
+    }
+}
+
+DocumentProperties ReadDocumentProperties(const std::wstring& path) {
+    DocumentProperties result;
+
+    MappedFile mapped;
+    CompoundFile file;
+    if (!mapped.Open(path, &result.error)) return result;
+    if (!file.Open(&mapped, &result.error)) return result;
+    result.compound = true;
+
+    std::vector<PropertySetSection> sections;
+    bool summary = ReadPropertySets(file, kSummaryStreamName, &sections);
+    bool docSummary = ReadPropertySets(file, kDocSummaryStreamName, &sections);
+    if (!summary && !docSummary) {
+        result.error = "No property sets in file";
+        return result;
+    }
+
+    for (const auto& section : sections) {
+        if (std::memcmp(section.fmtid, kFmtidSummary, 16) == 0) {
+            ApplySummary(section, &result.summary);
+        } else if (std::memcmp(section.fmtid, kFmtidDocSummary, 16) == 0) {
+            ApplyDocSummary(section, &result.summary);
+        } else if (std::memcmp(section.fmtid, kFmtidUserDefined, 16) == 0) {
+            for (const auto& value : section.values) {
+                if (!value.name.empty()) result.custom.push_back({ value.name, value.text });
+            }
+        }
+    }
+
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,80 @@
+/**
+ * Document Property Reader
+ *
+ * Reads a compound file's OLE property sets (MS-OLEPS) straight from its
+ * streams, with no COM and no document open: \005SummaryInformation
+ * (title, author, dates, ...) and \005DocumentSummaryInformation, whose
+ * second section holds the user-defined properties. That section is where
+ * SOLIDWORKS keeps a document's file-level custom properties (the ones
+ * Explorer's Summary tab shows). The file is mapped, so only the directory
+ * and the two streams, usually a few KB, are read.
+ *
+ * Values come back as text: numbers in decimal, Yes/No for booleans, and
+ * dates as ISO 8601 UTC, as the SOLIDWORKS service reports them.
+ *
+ * Not read here: configuration names and configuration-specific
+ * properties, which live in SOLIDWORKS's own undocumented streams, and
+ * every SOLIDWORKS 2015+ file, since those are not compound files. Those
+ * files fail with `compound` false, so the caller can retry them through
+ * the service.
+ *
+ * Win32 only for code page conversion and time formatting.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct DocumentProperty {
+    std::wstring name;
+    std::wstring value;
+};
+
+// The standard summary fields; empty strings and 0 times were absent
+struct DocumentSummary {
+    std::wstring title;
+    std::wstring subject;
+    std::wstring author;
+    std::wstring keywords;
+    std::wstring comments;
+    std::wstring lastSavedBy;
+    std::wstring revision;
+    std::wstring application;
+    std::wstring category;
+    std::wstring manager;
+    std::wstring company;
+    uint64_t created = 0;   // FILETIME
+    uint64_t modified = 0;  // FILETIME
+};
+
+struct DocumentProperties {
+    bool success = false;
+    bool compound = false;  // a compound file (false: SOLIDWORKS 2015+, or not a document)
+    std::string error;
+    DocumentSummary summary;
+    std::vector<DocumentProperty> custom;  // user-defined properties, in file order
+};
+
+// One decoded property of a property set section. Named properties (the
+// user-defined section) carry their dictionary name.
+struct PropertySetValue {
+    uint32_t id = 0;
+    std::wstring name;
+    std::wstring text;
+    uint64_t filetime = 0;  // set for VT_FILETIME values as well as `text`
+};
+
+struct PropertySetSection {
+    uint8_t fmtid[16] = {};
+    uint32_t codePage = 0;
+    std::vector<PropertySetValue> values;  // types this reader understands only
+};
+
+// Parse a whole property set stream. False if it isn't one; unreadable
+// properties are skipped rather than failing the stream.
+bool ParsePropertySetStream(const uint8_t* data, size_t size, std::vector<PropertySetSection>* sections);
+
+DocumentProperties ReadDocumentProperties(const std::wstring& path);
@@ -4,26 +4,51 @@
  * Embeds the eDrawings ActiveX control as a child window of Electron
  */
 
-#define NAPI_VERSION 8
-#include <napi.h>
+#include "addon.h"
+
 #include <windows.h>
 #include <atlbase.h>
 #include <atlcom.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
-#include <shlwapi.h>
-
-#pragma comment(lib, "shlwapi.lib")
+#include <vector>
 
-// eDrawings control CLSID
-// {22945A69-1191-4DCF-9E6F-409BDE94D101} - eDrawings control
-static const CLSID CLSID_EModelViewControl = 
-    {0x22945A69, 0x1191, 0x4DCF, {0x9E, 0x6F, 0x40, 0x9B, 0xDE, 0x94, 0xD1, 0x01}};
+#include "aligned_buffer_pool.h"
+#include "bounds_sync.h"
+#include "com_executor.h"
+#include "control_pool.h"
+#include "install_locator.h"
+#include "memory_guard.h"
+#include "native_stats.h"
+#include "offscreen_render.h"
+#include "string_util.h"
+#include "thread_pool.h"
+#include "thumbnail_extractor.h"
 
 // Forward declarations
 class EDrawingsPreview;
 
-// Global COM initialization flag
-static bool g_comInitialized = false;
+// Apartment-side state of one preview. JS holds a shared_ptr and every job
+// captures one, so state outlives jobs still queued after destroy().
+// Everything except `container` is only read or written on `apartment`.
+struct PreviewSession {
+    StaThread* apartment = nullptr;
+    PooledControl* control = nullptr;
+    uint64_t lease = 0;
+    // Published once the control is acquired so window moves can skip the
+    // apartment's queue
+    std::atomic<HWND> container{nullptr};
+
+    bool HasControl() const {
+        return control && ControlPool::Current().Owns(control, lease);
+    }
+};
 
 // The preview control wrapper
 class EDrawingsPreview : public Napi::ObjectWrap<EDrawingsPreview> {
@@ -32,82 +57,196 @@ public:
     EDrawingsPreview(const Napi::CallbackInfo& info);
     ~EDrawingsPreview();
 
+    // Return the pooled control (if any) and reset to the unattached state
+    void ReleaseControl();
+
+    void SetFileLoaded(bool loaded) { m_isFileLoaded = loaded; }
+
+    std::shared_ptr<PreviewSession> Session() const { return m_session; }
+
 private:
     // N-API methods
     Napi::Value AttachToWindow(const Napi::CallbackInfo& info);
     Napi::Value LoadFile(const Napi::CallbackInfo& info);
+    Napi::Value LoadFileAsync(const Napi::CallbackInfo& info);
+    Napi::Value Invoke(const Napi::CallbackInfo& info);
     Napi::Value SetBounds(const Napi::CallbackInfo& info);
+    Napi::Value SyncBounds(const Napi::CallbackInfo& info);
     Napi::Value Show(const Napi::CallbackInfo& info);
     Napi::Value Hide(const Napi::CallbackInfo& info);
     Napi::Value Destroy(const Napi::CallbackInfo& info);
     Napi::Value IsLoaded(const Napi::CallbackInfo& info);
+    Napi::Value GetApartment(const Napi::CallbackInfo& info);
 
-    // Internal
-    bool CreateControl(HWND parentHwnd);
-    void DestroyControl();
+    // Run fn with the container window: directly once it is known,
+    // otherwise queued behind the pending attach
+    bool WithContainer(std::function<void(HWND)> fn);
+
+    // Stop reading the bounds slot and let go of its buffer
+    void StopBoundsSync();
 
     HWND m_hwndParent = nullptr;
-    HWND m_hwndContainer = nullptr;
-    IUnknown* m_pControl = nullptr;
-    IDispatch* m_pDispatch = nullptr;
+    std::shared_ptr<PreviewSession> m_session;  // set while attached
+    uint64_t m_boundsSync = 0;                       // BoundsSync id while synced
+    Napi::Reference<Napi::ArrayBuffer> m_boundsSlot;  // the slot's memory, kept alive
     bool m_isAttached = false;
     bool m_isFileLoaded = false;
 };
 
-// Static: Check if eDrawings is installed
-Napi::Value CheckEDrawingsInstalled(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    
-    // Try to find eDrawings in common locations
-    const wchar_t* paths[] = {
-        L"C:\\Program Files\\SOLIDWORKS Corp\\eDrawings\\eDrawings.exe",
-        L"C:\\Program Files\\eDrawings\\eDrawings.exe",
-        L"C:\\Program Files (x86)\\eDrawings\\eDrawings.exe",
-        L"C:\\Program Files\\SOLIDWORKS Corp\\SOLIDWORKS\\eDrawings\\eDrawings.exe"
-    };
-    
-    for (const auto& path : paths) {
-        if (PathFileExistsW(path)) {
-            // Convert to UTF-8 for JS
-            int len = WideCharToMultiByte(CP_UTF8, 0, path, -1, nullptr, 0, nullptr, nullptr);
-            std::string utf8Path(len - 1, '\0');
-            WideCharToMultiByte(CP_UTF8, 0, path, -1, &utf8Path[0], len, nullptr, nullptr);
-            
-            Napi::Object result = Napi::Object::New(env);
-            result.Set("installed", Napi::Boolean::New(env, true));
-            result.Set("path", Napi::String::New(env, utf8Path));
-            return result;
+// Per-apartment settings from initPreviewPool, for apartments the executor
+// starts later for extra previews: resident limits and the warm pool size.
+// JS thread only.
+struct ApartmentDefaults {
+    bool set = false;
+    size_t documents = kDefaultResidentDocuments;
+    uint64_t bytes = kDefaultResidentBytes;
+    size_t warmControls = 0;
+};
+static ApartmentDefaults g_apartmentDefaults;
+
+// Runs on the memory guard's thread: cached I/O buffers go at once, then
+// every apartment trims its own pool
+static void TrimPreviewPools(uint64_t targetBytes) {
+    AlignedBufferPool::Shared().Trim();
+    ComExecutor& executor = ComExecutor::Shared();
+    for (size_t i = 0; i < executor.Size(); i++) {
+        StaThread* apartment = executor.At(i);
+        if (apartment) {
+            apartment->Post([targetBytes]() { ControlPool::Current().TrimForMemory(targetBytes); });
         }
     }
-    
-    // Also check registry for eDrawings
-    HKEY hKey;
-    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, 
-        L"SOFTWARE\\SolidWorks\\eDrawings\\General", 
-        0, KEY_READ, &hKey) == ERROR_SUCCESS) {
-        
-        wchar_t installPath[MAX_PATH];
-        DWORD size = sizeof(installPath);
-        if (RegQueryValueExW(hKey, L"InstallPath", nullptr, nullptr, 
-            (LPBYTE)installPath, &size) == ERROR_SUCCESS) {
-            
-            RegCloseKey(hKey);
-            
-            int len = WideCharToMultiByte(CP_UTF8, 0, installPath, -1, nullptr, 0, nullptr, nullptr);
-            std::string utf8Path(len - 1, '\0');
-            WideCharToMultiByte(CP_UTF8, 0, installPath, -1, &utf8Path[0], len, nullptr, nullptr);
-            
-            Napi::Object result = Napi::Object::New(env);
-            result.Set("installed", Napi::Boolean::New(env, true));
-            result.Set("path", Napi::String::New(env, utf8Path));
-            return result;
+}
+
+// Start the preview apartments, and the memory guard watching their
+// controls, on first use
+static bool EnsurePreviewApartment() {
+    if (!ComExecutor::Shared().Start()) return false;
+    MemoryGuard::Shared().Start(TrimPreviewPools);
+    return true;
+}
+
+// Call OpenDoc on a control. Must run on the control's apartment.
+static HRESULT OpenDocOnControl(PooledControl* control, const std::wstring& path) {
+    ScopedNativeTimer timer(NativeOp::OpenDoc);
+    DispatchValue arg;
+    arg.kind = DispatchValue::Kind::String;
+    arg.stringValue = path;
+    return InvokeControl(control, L"OpenDoc", { arg });
+}
+
+// Settles the preload's own listener when a preview takes it mid-load
+static const wchar_t* const kPreloadTaken = L"Taken by a preview";
+
+// Swap the session's control for one of the pool's that already has path
+// open (a resident left by an earlier preview, or the preload), in the old
+// container's place. *ready is false while a preload is still loading; its
+// completion event then belongs to the caller. With readyOnly, a preload
+// still loading is left alone. Must run on the session's apartment with a
+// live control.
+static bool AdoptLoadedDocument(PreviewSession* session, const std::wstring& path, bool readyOnly,
+    bool* ready) {
+    HWND previous = session->control->hwndContainer;
+    HWND parent = GetParent(previous);
+    ControlPool& pool = ControlPool::Current();
+    PooledControl* preloaded = pool.TakeResident(path, parent);
+    if (preloaded) {
+        *ready = true;
+    } else if (!readyOnly || pool.IsPreloadReady(path)) {
+        preloaded = pool.TakePreloaded(path, parent, ready);
+    }
+    if (!preloaded) return false;
+
+    RECT rect = {};
+    GetWindowRect(previous, &rect);
+    MapWindowPoints(HWND_DESKTOP, parent, reinterpret_cast<POINT*>(&rect), 2);
+    UINT visibility = IsWindowVisible(previous) ? SWP_SHOWWINDOW : SWP_HIDEWINDOW;
+    SetWindowPos(preloaded->hwndContainer, nullptr, rect.left, rect.top,
+        rect.right - rect.left, rect.bottom - rect.top, SWP_NOZORDER | SWP_NOACTIVATE | visibility);
+
+    if (!*ready && preloaded->events) preloaded->events->CancelPending(kPreloadTaken);
+    pool.Release(session->control);
+    session->control = preloaded;
+    session->lease = preloaded->lease;
+    session->container = preloaded->hwndContainer;
+    return true;
+}
+
+// Convert a JS argument for IDispatch. Integers stay VT_I4 so enum-typed
+// parameters (view orientation, etc.) don't arrive as doubles.
+static bool DispatchValueFromJs(const Napi::Value& value, DispatchValue* out) {
+    if (value.IsUndefined() || value.IsNull()) {
+        out->kind = DispatchValue::Kind::Empty;
+    } else if (value.IsBoolean()) {
+        out->kind = DispatchValue::Kind::Bool;
+        out->boolValue = value.As<Napi::Boolean>().Value();
+    } else if (value.IsNumber()) {
+        double number = value.As<Napi::Number>().DoubleValue();
+        int32_t integer = static_cast<int32_t>(number);
+        if (static_cast<double>(integer) == number) {
+            out->kind = DispatchValue::Kind::Int;
+            out->intValue = integer;
+        } else {
+            out->kind = DispatchValue::Kind::Double;
+            out->doubleValue = number;
         }
-        RegCloseKey(hKey);
+    } else if (value.IsString()) {
+        out->kind = DispatchValue::Kind::String;
+        out->stringValue = JsToWide(value);
+    } else {
+        return false;
     }
-    
+    return true;
+}
+
+static Napi::Value DispatchValueToJs(Napi::Env env, const DispatchValue& value) {
+    switch (value.kind) {
+        case DispatchValue::Kind::Bool: return Napi::Boolean::New(env, value.boolValue);
+        case DispatchValue::Kind::Int: return Napi::Number::New(env, value.intValue);
+        case DispatchValue::Kind::Double: return Napi::Number::New(env, value.doubleValue);
+        case DispatchValue::Kind::String: return WideToJs(env, value.stringValue);
+        default: return env.Undefined();
+    }
+}
+
+// Read an HWND passed from JS as a Buffer (getNativeWindowHandle) or number
+static HWND HwndFromValue(const Napi::Value& value) {
+    HWND hwnd = nullptr;
+    if (value.IsBuffer()) {
+        Napi::Buffer<uint8_t> buf = value.As<Napi::Buffer<uint8_t>>();
+        if (buf.Length() >= sizeof(HWND)) {
+            hwnd = *reinterpret_cast<HWND*>(buf.Data());
+        }
+    } else if (value.IsNumber()) {
+        hwnd = reinterpret_cast<HWND>(value.As<Napi::Number>().Int64Value());
+    }
+    return hwnd;
+}
+
+// Static: Check if eDrawings is installed
+// checkEDrawingsInstalled({ refresh }?) -> { installed, path, controlPath?, version?, source? }
+// Answered from InstallLocator's cache, which a registry watch keeps current
+Napi::Value CheckEDrawingsInstalled(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    bool refresh = false;
+    if (info.Length() >= 1 && info[0].IsObject()) {
+        Napi::Value value = info[0].As<Napi::Object>().Get("refresh");
+        refresh = value.IsBoolean() && value.As<Napi::Boolean>().Value();
+    }
+
+    EDrawingsInstall install = InstallLocator::Shared().Get(refresh);
     Napi::Object result = Napi::Object::New(env);
-    result.Set("installed", Napi::Boolean::New(env, false));
-    result.Set("path", env.Null());
+    result.Set("installed", Napi::Boolean::New(env, install.installed));
+    if (!install.installed) {
+        result.Set("path", env.Null());
+        return result;
+    }
+    result.Set("path", WideToJs(env, install.path));
+    if (!install.controlPath.empty()) {
+        result.Set("controlPath", WideToJs(env, install.controlPath));
+    }
+    if (!install.version.empty()) result.Set("version", WideToJs(env, install.version));
+    result.Set("source", Napi::String::New(env, install.source));
     return result;
 }
 
@@ -115,17 +254,8 @@ Napi::Value CheckEDrawingsInstalled(const Napi::CallbackInfo& info) {
 Napi::Value OpenInEDrawings(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "File path expected").ThrowAsJavaScriptException();
-        return env.Null();
-    }
-    
-    std::string filePath = info[0].As<Napi::String>().Utf8Value();
-    
-    // Convert to wide string
-    int wlen = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0);
-    std::wstring wFilePath(wlen - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &wFilePath[0], wlen);
+    std::wstring wFilePath;
+    if (!ReadArgs(info, "File path expected", &wFilePath)) return env.Null();
     
     // Try to open with default handler (eDrawings if associated)
     HINSTANCE result = ShellExecuteW(nullptr, L"open", wFilePath.c_str(), 
@@ -134,16 +264,392 @@ Napi::Value OpenInEDrawings(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, (intptr_t)result > 32);
 }
 
+// Static: Create the warm control pool
+// initPreviewPool(size, { apartments, maxApartments, residentDocuments,
+//   residentMemoryMB, memoryBudgetMB }?) -> Promise<number of idle controls ready>
+// The controls, and the resident document limits, are split evenly across
+// the apartments. maxApartments lets concurrent previews grow them (default:
+// no growth); a grown apartment gets the same share of warm controls.
+// memoryBudgetMB caps process commit; 0 removes the cap.
+Napi::Value InitPreviewPool(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    int32_t size = 0;
+    std::optional<Napi::Object> object;
+    if (!ReadArgs(info, "Pool size expected", &size, &object)) return env.Null();
+    if (size < 0) size = 0;
+
+    ComExecutor& executor = ComExecutor::Shared();
+    int64_t residentDocuments = -1;  // -1: keep the pool's defaults
+    int64_t residentMemoryMB = -1;
+    if (object) {
+        Napi::Object options = *object;
+        Napi::Value apartments = options.Get("apartments");
+        if (apartments.IsNumber()) executor.Configure(apartments.As<Napi::Number>().Uint32Value());
+        Napi::Value maxApartments = options.Get("maxApartments");
+        if (maxApartments.IsNumber()) executor.SetGrowthLimit(maxApartments.As<Napi::Number>().Uint32Value());
+        Napi::Value documents = options.Get("residentDocuments");
+        if (documents.IsNumber()) residentDocuments = std::max<int64_t>(0, documents.As<Napi::Number>().Int64Value());
+        Napi::Value memory = options.Get("residentMemoryMB");
+        if (memory.IsNumber()) residentMemoryMB = std::max<int64_t>(0, memory.As<Napi::Number>().Int64Value());
+        Napi::Value budget = options.Get("memoryBudgetMB");
+        if (budget.IsNumber()) {
+            int64_t megabytes = std::max<int64_t>(0, budget.As<Napi::Number>().Int64Value());
+            MemoryGuard::Shared().SetBudget(static_cast<uint64_t>(megabytes) * 1024 * 1024);
+        }
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "eDrawingsInitPreviewPool");
+    Napi::Promise promise = completion->Promise();
+
+    size_t apartments = EnsurePreviewApartment() ? executor.Size() : 0;
+    if (apartments == 0) {
+        completion->Resolve([](Napi::Env env) { return Napi::Number::New(env, 0); });
+        return promise;
+    }
+
+    struct PrewarmTally {
+        std::atomic<size_t> remaining;
+        std::atomic<size_t> ready{0};
+    };
+    auto tally = std::make_shared<PrewarmTally>();
+    tally->remaining = apartments;
+    size_t perApartment = (static_cast<size_t>(size) + apartments - 1) / apartments;
+    bool setResident = residentDocuments >= 0 || residentMemoryMB >= 0;
+    size_t residentPerApartment = residentDocuments < 0 ? kDefaultResidentDocuments
+        : (static_cast<size_t>(residentDocuments) + apartments - 1) / apartments;
+    uint64_t residentBytesPerApartment = residentMemoryMB < 0 ? kDefaultResidentBytes
+        : static_cast<uint64_t>(residentMemoryMB) * 1024 * 1024 / apartments;
+    if (setResident) {
+        g_apartmentDefaults.set = true;
+        g_apartmentDefaults.documents = residentPerApartment;
+        g_apartmentDefaults.bytes = residentBytesPerApartment;
+    }
+    g_apartmentDefaults.warmControls = perApartment;
+
+    for (size_t i = 0; i < apartments; i++) {
+        auto finish = [tally, completion](size_t ready) {
+            tally->ready += ready;
+            if (--tally->remaining == 0) {
+                completion->Resolve([tally](Napi::Env env) {
+                    return Napi::Number::New(env, static_cast<double>(tally->ready.load()));
+                });
+            }
+        };
+        StaThread* apartment = executor.At(i);
+        if (!apartment || !apartment->Post([=]() {
+                ControlPool& pool = ControlPool::Current();
+                if (setResident) pool.SetResidentLimits(residentPerApartment, residentBytesPerApartment);
+                finish(pool.Prewarm(perApartment));
+            })) {
+            finish(0);
+        }
+    }
+    return promise;
+}
+
+// Static: Create a preview backed by a pooled control
+// acquirePreview(hwnd?) -> EDrawingsPreview (attached when hwnd is given)
+Napi::Value AcquirePreview(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    Napi::FunctionReference* constructor = env.GetInstanceData<Napi::FunctionReference>();
+    Napi::Object preview = constructor->New({});
+
+    if (info.Length() >= 1 && !info[0].IsUndefined() && !info[0].IsNull()) {
+        Napi::Function attach = preview.Get("attachToWindow").As<Napi::Function>();
+        Napi::Value attached = attach.Call(preview, { info[0] });
+        if (!attached.IsBoolean() || !attached.As<Napi::Boolean>().Value()) {
+            EDrawingsPreview::Unwrap(preview)->ReleaseControl();
+            return env.Null();
+        }
+    }
+
+    return preview;
+}
+
+// Static: Return a preview's control to the pool
+// releasePreview(preview) -> boolean
+Napi::Value ReleasePreview(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "EDrawingsPreview expected").ThrowAsJavaScriptException();
+        return Napi::Boolean::New(env, false);
+    }
+
+    Napi::Object obj = info[0].As<Napi::Object>();
+    Napi::FunctionReference* constructor = env.GetInstanceData<Napi::FunctionReference>();
+    if (!obj.InstanceOf(constructor->Value())) {
+        Napi::TypeError::New(env, "EDrawingsPreview expected").ThrowAsJavaScriptException();
+        return Napi::Boolean::New(env, false);
+    }
+
+    EDrawingsPreview::Unwrap(obj)->ReleaseControl();
+    return Napi::Boolean::New(env, true);
+}
+
+// Static: Do the one-time startup work that first use would otherwise pay:
+// start the preview apartments (COM, the memory guard) and the worker pool,
+// and load WIC and its encoders. Nothing here runs at require time; the
+// system DLLs are delay-loaded, so this is also when they map.
+// warmup({ previews?, thumbnails? }?) -> Promise<{ apartments, workers, codecs, elapsedMs }>
+Napi::Value Warmup(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    bool previews = true;
+    bool thumbnails = true;
+    if (info.Length() >= 1 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        Napi::Value value = options.Get("previews");
+        if (value.IsBoolean()) previews = value.As<Napi::Boolean>().Value();
+        value = options.Get("thumbnails");
+        if (value.IsBoolean()) thumbnails = value.As<Napi::Boolean>().Value();
+    }
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "eDrawingsWarmup");
+    Napi::Promise promise = completion->Promise();
+
+    struct WarmupState {
+        std::atomic<size_t> remaining{0};
+        std::atomic<size_t> apartments{0};
+        size_t workers = 0;
+        bool codecs = false;  // written by its one job, before finish()
+        std::chrono::steady_clock::time_point started;
+        AsyncCompletion* completion = nullptr;
+    };
+    auto state = std::make_shared<WarmupState>();
+    state->started = std::chrono::steady_clock::now();
+    state->completion = completion;
+    auto finish = [state]() {
+        if (--state->remaining > 0) return;
+        state->completion->Resolve([state](Napi::Env env) {
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("apartments", Napi::Number::New(env, static_cast<double>(state->apartments.load())));
+            result.Set("workers", Napi::Number::New(env, static_cast<double>(state->workers)));
+            result.Set("codecs", Napi::Boolean::New(env, state->codecs));
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - state->started;
+            result.Set("elapsedMs", Napi::Number::New(env, elapsed.count()));
+            return result;
+        });
+    };
+
+    // The first job starts every worker, and each initializes its own COM
+    std::vector<StaThread*> apartments;
+    if (previews && EnsurePreviewApartment()) {
+        for (size_t i = 0; i < ComExecutor::Shared().Size(); i++) {
+            if (StaThread* apartment = ComExecutor::Shared().At(i)) apartments.push_back(apartment);
+        }
+    }
+    state->remaining = (thumbnails ? 1 : 0) + apartments.size() + 1;  // + 1: released below
+
+    if (thumbnails) {
+        state->workers = ThreadPool::Shared().Size();
+        ThreadPool::Shared().Submit([state, finish]() {
+            state->codecs = WarmThumbnailCodecs();
+            finish();
+        }, JobPriority::Prefetch);
+    }
+    for (StaThread* apartment : apartments) {
+        if (!apartment->Post([state, finish]() {
+                state->apartments++;
+                finish();
+            })) {
+            finish();
+        }
+    }
+    finish();
+    return promise;
+}
+
+// Static: Un-park the bounds pacer after a slot write that found its
+// `parked` word set
+// wakeBoundsSync() -> undefined
+Napi::Value WakeBoundsSync(const Napi::CallbackInfo& info) {
+    BoundsSync::Shared().Wake();
+    return info.Env().Undefined();
+}
+
+// Static: Render a document headlessly on a pooled control
+// renderToBuffer(path, width, height, viewOrientation?, { jobId }?) -> Promise<{ success, width, height, data, error? }>
+Napi::Value RenderToBuffer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::wstring path;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    if (!ReadArgs(info, "File path, width and height expected", &path, &width, &height)) return env.Null();
+    width = std::clamp<uint32_t>(width, 16, 4096);
+    height = std::clamp<uint32_t>(height, 16, 4096);
+    int viewOrientation = info.Length() >= 4 && info[3].IsNumber() ? info[3].As<Napi::Number>().Int32Value() : -1;
+    JobOptions job;
+    if (info.Length() >= 5 && !ReadJobOptions(env, info[4], &job)) return env.Null();
+    CancelTokenPtr token = CancelToken::Create(job.jobId, path);
+
+    AsyncCompletion* completion = AsyncCompletion::Create(env, "eDrawingsRenderToBuffer");
+    Napi::Promise promise = completion->Promise();
+
+    auto image = std::make_shared<RenderedImage>();
+    auto resolve = [completion, image]() {
+        completion->Resolve([image](Napi::Env env) -> Napi::Value {
+            Napi::Object result = Napi::Object::New(env);
+            result.Set("success", Napi::Boolean::New(env, image->success));
+            if (image->success) {
+                result.Set("width", Napi::Number::New(env, image->width));
+                result.Set("height", Napi::Number::New(env, image->height));
+                result.Set("data", TakeBuffer(env, std::move(image->rgba)));
+            } else {
+                result.Set("error", Napi::String::New(env, image->error));
+            }
+            return result;
+        });
+    };
+
+    StaThread* apartment = EnsurePreviewApartment() ? ComExecutor::Shared().Next() : nullptr;
+    int64_t started = NativeStats::Now();
+    bool posted = apartment &&
+        apartment->Post([image, resolve, path, width, height, viewOrientation, started, token]() {
+            if (token->IsCancelled()) {
+                image->error = kCancelledError;
+                resolve();
+                return;
+            }
+            *image = RenderDocument(path, width, height, viewOrientation);
+            NativeStats::Record(NativeOp::RenderToBuffer, started);
+            resolve();
+        });
+    if (!posted) {
+        image->error = "Preview apartment not running";
+        resolve();
+    }
+
+    return promise;
+}
+
+struct PrefetchState {
+    std::atomic<int> remaining{2};  // thumbnails + preload
+    size_t thumbnails = 0;
+    bool preloaded = false;
+    CancelTokenPtr token;
+    AsyncCompletion* completion = nullptr;
+};
+
+static void FinishPrefetchPart(const std::shared_ptr<PrefetchState>& state) {
+    if (--state->remaining > 0) return;
+    state->token.reset();
+    state->completion->Resolve([state](Napi::Env env) -> Napi::Value {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("thumbnails", Napi::Number::New(env, static_cast<double>(state->thumbnails)));
+        result.Set("preloaded", Napi::Boolean::New(env, state->preloaded));
+        return result;
+    });
+}
+
+// Open path on a parked control of the session's apartment, so a later
+// load of the same file on that apartment adopts it (see AdoptLoadedDocument)
+static void PreloadDocument(const std::shared_ptr<PreviewSession>& session, const std::wstring& path,
+    const std::shared_ptr<PrefetchState>& state) {
+    CancelTokenPtr token = state->token;
+    bool posted = session->apartment->Post([path, state, token]() {
+        ControlPool& pool = ControlPool::Current();
+        if (token->IsCancelled(path)) {
+            FinishPrefetchPart(state);
+            return;
+        }
+        PooledControl* control = pool.BeginPreload(path);
+        if (!control) {
+            state->preloaded = pool.IsPreloaded(path);
+            FinishPrefetchPart(state);
+            return;
+        }
+        if (control->events) {
+            ControlEventSink* events = control->events;
+            events->SetListener([events, control, state](const LoadEvent& ev) {
+                if (ev.type == LoadEvent::Type::Progress) return;
+                events->SetListener(nullptr);
+                bool success = ev.type == LoadEvent::Type::Complete;
+                ControlPool::Current().EndPreload(control, success);
+                state->preloaded = success || ev.errorMessage == kPreloadTaken;
+                FinishPrefetchPart(state);
+            });
+        }
+        HRESULT hr = OpenDocOnControl(control, path);
+        if (FAILED(hr) || !control->events) {
+            if (control->events) control->events->SetListener(nullptr);
+            pool.EndPreload(control, SUCCEEDED(hr));
+            state->preloaded = SUCCEEDED(hr);
+            FinishPrefetchPart(state);
+        }
+    });
+    if (!posted) {
+        FinishPrefetchPart(state);
+        return;
+    }
+    // Cancelling drops the half-loaded document
+    StaThread* apartment = session->apartment;
+    token->OnCancel([apartment, path]() {
+        apartment->Post([path]() { ControlPool::Current().CancelPreload(path); });
+    });
+}
+
+// Static: Warm the thumbnail cache for paths at idle priority and, given a
+// preview, preload paths[0] on its apartment so loading it next is instant
+// prefetch(paths: string[] | path table, { priority?, preview?, jobId? }) -> Promise<{ thumbnails, preloaded }>
+Napi::Value Prefetch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::vector<std::wstring> paths;
+    if (!ReadPathTable(info[0], &paths)) return env.Null();
+
+    JobOptions job;
+    job.priority = JobPriority::Prefetch;
+    std::shared_ptr<PreviewSession> session;
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (!ReadJobOptions(env, options, &job)) return env.Null();
+        Napi::Value preview = options.Get("preview");
+        if (!preview.IsUndefined() && !preview.IsNull()) {
+            Napi::FunctionReference* constructor = env.GetInstanceData<Napi::FunctionReference>();
+            if (!preview.IsObject() || !preview.As<Napi::Object>().InstanceOf(constructor->Value())) {
+                Napi::TypeError::New(env, "preview must be an EDrawingsPreview").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            session = EDrawingsPreview::Unwrap(preview.As<Napi::Object>())->Session();
+        }
+    }
+
+    auto state = std::make_shared<PrefetchState>();
+    state->token = CancelToken::Create(job.jobId, paths);
+    state->completion = AsyncCompletion::Create(env, "eDrawingsPrefetch");
+    Napi::Promise promise = state->completion->Promise();
+
+    if (session && !paths.empty()) {
+        PreloadDocument(session, paths.front(), state);
+    } else {
+        FinishPrefetchPart(state);
+    }
+    WarmThumbnailCache(std::move(paths), job.priority, state->token, [state](size_t warmed) {
+        state->thumbnails = warmed;
+        FinishPrefetchPart(state);
+    });
+
+    return promise;
+}
+
 // EDrawingsPreview implementation
 Napi::Object EDrawingsPreview::Init(Napi::Env env, Napi::Object exports) {
     Napi::Function func = DefineClass(env, "EDrawingsPreview", {
         InstanceMethod("attachToWindow", &EDrawingsPreview::AttachToWindow),
         InstanceMethod("loadFile", &EDrawingsPreview::LoadFile),
+        InstanceMethod("loadFileAsync", &EDrawingsPreview::LoadFileAsync),
+        InstanceMethod("invoke", &EDrawingsPreview::Invoke),
         InstanceMethod("setBounds", &EDrawingsPreview::SetBounds),
+        InstanceMethod("syncBounds", &EDrawingsPreview::SyncBounds),
         InstanceMethod("show", &EDrawingsPreview::Show),
         InstanceMethod("hide", &EDrawingsPreview::Hide),
         InstanceMethod("destroy", &EDrawingsPreview::Destroy),
         InstanceMethod("isLoaded", &EDrawingsPreview::IsLoaded),
+        InstanceMethod("getApartment", &EDrawingsPreview::GetApartment),
     });
     
     Napi::FunctionReference* constructor = new Napi::FunctionReference();
@@ -153,101 +659,92 @@ Napi::Object EDrawingsPreview::Init(Napi::Env env, Napi::Object exports) {
     exports.Set("EDrawingsPreview", func);
     exports.Set("checkEDrawingsInstalled", Napi::Function::New(env, CheckEDrawingsInstalled));
     exports.Set("openInEDrawings", Napi::Function::New(env, OpenInEDrawings));
+    exports.Set("initPreviewPool", Napi::Function::New(env, InitPreviewPool));
+    exports.Set("acquirePreview", Napi::Function::New(env, AcquirePreview));
+    exports.Set("releasePreview", Napi::Function::New(env, ReleasePreview));
+    exports.Set("renderToBuffer", Napi::Function::New(env, RenderToBuffer));
+    exports.Set("prefetch", Napi::Function::New(env, Prefetch));
+    exports.Set("warmup", Napi::Function::New(env, Warmup));
+    exports.Set("wakeBoundsSync", Napi::Function::New(env, WakeBoundsSync));
+    InitThumbnailBindings(env, exports);
+    InitCompoundFileBindings(env, exports);
+    InitHashBindings(env, exports);
+    InitDirectoryTreeBindings(env, exports);
+    InitChangeJournalBindings(env, exports);
+    InitDirectoryWatcherBindings(env, exports);
+    InitLockProbeBindings(env, exports);
+    InitStatsBindings(env, exports);
+    InitJobBindings(env, exports);
+    InitCopyBindings(env, exports);
+    InitChunkReaderBindings(env, exports);
+    InitContentChunkerBindings(env, exports);
+
+    // Tear each pool down on its own apartment, then stop the apartments
+    env.AddCleanupHook([]() {
+        ShutdownWorkerBindings();
+        BoundsSync::Shared().Stop();
+        MemoryGuard::Shared().Stop();
+        InstallLocator::Shared().Stop();
+        ComExecutor::Shared().Stop([]() {
+            ControlPool::DestroyCurrent();
+        });
+    });
     
     return exports;
 }
 
 EDrawingsPreview::EDrawingsPreview(const Napi::CallbackInfo& info) 
     : Napi::ObjectWrap<EDrawingsPreview>(info) {
-    
-    // Initialize COM if needed
-    if (!g_comInitialized) {
-        HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
-        if (SUCCEEDED(hr) || hr == S_FALSE) {
-            g_comInitialized = true;
-        }
-    }
+    // No COM here: everything runs on the executor's apartments
 }
 
 EDrawingsPreview::~EDrawingsPreview() {
-    DestroyControl();
-}
-
-bool EDrawingsPreview::CreateControl(HWND parentHwnd) {
-    if (m_isAttached) return true;
-    
-    // Create a container window
-    WNDCLASSEXW wc = {};
-    wc.cbSize = sizeof(WNDCLASSEXW);
-    wc.lpfnWndProc = DefWindowProcW;
-    wc.hInstance = GetModuleHandle(nullptr);
-    wc.lpszClassName = L"EDrawingsContainer";
-    wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
-    RegisterClassExW(&wc);
-    
-    m_hwndContainer = CreateWindowExW(
-        0,
-        L"EDrawingsContainer",
-        L"",
-        WS_CHILD | WS_VISIBLE | WS_CLIPCHILDREN,
-        0, 0, 400, 300,
-        parentHwnd,
-        nullptr,
-        GetModuleHandle(nullptr),
-        nullptr
-    );
-    
-    if (!m_hwndContainer) {
-        return false;
-    }
-    
-    // Try to create the eDrawings control
-    HRESULT hr = CoCreateInstance(
-        CLSID_EModelViewControl,
-        nullptr,
-        CLSCTX_INPROC_SERVER,
-        IID_IUnknown,
-        (void**)&m_pControl
-    );
-    
-    if (FAILED(hr) || !m_pControl) {
-        DestroyWindow(m_hwndContainer);
-        m_hwndContainer = nullptr;
-        return false;
-    }
-    
-    // Get IDispatch for calling methods
-    hr = m_pControl->QueryInterface(IID_IDispatch, (void**)&m_pDispatch);
-    if (FAILED(hr)) {
-        m_pControl->Release();
-        m_pControl = nullptr;
-        DestroyWindow(m_hwndContainer);
-        m_hwndContainer = nullptr;
-        return false;
-    }
-    
-    m_hwndParent = parentHwnd;
-    m_isAttached = true;
-    return true;
+    ReleaseControl();
 }
 
-void EDrawingsPreview::DestroyControl() {
-    if (m_pDispatch) {
-        m_pDispatch->Release();
-        m_pDispatch = nullptr;
-    }
-    if (m_pControl) {
-        m_pControl->Release();
-        m_pControl = nullptr;
-    }
-    if (m_hwndContainer) {
-        DestroyWindow(m_hwndContainer);
-        m_hwndContainer = nullptr;
+void EDrawingsPreview::ReleaseControl() {
+    StopBoundsSync();
+    if (m_session) {
+        // Fire and forget: parking the control never needs to block JS
+        std::shared_ptr<PreviewSession> session = m_session;
+        session->container = nullptr;
+        ComExecutor::Shared().Unbind(session->apartment);
+        session->apartment->Post([session]() {
+            if (session->HasControl()) {
+                ControlPool::Current().Release(session->control);
+            }
+            session->control = nullptr;
+            session->lease = 0;
+        });
+        m_session.reset();
     }
+    m_hwndParent = nullptr;
     m_isAttached = false;
     m_isFileLoaded = false;
 }
 
+void EDrawingsPreview::StopBoundsSync() {
+    if (m_boundsSync) BoundsSync::Shared().Remove(m_boundsSync);
+    m_boundsSync = 0;
+    m_boundsSlot.Reset();
+}
+
+bool EDrawingsPreview::WithContainer(std::function<void(HWND)> fn) {
+    if (!m_session) return false;
+    HWND container = m_session->container;
+    if (container) {
+        fn(container);
+        return true;
+    }
+    std::shared_ptr<PreviewSession> session = m_session;
+    return session->apartment->Post([session, fn]() {
+        if (session->HasControl()) fn(session->control->hwndContainer);
+    });
+}
+
+// Acquires the control on the preview's apartment and waits for it, so a
+// failed acquire (eDrawings missing, CreateControl failing) returns false.
+// A warm control from the pool makes this a re-parent, not a create.
 Napi::Value EDrawingsPreview::AttachToWindow(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
@@ -257,119 +754,463 @@ Napi::Value EDrawingsPreview::AttachToWindow(const Napi::CallbackInfo& info) {
     }
     
     // Get HWND from buffer or number
-    HWND hwnd = nullptr;
-    if (info[0].IsBuffer()) {
-        Napi::Buffer<uint8_t> buf = info[0].As<Napi::Buffer<uint8_t>>();
-        if (buf.Length() >= sizeof(HWND)) {
-            hwnd = *reinterpret_cast<HWND*>(buf.Data());
-        }
-    } else if (info[0].IsNumber()) {
-        hwnd = reinterpret_cast<HWND>(info[0].As<Napi::Number>().Int64Value());
-    }
+    HWND hwnd = HwndFromValue(info[0]);
     
     if (!hwnd || !IsWindow(hwnd)) {
         return Napi::Boolean::New(env, false);
     }
     
-    return Napi::Boolean::New(env, CreateControl(hwnd));
+    if (m_isAttached) return Napi::Boolean::New(env, true);
+    
+    // Its own apartment where possible, so side-by-side previews load in parallel
+    bool fresh = false;
+    StaThread* apartment = EnsurePreviewApartment() ? ComExecutor::Shared().Bind(&fresh) : nullptr;
+    if (!apartment) {
+        return Napi::Boolean::New(env, false);
+    }
+    ApartmentDefaults defaults = fresh ? g_apartmentDefaults : ApartmentDefaults();
+    
+    // Re-parent a warm control from the apartment's pool (or create one cold)
+    auto session = std::make_shared<PreviewSession>();
+    session->apartment = apartment;
+    int64_t started = NativeStats::Now();
+    bool acquired = false;
+    apartment->Invoke([&]() {
+        if (defaults.set) ControlPool::Current().SetResidentLimits(defaults.documents, defaults.bytes);
+        PooledControl* control = ControlPool::Current().Acquire(hwnd);
+        NativeStats::Record(NativeOp::AttachToWindow, started);
+        if (!control) return;
+        session->control = control;
+        session->lease = control->lease;
+        session->container = control->hwndContainer;
+        acquired = true;
+    });
+    if (!acquired) {
+        ComExecutor::Shared().Unbind(apartment);
+        return Napi::Boolean::New(env, false);
+    }
+    if (defaults.warmControls > 0) {
+        // Warm the grown apartment like the others, after this preview's
+        // own control, so the next preview bound here starts warm
+        size_t warm = defaults.warmControls;
+        apartment->Post([warm]() { ControlPool::Current().Prewarm(warm); });
+    }
+    
+    m_session = session;
+    m_hwndParent = hwnd;
+    m_isAttached = true;
+    return Napi::Boolean::New(env, true);
 }
 
 Napi::Value EDrawingsPreview::LoadFile(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!m_isAttached || !m_pDispatch) {
+    if (!m_isAttached || !m_session) {
         return Napi::Boolean::New(env, false);
     }
     
-    if (info.Length() < 1 || !info[0].IsString()) {
-        Napi::TypeError::New(env, "File path expected").ThrowAsJavaScriptException();
-        return Napi::Boolean::New(env, false);
+    std::wstring wFilePath;
+    if (!ReadArgs(info, "File path expected", &wFilePath)) return Napi::Boolean::New(env, false);
+    
+    // Synchronous by contract: blocks until OpenDoc returns. Prefer
+    // loadFileAsync, which never waits on the apartment.
+    ScopedNativeTimer timer(NativeOp::LoadFile);
+    HRESULT hr = E_HANDLE;
+    std::shared_ptr<PreviewSession> session = m_session;
+    session->apartment->Invoke([&]() {
+        if (!session->HasControl() || !session->control->pDispatch) return;
+        if (session->control->events) {
+            session->control->events->CancelPending(L"Superseded by a newer load");
+        }
+        // Only a finished copy: nothing would be left to wait for the
+        // completion of one still loading, or to report its result
+        bool ready = false;
+        if (AdoptLoadedDocument(session.get(), wFilePath, true, &ready)) {
+            hr = S_OK;
+            return;
+        }
+        ControlPool& pool = ControlPool::Current();
+        pool.CancelPreload(wFilePath);  // loading the same file; this open supersedes it
+        pool.BeginDocument(session->control);
+        hr = OpenDocOnControl(session->control, wFilePath);
+        pool.EndDocument(session->control, wFilePath, SUCCEEDED(hr));
+    });
+    
+    m_isFileLoaded = SUCCEEDED(hr);
+    return Napi::Boolean::New(env, m_isFileLoaded);
+}
+
+// JS-side state for one loadFileAsync call. Created and destroyed on the
+// JS thread; the apartment only ever sees it as an opaque pointer.
+struct AsyncLoadContext {
+    Napi::Promise::Deferred deferred;
+    Napi::ObjectReference preview;  // keeps the wrapper alive until settled
+    Napi::FunctionReference onEvent;
+    std::wstring path;
+};
+
+// Apartment-side reporter: forwards load events to JS through the TSFN and
+// releases it exactly once, even if the load is abandoned.
+class AsyncLoadReporter {
+public:
+    AsyncLoadReporter(Napi::ThreadSafeFunction tsfn, AsyncLoadContext* context, CancelTokenPtr token)
+        : m_tsfn(tsfn), m_context(context), m_token(std::move(token)), m_started(NativeStats::Now()) {}
+
+    ~AsyncLoadReporter() {
+        if (!m_done) {
+            LoadEvent abandoned;
+            abandoned.type = LoadEvent::Type::Failed;
+            abandoned.errorMessage = L"Load abandoned";
+            Send(abandoned);
+        }
     }
+
+    bool IsDone() const { return m_done; }
+    bool IsCancelled() const { return m_token->IsCancelled(); }
+
+    void Send(const LoadEvent& event) {
+        if (m_done) return;
+        bool final = event.type != LoadEvent::Type::Progress;
+
+        AsyncLoadContext* context = m_context;
+        LoadEvent* data = new LoadEvent(event);
+        napi_status status = m_tsfn.BlockingCall(data,
+            [context](Napi::Env env, Napi::Function, LoadEvent* ev) {
+                DeliverToJs(env, context, ev);
+                delete ev;
+            });
+        if (status != napi_ok) {
+            delete data;  // env is shutting down
+        }
+
+        if (final) {
+            m_done = true;
+            m_tsfn.Release();
+            NativeStats::Record(NativeOp::LoadFileAsync, m_started);
+        }
+    }
+
+private:
+    static void DeliverToJs(Napi::Env env, AsyncLoadContext* context, const LoadEvent* ev) {
+        if (env == nullptr) return;
+
+        const char* type = ev->type == LoadEvent::Type::Progress ? "progress"
+            : ev->type == LoadEvent::Type::Complete ? "complete" : "failed";
+
+        if (!context->onEvent.IsEmpty()) {
+            Napi::Object payload = Napi::Object::New(env);
+            payload.Set("type", Napi::String::New(env, type));
+            payload.Set("path", WideToJs(env, context->path));
+            if (ev->type == LoadEvent::Type::Progress) {
+                payload.Set("stage", WideToJs(env, ev->stage));
+            }
+            if (ev->type == LoadEvent::Type::Failed) {
+                payload.Set("code", Napi::Number::New(env, ev->errorCode));
+                payload.Set("message", WideToJs(env, ev->errorMessage));
+            }
+            context->onEvent.Call({ payload });
+        }
+
+        if (ev->type == LoadEvent::Type::Progress) return;
+
+        bool success = ev->type == LoadEvent::Type::Complete;
+        if (!context->preview.IsEmpty()) {
+            EDrawingsPreview::Unwrap(context->preview.Value())->SetFileLoaded(success);
+        }
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("success", Napi::Boolean::New(env, success));
+        if (!success) {
+            std::string message = WideToUtf8(ev->errorMessage);
+            result.Set("error", Napi::String::New(env, message.empty() ? "Failed to load document" : message));
+        }
+        context->deferred.Resolve(result);
+    }
+
+    Napi::ThreadSafeFunction m_tsfn;
+    AsyncLoadContext* m_context;
+    CancelTokenPtr m_token;  // registered until the reporter goes
+    int64_t m_started;
+    bool m_done = false;
+};
+
+// loadFileAsync(path, onEvent?, { jobId }?) -> Promise<{ success, error? }>
+// onEvent receives { type: 'progress' | 'complete' | 'failed', path, stage?, code?, message? }
+Napi::Value EDrawingsPreview::LoadFileAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
     
-    std::string filePath = info[0].As<Napi::String>().Utf8Value();
+    std::wstring path;
+    if (!ReadArgs(info, "File path expected", &path)) return env.Null();
     
-    // Convert to BSTR for COM
-    int wlen = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0);
-    std::wstring wFilePath(wlen - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &wFilePath[0], wlen);
+    JobOptions job;
+    if (info.Length() >= 3 && !ReadJobOptions(env, info[2], &job)) return env.Null();
     
-    BSTR bstrPath = SysAllocString(wFilePath.c_str());
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    
+    if (!m_isAttached || !m_session) {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("success", Napi::Boolean::New(env, false));
+        result.Set("error", Napi::String::New(env, "Preview not attached"));
+        deferred.Resolve(result);
+        return deferred.Promise();
+    }
+    
+    auto* context = new AsyncLoadContext{
+        deferred,
+        Napi::Persistent(Value()),
+        Napi::FunctionReference(),
+        path
+    };
+    
+    Napi::Function callback;
+    if (info.Length() >= 2 && info[1].IsFunction()) {
+        callback = info[1].As<Napi::Function>();
+        context->onEvent = Napi::Persistent(callback);
+    } else {
+        callback = Napi::Function::New(env, [](const Napi::CallbackInfo&) {});
+    }
     
-    // Call OpenDoc method via IDispatch
-    // Method ID for OpenDoc is typically 1 or we need to look it up
-    DISPID dispid;
-    LPOLESTR methodName = const_cast<LPOLESTR>(L"OpenDoc");
-    HRESULT hr = m_pDispatch->GetIDsOfNames(IID_NULL, &methodName, 1, 
-        LOCALE_USER_DEFAULT, &dispid);
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+        env, callback, "eDrawingsLoadFileAsync", 0, 1, context,
+        [](Napi::Env, AsyncLoadContext* ctx) {
+            ctx->preview.Reset();
+            ctx->onEvent.Reset();
+            delete ctx;
+        });
     
-    if (SUCCEEDED(hr)) {
-        DISPPARAMS params = {};
-        VARIANTARG arg;
-        VariantInit(&arg);
-        arg.vt = VT_BSTR;
-        arg.bstrVal = bstrPath;
-        params.cArgs = 1;
-        params.rgvarg = &arg;
+    std::shared_ptr<PreviewSession> session = m_session;
+    std::wstring wFilePath = context->path;
+    CancelTokenPtr token = CancelToken::Create(job.jobId, wFilePath);
+    auto reporter = std::make_shared<AsyncLoadReporter>(tsfn, context, token);
+    
+    // A cancel mid-load settles this load and drops the half-open document;
+    // one that arrives after a newer load took over finds the reporter done
+    std::weak_ptr<AsyncLoadReporter> weakReporter = reporter;
+    token->OnCancel([session, weakReporter]() {
+        session->apartment->Post([session, weakReporter]() {
+            std::shared_ptr<AsyncLoadReporter> pending = weakReporter.lock();
+            if (!pending || pending->IsDone() || !session->HasControl()) return;
+            PooledControl* control = session->control;
+            if (control->events) control->events->CancelPending(L"Cancelled");
+            DispatchValue unused;
+            unused.kind = DispatchValue::Kind::String;
+            InvokeControl(control, L"CloseActiveDoc", { unused });
+        });
+    });
+    
+    bool posted = session->apartment->Post([reporter, session, wFilePath]() {
+        if (reporter->IsCancelled()) {
+            LoadEvent ev;
+            ev.type = LoadEvent::Type::Failed;
+            ev.errorMessage = L"Cancelled";
+            reporter->Send(ev);
+            return;
+        }
+        if (!session->HasControl() || !session->control->pDispatch) {
+            LoadEvent ev;
+            ev.type = LoadEvent::Type::Failed;
+            ev.errorMessage = L"No eDrawings control (released, or could not be created)";
+            reporter->Send(ev);
+            return;
+        }
+        
+        if (session->control->events) {
+            session->control->events->CancelPending(L"Superseded by a newer load");
+        }
+        
+        LoadEvent progress;
+        progress.type = LoadEvent::Type::Progress;
+        progress.fileName = wFilePath;
+        progress.stage = L"open";
+        reporter->Send(progress);
+        
+        // A resident or prefetched copy skips OpenDoc entirely
+        bool ready = false;
+        bool adopted = AdoptLoadedDocument(session.get(), wFilePath, false, &ready);
+        PooledControl* control = session->control;
+        if (adopted && (ready || !control->events)) {
+            LoadEvent complete;
+            complete.type = LoadEvent::Type::Complete;
+            complete.fileName = wFilePath;
+            reporter->Send(complete);
+            return;
+        }
         
-        VARIANT result;
-        VariantInit(&result);
+        // Listen before calling OpenDoc: completion can fire inside the call
+        if (control->events) {
+            ControlEventSink* events = control->events;
+            events->SetListener([reporter, events, control, wFilePath](const LoadEvent& ev) {
+                // Progress passes straight through; only the final event settles
+                if (ev.type == LoadEvent::Type::Progress) {
+                    reporter->Send(ev);
+                    return;
+                }
+                events->SetListener(nullptr);
+                ControlPool::Current().EndDocument(control, wFilePath, ev.type == LoadEvent::Type::Complete);
+                reporter->Send(ev);
+            });
+        }
+        // Taken mid-load: the preload's OpenDoc already ran
+        if (adopted) return;
         
-        hr = m_pDispatch->Invoke(dispid, IID_NULL, LOCALE_USER_DEFAULT,
-            DISPATCH_METHOD, &params, &result, nullptr, nullptr);
+        ControlPool::Current().BeginDocument(control);
+        HRESULT hr = OpenDocOnControl(control, wFilePath);
         
-        VariantClear(&result);
+        if (FAILED(hr)) {
+            if (control->events) control->events->SetListener(nullptr);
+            ControlPool::Current().EndDocument(control, wFilePath, false);
+            LoadEvent failed;
+            failed.type = LoadEvent::Type::Failed;
+            failed.fileName = wFilePath;
+            failed.errorCode = hr;
+            failed.errorMessage = L"OpenDoc failed";
+            reporter->Send(failed);
+        } else if (!control->events) {
+            // No connection point: OpenDoc returning is all we can observe
+            ControlPool::Current().EndDocument(control, wFilePath, true);
+            LoadEvent complete;
+            complete.type = LoadEvent::Type::Complete;
+            complete.fileName = wFilePath;
+            reporter->Send(complete);
+        }
+    });
+    
+    if (!posted) {
+        LoadEvent ev;
+        ev.type = LoadEvent::Type::Failed;
+        ev.errorMessage = L"Preview apartment not running";
+        reporter->Send(ev);
     }
     
-    SysFreeString(bstrPath);
+    return deferred.Promise();
+}
+
+// invoke(methodName, ...args) -> result
+// Calls any control method or property through the cached DISPID table.
+// Synchronous by contract (it returns the value): blocks until the
+// apartment runs the call; throws on COM failure.
+Napi::Value EDrawingsPreview::Invoke(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
     
-    m_isFileLoaded = SUCCEEDED(hr);
-    return Napi::Boolean::New(env, m_isFileLoaded);
+    // Only the name is positional; the rest go to the member as they are
+    std::wstring name;
+    if (!ReadArgs(info, "Method name expected", &name)) return env.Undefined();
+    
+    if (!m_isAttached || !m_session) {
+        Napi::Error::New(env, "Preview not attached").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    
+    std::vector<DispatchValue> args(info.Length() - 1);
+    for (size_t i = 1; i < info.Length(); i++) {
+        if (!DispatchValueFromJs(info[i], &args[i - 1])) {
+            Napi::TypeError::New(env, "Arguments must be strings, numbers, booleans or null")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+    
+    ScopedNativeTimer timer(NativeOp::Invoke);
+    HRESULT hr = E_HANDLE;
+    DispatchValue result;
+    std::shared_ptr<PreviewSession> session = m_session;
+    session->apartment->Invoke([&]() {
+        if (!session->HasControl()) return;
+        hr = InvokeControl(session->control, name, args, &result);
+    });
+    
+    if (FAILED(hr)) {
+        char message[96];
+        snprintf(message, sizeof(message), "invoke(%s) failed: HRESULT 0x%08lX",
+            WideToUtf8(name).c_str(), static_cast<unsigned long>(hr));
+        Napi::Error::New(env, message).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    
+    return DispatchValueToJs(env, result);
 }
 
 Napi::Value EDrawingsPreview::SetBounds(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!m_hwndContainer) {
+    if (!m_session) {
         return Napi::Boolean::New(env, false);
     }
     
-    if (info.Length() < 4) {
-        Napi::TypeError::New(env, "x, y, width, height expected").ThrowAsJavaScriptException();
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    if (!ReadArgs(info, "x, y, width, height expected", &x, &y, &width, &height)) {
         return Napi::Boolean::New(env, false);
     }
     
-    int x = info[0].As<Napi::Number>().Int32Value();
-    int y = info[1].As<Napi::Number>().Int32Value();
-    int width = info[2].As<Napi::Number>().Int32Value();
-    int height = info[3].As<Napi::Number>().Int32Value();
-    
-    SetWindowPos(m_hwndContainer, nullptr, x, y, width, height, 
-        SWP_NOZORDER | SWP_NOACTIVATE);
+    // The container belongs to the apartment thread; post the move instead
+    // of waiting for it in case the apartment is busy inside OpenDoc
+    int64_t started = NativeStats::Now();
+    bool queued = WithContainer([x, y, width, height, started](HWND container) {
+        SetWindowPos(container, nullptr, x, y, width, height, 
+            SWP_NOZORDER | SWP_NOACTIVATE | SWP_ASYNCWINDOWPOS);
+        NativeStats::Record(NativeOp::SetBounds, started);
+    });
     
-    return Napi::Boolean::New(env, true);
+    return Napi::Boolean::New(env, queued);
 }
 
-Napi::Value EDrawingsPreview::Show(const Napi::CallbackInfo& info) {
+// syncBounds(slot: ArrayBuffer | null): move the container from a BoundsSlot
+// JS keeps writing (see bounds_sync.h) instead of per-call setBounds; null
+// stops. Replaces any slot given before.
+Napi::Value EDrawingsPreview::SyncBounds(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (m_hwndContainer) {
-        ShowWindow(m_hwndContainer, SW_SHOW);
+
+    if (info.Length() >= 1 && !info[0].IsNull() && !info[0].IsUndefined() && !info[0].IsArrayBuffer()) {
+        Napi::TypeError::New(env, "ArrayBuffer or null expected").ThrowAsJavaScriptException();
+        return Napi::Boolean::New(env, false);
+    }
+
+    StopBoundsSync();
+    if (info.Length() < 1 || !info[0].IsArrayBuffer()) {
         return Napi::Boolean::New(env, true);
     }
-    return Napi::Boolean::New(env, false);
+
+    Napi::ArrayBuffer buffer = info[0].As<Napi::ArrayBuffer>();
+    if (buffer.ByteLength() < sizeof(BoundsSlot)) {
+        Napi::RangeError::New(env, "Bounds slot must be at least 64 bytes").ThrowAsJavaScriptException();
+        return Napi::Boolean::New(env, false);
+    }
+    if (!m_session) {
+        return Napi::Boolean::New(env, false);
+    }
+
+    BoundsTarget target;
+    target.slot = static_cast<const BoundsSlot*>(buffer.Data());
+    target.apartment = m_session->apartment;
+    target.container = &m_session->container;
+    target.owner = m_session;
+    m_boundsSync = BoundsSync::Shared().Add(target);
+    if (m_boundsSync) m_boundsSlot = Napi::Persistent(buffer);
+    return Napi::Boolean::New(env, m_boundsSync != 0);
+}
+
+Napi::Value EDrawingsPreview::Show(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    bool queued = WithContainer([](HWND container) {
+        ShowWindowAsync(container, SW_SHOW);
+    });
+    return Napi::Boolean::New(env, queued);
 }
 
 Napi::Value EDrawingsPreview::Hide(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (m_hwndContainer) {
-        ShowWindow(m_hwndContainer, SW_HIDE);
-        return Napi::Boolean::New(env, true);
-    }
-    return Napi::Boolean::New(env, false);
+    bool queued = WithContainer([](HWND container) {
+        ShowWindowAsync(container, SW_HIDE);
+    });
+    return Napi::Boolean::New(env, queued);
 }
 
 Napi::Value EDrawingsPreview::Destroy(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    DestroyControl();
+    ReleaseControl();
     return Napi::Boolean::New(env, true);
 }
 
@@ -377,6 +1218,12 @@ Napi::Value EDrawingsPreview::IsLoaded(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(info.Env(), m_isFileLoaded);
 }
 
+// Index of the apartment this preview runs on, -1 while unattached
+Napi::Value EDrawingsPreview::GetApartment(const Napi::CallbackInfo& info) {
+    int index = m_session ? ComExecutor::Shared().IndexOf(m_session->apartment) : -1;
+    return Napi::Number::New(info.Env(), index);
+}
+
 // Module initialization
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     return EDrawingsPreview::Init(env, exports);
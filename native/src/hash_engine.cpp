@@ -0,0 +1,320 @@
+/**
+ * File Hashing Engine
+ */
+
+#include "hash_engine.h"
+
+#include <windows.h>
+#include <algorithm>
+
+#include "aligned_buffer_pool.h"
+#include "native_stats.h"
+#include "sha256.h"
+#include "unbuffered_io.h"
+
+// Large enough that per-read overhead vanishes next to the transfer, and a
+// multiple of every sector size, as unbuffered I/O requires
+static const DWORD kReadSize = 1024 * 1024;
+
+// Hashing is a fraction of a core per disk; past this the extra threads
+// only wait on the same completion port
+static const size_t kMinWorkers = 2;
+static const size_t kMaxWorkers = 16;
+static const size_t kMaxConcurrency = 64;
+
+// Completion keys: reads and admissions carry the FileRead's OVERLAPPED,
+// start packets the Job
+static const ULONG_PTR kReadKey = 0;
+static const ULONG_PTR kStartKey = 1;
+static const ULONG_PTR kShutdownKey = 2;
+static const ULONG_PTR kAdmitKey = 3;
+
+struct HashEngine::Job {
+    std::vector<std::wstring> paths;
+    ResultCallback onResult;
+    DoneCallback onDone;
+    CancelTokenPtr token;
+    JobPriority priority = JobPriority::Normal;
+    std::atomic<size_t> next{0};
+    // Each slot hashes files one after another; the job ends when the last
+    // slot runs out of paths
+    std::atomic<size_t> slots{0};
+};
+
+struct HashEngine::FileRead {
+    OVERLAPPED overlapped = {};  // first member: completions hand it back
+    Job* job = nullptr;
+    size_t index = 0;
+    HANDLE file = INVALID_HANDLE_VALUE;
+    uint8_t* buffer = nullptr;  // page-aligned, reused for every file in the slot
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    int64_t started = 0;  // QPC ticks at open, for the hashFile histogram
+    Sha256 sha;
+};
+
+HashEngine& HashEngine::Shared() {
+    static HashEngine engine;
+    return engine;
+}
+
+HashEngine::HashEngine()
+    : m_workerCount(std::clamp<size_t>(std::thread::hardware_concurrency(), kMinWorkers, kMaxWorkers)) {}
+
+HashEngine::~HashEngine() {
+    Shutdown();
+}
+
+bool HashEngine::EnsureStarted() {
+    // Caller holds m_mutex
+    if (m_port) return true;
+    m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, static_cast<DWORD>(m_workerCount));
+    if (!m_port) return false;
+    for (size_t i = 0; i < m_workerCount; i++) {
+        m_threads.emplace_back(&HashEngine::WorkerLoop, this);
+    }
+    return true;
+}
+
+void HashEngine::HashFiles(std::vector<std::wstring> paths, size_t concurrency,
+    ResultCallback onResult, DoneCallback onDone, CancelTokenPtr token, JobPriority priority) {
+    auto* job = new Job();
+    job->paths = std::move(paths);
+    job->onResult = std::move(onResult);
+    job->onDone = std::move(onDone);
+    job->token = std::move(token);
+    job->priority = priority;
+
+    if (concurrency == 0) concurrency = m_workerCount * 2;
+    size_t slots = std::min(std::clamp<size_t>(concurrency, 1, kMaxConcurrency), job->paths.size());
+
+    bool started = false;
+    if (slots > 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stopping && EnsureStarted()) {
+            m_activeJobs++;
+            started = true;
+        }
+    }
+
+    if (!started) {
+        for (size_t i = 0; i < job->paths.size(); i++) {
+            FileHash result;
+            result.error = "Hashing engine not running";
+            job->onResult(i, std::move(result));
+        }
+        job->onDone();
+        delete job;
+        return;
+    }
+
+    // Files are opened on the workers, never on the caller's thread
+    job->slots = slots;
+    for (size_t i = 0; i < slots; i++) {
+        PostQueuedCompletionStatus(m_port, 0, kStartKey, reinterpret_cast<LPOVERLAPPED>(job));
+    }
+}
+
+void HashEngine::Shutdown() {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        // In-flight reads still target slot buffers; let them land first
+        m_idle.wait(lock, [this]() { return m_activeJobs == 0; });
+    }
+    if (m_port) {
+        for (size_t i = 0; i < m_threads.size(); i++) {
+            PostQueuedCompletionStatus(m_port, 0, kShutdownKey, nullptr);
+        }
+    }
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_threads.clear();
+    if (m_port) {
+        CloseHandle(m_port);
+        m_port = nullptr;
+    }
+}
+
+void HashEngine::WorkerLoop() {
+    for (;;) {
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = nullptr;
+        BOOL ok = GetQueuedCompletionStatus(m_port, &bytes, &key, &overlapped, INFINITE);
+        DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+
+        if (!overlapped || key == kShutdownKey) {
+            // Port closed or shutdown requested
+            if (key == kShutdownKey || !ok) return;
+            continue;
+        }
+        if (key == kStartKey) {
+            RunSlot(reinterpret_cast<Job*>(overlapped));
+            continue;
+        }
+        if (key == kAdmitKey) {
+            ContinueSlot(CONTAINING_RECORD(overlapped, FileRead, overlapped));
+            continue;
+        }
+        OnReadComplete(CONTAINING_RECORD(overlapped, FileRead, overlapped), ok != FALSE, bytes, error);
+    }
+}
+
+void HashEngine::RunSlot(Job* job) {
+    auto* read = new FileRead();
+    read->job = job;
+    read->buffer = AlignedBufferPool::Shared().Acquire(kReadSize);
+    if (!read->buffer) {
+        // The slot's paths are picked up by the others, or failed by the
+        // last one to retire
+        delete read;
+        RetireSlot(job);
+        return;
+    }
+    AdmitNext(read);
+}
+
+void HashEngine::AdmitNext(FileRead* read) {
+    // The pool only orders the turn; the open and the reads stay on this
+    // engine's port. Shutdown stops the pool after this engine, so a queued
+    // turn always arrives (and sees m_stopping).
+    ThreadPool::Shared().Submit([this, read]() {
+        PostQueuedCompletionStatus(m_port, 0, kAdmitKey, &read->overlapped);
+    }, read->job->priority);
+}
+
+void HashEngine::ContinueSlot(FileRead* read) {
+    // Loop rather than recurse: files that fail synchronously move straight
+    // on to the next path
+    Job* job = read->job;
+    while (OpenNext(job, read)) {
+        if (IssueRead(read)) return;
+    }
+
+    AlignedBufferPool::Shared().Release(read->buffer, kReadSize);
+    delete read;
+    RetireSlot(job);
+}
+
+bool HashEngine::IsCancelled(Job* job, size_t index) const {
+    return m_stopping || (job->token && job->token->IsCancelled(job->paths[index]));
+}
+
+bool HashEngine::OpenNext(Job* job, FileRead* read) {
+    for (;;) {
+        size_t index = job->next++;
+        if (index >= job->paths.size()) return false;
+
+        FileHash result;
+        if (IsCancelled(job, index)) {
+            result.error = kCancelledError;
+            job->onResult(index, std::move(result));
+            continue;
+        }
+
+        read->started = NativeStats::Now();
+        HANDLE file = OpenForUnbufferedRead(job->paths[index]);
+        if (file == INVALID_HANDLE_VALUE) {
+            DWORD error = GetLastError();
+            result.error = error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND
+                ? "File not found" : "Could not open file";
+            job->onResult(index, std::move(result));
+            continue;
+        }
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(file, &size) || !CreateIoCompletionPort(file, m_port, kReadKey, 0)) {
+            CloseHandle(file);
+            result.error = "Could not open file";
+            job->onResult(index, std::move(result));
+            continue;
+        }
+
+        read->index = index;
+        read->file = file;
+        read->offset = 0;
+        read->size = static_cast<uint64_t>(size.QuadPart);
+        read->sha.Reset();
+
+        if (read->size == 0) {
+            ReportFile(read, nullptr);
+            continue;
+        }
+        return true;
+    }
+}
+
+bool HashEngine::IssueRead(FileRead* read) {
+    ZeroMemory(&read->overlapped, sizeof(read->overlapped));
+    read->overlapped.Offset = static_cast<DWORD>(read->offset);
+    read->overlapped.OffsetHigh = static_cast<DWORD>(read->offset >> 32);
+
+    // Success and ERROR_IO_PENDING both still post a completion packet
+    if (ReadFile(read->file, read->buffer, kReadSize, nullptr, &read->overlapped)) return true;
+    DWORD error = GetLastError();
+    if (error == ERROR_IO_PENDING) return true;
+
+    // Failed synchronously: no packet will come. EOF here means the file
+    // shrank since it was opened.
+    ReportFile(read, error == ERROR_HANDLE_EOF ? nullptr : "Read failed");
+    return false;
+}
+
+void HashEngine::OnReadComplete(FileRead* read, bool ok, unsigned long bytes, unsigned long error) {
+    if (!ok && error != ERROR_HANDLE_EOF) {
+        ReportFile(read, "Read failed");
+        AdmitNext(read);
+        return;
+    }
+
+    if (bytes > 0) {
+        read->sha.Update(read->buffer, bytes);
+        read->offset += bytes;
+    }
+
+    // A short or empty read is end of file, even if the file shrank
+    if (!ok || bytes < kReadSize || read->offset >= read->size) {
+        ReportFile(read, nullptr);
+    } else if (IsCancelled(read->job, read->index)) {
+        ReportFile(read, kCancelledError);
+    } else if (IssueRead(read)) {
+        return;
+    }
+    AdmitNext(read);
+}
+
+void HashEngine::ReportFile(FileRead* read, const char* error) {
+    CloseHandle(read->file);
+    read->file = INVALID_HANDLE_VALUE;
+
+    FileHash result;
+    result.size = read->offset;
+    if (error) {
+        result.error = error;
+    } else {
+        result.success = true;
+        result.hash = read->sha.FinalHex();
+    }
+    NativeStats::Record(NativeOp::HashFile, read->started);
+    read->job->onResult(read->index, std::move(result));
+}
+
+void HashEngine::RetireSlot(Job* job) {
+    if (--job->slots > 0) return;
+
+    // Last slot out: fail whatever no slot was able to take (every slot's
+    // buffer allocation failed), so each path still gets a result
+    for (size_t index = job->next++; index < job->paths.size(); index = job->next++) {
+        FileHash result;
+        result.error = "Out of memory";
+        job->onResult(index, std::move(result));
+    }
+    job->onDone();
+    delete job;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_activeJobs--;
+    m_idle.notify_all();
+}
@@ -0,0 +1,88 @@
+/**
+ * File Hashing Engine
+ *
+ * SHA-256 of many files at disk speed. Files are opened unbuffered and
+ * overlapped (FILE_FLAG_NO_BUFFERING, so a vault scan doesn't flush the
+ * system cache) and every read completes on one shared I/O completion
+ * port. A small set of worker threads sized to the cores hashes each
+ * chunk as it lands and immediately queues the next read, so the disk
+ * never waits on the CPU and vice versa.
+ *
+ * Each request keeps `concurrency` files in flight, with one read
+ * outstanding per file. Before a slot opens its next file it waits for a
+ * turn on the shared ThreadPool at the request's priority, so visible work
+ * overtakes a prefetch hash at file boundaries. N-API free; callbacks run
+ * on the engine's threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "job_registry.h"
+#include "thread_pool.h"
+
+struct FileHash {
+    bool success = false;
+    std::string error;
+    std::string hash;  // lowercase hex
+    uint64_t size = 0;
+};
+
+class HashEngine {
+public:
+    // Called once per file, in completion order, from an engine thread
+    using ResultCallback = std::function<void(size_t index, FileHash&& result)>;
+    // Called once after the last result
+    using DoneCallback = std::function<void()>;
+
+    static HashEngine& Shared();
+
+    // Queue a set of files; returns immediately. concurrency is clamped to
+    // 1-64 files in flight (0 picks twice the worker count). Files the token
+    // cancels fail as "Cancelled", mid-file ones at their next read.
+    void HashFiles(std::vector<std::wstring> paths, size_t concurrency,
+        ResultCallback onResult, DoneCallback onDone, CancelTokenPtr token = nullptr,
+        JobPriority priority = JobPriority::Normal);
+
+    // Fail remaining files as cancelled, wait for in-flight reads and join
+    // the workers. HashFiles after this reports every file as failed.
+    void Shutdown();
+
+    size_t WorkerCount() const { return m_workerCount; }
+
+private:
+    struct Job;
+    struct FileRead;
+
+    HashEngine();
+    ~HashEngine();
+
+    bool EnsureStarted();
+    void WorkerLoop();
+
+    void RunSlot(Job* job);
+    void AdmitNext(FileRead* read);
+    void ContinueSlot(FileRead* read);
+    bool IsCancelled(Job* job, size_t index) const;
+    bool OpenNext(Job* job, FileRead* read);
+    bool IssueRead(FileRead* read);
+    void OnReadComplete(FileRead* read, bool ok, unsigned long bytes, unsigned long error);
+    void ReportFile(FileRead* read, const char* error);
+    void RetireSlot(Job* job);
+
+    size_t m_workerCount;
+    void* m_port = nullptr;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_idle;
+    size_t m_activeJobs = 0;
+    std::atomic<bool> m_stopping{false};
+};
@@ -0,0 +1,168 @@
+/**
+ * Hashing Bindings
+ *
+ * hashFiles(paths[], { algo, concurrency, batchSize, jobId }, onBatch) -> Promise<HashSummary>
+ *
+ * Files are hashed on the HashEngine's completion-port workers. Results are
+ * not held until the end: every `batchSize` completions go to onBatch in
+ * one call on the JS thread, each entry tagged with its input index since
+ * files finish out of order. The promise resolves after the last batch
+ * with totals only.
+ */
+
+#include "addon.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "hash_engine.h"
+#include "sha256.h"
+
+static const uint32_t kDefaultBatchSize = 256;
+static const uint32_t kMaxBatchSize = 4096;
+static const uint32_t kMaxConcurrency = 64;
+
+struct HashEntry {
+    size_t index;
+    FileHash result;
+};
+
+struct HashBatch {
+    std::vector<std::wstring> paths;  // echoed back as given
+    size_t batchSize = kDefaultBatchSize;
+    Napi::FunctionReference onBatch;  // JS thread only
+    AsyncCompletion* completion = nullptr;
+    std::chrono::steady_clock::time_point started;
+
+    std::mutex mutex;
+    std::vector<HashEntry> pending;
+    size_t hashed = 0;
+    size_t failed = 0;
+    size_t cancelled = 0;  // included in failed
+    uint64_t bytes = 0;
+};
+
+static Napi::Array BuildHashEntries(Napi::Env env, HashBatch* batch, std::vector<HashEntry>& entries) {
+    Napi::Array array = Napi::Array::New(env, entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        HashEntry& entry = entries[i];
+        Napi::Object object = Napi::Object::New(env);
+        object.Set("index", Napi::Number::New(env, static_cast<double>(entry.index)));
+        object.Set("path", WideToJs(env, batch->paths[entry.index]));
+        object.Set("success", Napi::Boolean::New(env, entry.result.success));
+        object.Set("size", Napi::Number::New(env, static_cast<double>(entry.result.size)));
+        if (entry.result.success) {
+            object.Set("hash", Napi::String::New(env, entry.result.hash));
+        } else {
+            object.Set("error", Napi::String::New(env, entry.result.error));
+        }
+        array.Set(static_cast<uint32_t>(i), object);
+    }
+    return array;
+}
+
+// Hand a batch to onBatch on the JS thread; any engine thread
+static void EmitEntries(const std::shared_ptr<HashBatch>& batch, std::vector<HashEntry>&& entries) {
+    if (entries.empty()) return;
+    auto moved = std::make_shared<std::vector<HashEntry>>(std::move(entries));
+    batch->completion->Emit([batch, moved](Napi::Env env) {
+        if (batch->onBatch.IsEmpty()) return;
+        batch->onBatch.Call({ BuildHashEntries(env, batch.get(), *moved) });
+    });
+}
+
+// hashFiles(paths: string[] | path table, options?: { algo?: 'sha256', concurrency?: number, batchSize?: number },
+//           onBatch?: (entries) => void)
+static Napi::Value HashFiles(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto batch = std::make_shared<HashBatch>();
+    if (!ReadPathTable(info[0], &batch->paths)) return env.Null();
+    std::vector<std::wstring> paths = batch->paths;
+
+    size_t concurrency = 0;
+    JobOptions job;
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        Napi::Value algo = options.Get("algo");
+        if (!algo.IsUndefined()) {
+            std::string name = algo.IsString() ? algo.As<Napi::String>().Utf8Value() : "";
+            std::transform(name.begin(), name.end(), name.begin(),
+                [](unsigned char c) { return static_cast<char>(tolower(c)); });
+            if (name != "sha256" && name != "sha-256") {
+                Napi::TypeError::New(env, "Unsupported hash algorithm").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+        }
+        Napi::Value value = options.Get("concurrency");
+        if (value.IsNumber()) {
+            concurrency = std::clamp<uint32_t>(value.As<Napi::Number>().Uint32Value(), 1, kMaxConcurrency);
+        }
+        value = options.Get("batchSize");
+        if (value.IsNumber()) {
+            batch->batchSize = std::clamp<uint32_t>(value.As<Napi::Number>().Uint32Value(), 1, kMaxBatchSize);
+        }
+        if (!ReadJobOptions(env, options, &job)) return env.Null();
+    }
+
+    if (info.Length() >= 3 && info[2].IsFunction()) {
+        batch->onBatch = Napi::Persistent(info[2].As<Napi::Function>());
+    }
+
+    batch->completion = AsyncCompletion::Create(env, "hashFiles");
+    batch->started = std::chrono::steady_clock::now();
+    Napi::Promise promise = batch->completion->Promise();
+
+    CancelTokenPtr token = CancelToken::Create(job.jobId, paths);
+    HashEngine::Shared().HashFiles(std::move(paths), concurrency,
+        [batch](size_t index, FileHash&& result) {
+            std::vector<HashEntry> ready;
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (result.success) {
+                    batch->hashed++;
+                    batch->bytes += result.size;
+                } else {
+                    batch->failed++;
+                    if (result.error == kCancelledError) batch->cancelled++;
+                }
+                batch->pending.push_back({ index, std::move(result) });
+                if (batch->pending.size() >= batch->batchSize) ready.swap(batch->pending);
+            }
+            EmitEntries(batch, std::move(ready));
+        },
+        [batch]() {
+            std::vector<HashEntry> ready;
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                ready.swap(batch->pending);
+            }
+            EmitEntries(batch, std::move(ready));
+
+            double elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - batch->started).count();
+            // Queued after every batch, so onBatch has seen all results
+            batch->completion->Resolve([batch, elapsedMs](Napi::Env env) {
+                batch->onBatch.Reset();
+                Napi::Object summary = Napi::Object::New(env);
+                summary.Set("hashed", Napi::Number::New(env, static_cast<double>(batch->hashed)));
+                summary.Set("failed", Napi::Number::New(env, static_cast<double>(batch->failed)));
+                summary.Set("cancelled", Napi::Number::New(env, static_cast<double>(batch->cancelled)));
+                summary.Set("bytes", Napi::Number::New(env, static_cast<double>(batch->bytes)));
+                summary.Set("elapsedMs", Napi::Number::New(env, elapsedMs));
+                summary.Set("accelerated", Napi::Boolean::New(env, Sha256::IsHardwareAccelerated()));
+                return summary;
+            });
+        }, std::move(token), job.priority);
+
+    return promise;
+}
+
+void InitHashBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("hashFiles", Napi::Function::New(env, HashFiles));
+}
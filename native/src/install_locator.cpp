@@ -0,0 +1,198 @@
+/**
+ * eDrawings Install Locator
+ */
+
+#include "install_locator.h"
+
+#include <shlwapi.h>
+#include <vector>
+
+#pragma comment(lib, "shlwapi.lib")
+#pragma comment(lib, "version.lib")
+
+// The control ControlPool creates (CLSID_EModelViewControl)
+static const wchar_t* kControlServerKey =
+    L"SOFTWARE\\Classes\\CLSID\\{22945A69-1191-4DCF-9E6F-409BDE94D101}\\InprocServer32";
+static const wchar_t* kGeneralKey = L"SOFTWARE\\SolidWorks\\eDrawings\\General";
+static const wchar_t* kWatchKey = L"SOFTWARE\\SolidWorks";
+static const wchar_t* kWatchParentKey = L"SOFTWARE";
+
+// Last resort when the registry has nothing
+static const wchar_t* const kKnownExePaths[] = {
+    L"C:\\Program Files\\SOLIDWORKS Corp\\eDrawings\\eDrawings.exe",
+    L"C:\\Program Files\\eDrawings\\eDrawings.exe",
+    L"C:\\Program Files (x86)\\eDrawings\\eDrawings.exe",
+    L"C:\\Program Files\\SOLIDWORKS Corp\\SOLIDWORKS\\eDrawings\\eDrawings.exe",
+};
+
+// How long Get() waits for the watcher to arm before resolving anyway
+static const DWORD kArmTimeoutMs = 1000;
+
+// String value from HKLM (64-bit view), environment references expanded
+static bool ReadRegistryString(const wchar_t* subKey, const wchar_t* name, std::wstring* out) {
+    DWORD bytes = 0;
+    const DWORD flags = RRF_RT_REG_SZ | RRF_RT_REG_EXPAND_SZ | RRF_SUBKEY_WOW6464KEY;
+    if (RegGetValueW(HKEY_LOCAL_MACHINE, subKey, name, flags, nullptr, nullptr, &bytes) != ERROR_SUCCESS ||
+        bytes < sizeof(wchar_t)) {
+        return false;
+    }
+    std::vector<wchar_t> buffer(bytes / sizeof(wchar_t) + 1);
+    bytes = static_cast<DWORD>(buffer.size() * sizeof(wchar_t));
+    if (RegGetValueW(HKEY_LOCAL_MACHINE, subKey, name, flags, nullptr, buffer.data(), &bytes) != ERROR_SUCCESS) {
+        return false;
+    }
+    out->assign(buffer.data());
+    return !out->empty();
+}
+
+static std::wstring FileVersion(const std::wstring& path) {
+    DWORD ignored = 0;
+    DWORD size = GetFileVersionInfoSizeW(path.c_str(), &ignored);
+    if (size == 0) return std::wstring();
+
+    std::vector<uint8_t> data(size);
+    VS_FIXEDFILEINFO* info = nullptr;
+    UINT length = 0;
+    if (!GetFileVersionInfoW(path.c_str(), 0, size, data.data()) ||
+        !VerQueryValueW(data.data(), L"\\", reinterpret_cast<void**>(&info), &length) ||
+        length < sizeof(VS_FIXEDFILEINFO)) {
+        return std::wstring();
+    }
+
+    wchar_t version[48];
+    swprintf_s(version, L"%u.%u.%u.%u", HIWORD(info->dwFileVersionMS), LOWORD(info->dwFileVersionMS),
+        HIWORD(info->dwFileVersionLS), LOWORD(info->dwFileVersionLS));
+    return version;
+}
+
+InstallLocator& InstallLocator::Shared() {
+    static InstallLocator locator;
+    return locator;
+}
+
+EDrawingsInstall InstallLocator::Resolve() {
+    EDrawingsInstall install;
+
+    std::wstring server;
+    if (ReadRegistryString(kControlServerKey, nullptr, &server)) {
+        PathUnquoteSpacesW(&server[0]);
+        server.resize(wcslen(server.c_str()));
+        if (PathFileExistsW(server.c_str())) {
+            install.controlPath = server;
+            install.source = "clsid";
+        }
+    }
+
+    std::wstring folder;
+    if (ReadRegistryString(kGeneralKey, L"InstallPath", &folder)) {
+        std::wstring exe = folder;
+        if (exe.back() != L'\\') exe += L'\\';
+        exe += L"eDrawings.exe";
+        install.path = PathFileExistsW(exe.c_str()) ? exe : folder;
+        if (install.controlPath.empty()) install.source = "registry";
+    } else if (!install.controlPath.empty()) {
+        // No InstallPath: the exe ships next to the control
+        std::wstring exe = install.controlPath;
+        PathRemoveFileSpecW(&exe[0]);
+        exe.resize(wcslen(exe.c_str()));
+        exe += L"\\eDrawings.exe";
+        install.path = PathFileExistsW(exe.c_str()) ? exe : install.controlPath;
+    } else {
+        for (const wchar_t* path : kKnownExePaths) {
+            if (PathFileExistsW(path)) {
+                install.path = path;
+                install.source = "path";
+                break;
+            }
+        }
+    }
+
+    install.installed = !install.path.empty();
+    if (install.installed) {
+        install.version = FileVersion(install.controlPath.empty() ? install.path : install.controlPath);
+    }
+    return install;
+}
+
+EDrawingsInstall InstallLocator::Get(bool refresh) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) StartWatchLocked();
+    if (m_armed) {
+        // Arm before resolving, so a change made while we look is not missed
+        HANDLE armed = m_armed;
+        lock.unlock();
+        WaitForSingleObject(armed, kArmTimeoutMs);
+        lock.lock();
+    }
+
+    if (refresh || !m_valid) {
+        m_cached = Resolve();
+        m_valid = m_watching;
+    }
+    return m_cached;
+}
+
+void InstallLocator::StartWatchLocked() {
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_armed = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent || !m_armed) return;
+    m_thread = std::thread(&InstallLocator::WatchLoop, this);
+}
+
+void InstallLocator::Stop() {
+    // Join outside the lock: the watcher takes it to record a change
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        thread.swap(m_thread);
+        if (m_stopEvent) SetEvent(m_stopEvent);
+    }
+    if (thread.joinable()) thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopEvent) CloseHandle(m_stopEvent);
+    if (m_armed) CloseHandle(m_armed);
+    m_stopEvent = nullptr;
+    m_armed = nullptr;
+    m_watching = false;
+    m_valid = false;
+}
+
+// RegNotifyChangeKeyValue notifications belong to the thread that asked,
+// so they are armed (and re-armed after each change) only here
+void InstallLocator::WatchLoop() {
+    HANDLE changed = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+    for (;;) {
+        // Until SolidWorks has a key, watch for it to be created
+        HKEY key = nullptr;
+        bool subtree = RegOpenKeyExW(HKEY_LOCAL_MACHINE, kWatchKey, 0,
+            KEY_NOTIFY | KEY_WOW64_64KEY, &key) == ERROR_SUCCESS;
+        if (!subtree && RegOpenKeyExW(HKEY_LOCAL_MACHINE, kWatchParentKey, 0,
+                KEY_NOTIFY | KEY_WOW64_64KEY, &key) != ERROR_SUCCESS) {
+            key = nullptr;
+        }
+        bool armed = changed && key && RegNotifyChangeKeyValue(key, subtree ? TRUE : FALSE,
+            REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET, changed, TRUE) == ERROR_SUCCESS;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_watching = armed;
+            if (!armed) m_valid = false;
+        }
+        SetEvent(m_armed);
+        if (!armed) {
+            if (key) RegCloseKey(key);
+            break;
+        }
+
+        HANDLE handles[2] = { m_stopEvent, changed };
+        DWORD wait = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        RegCloseKey(key);
+        if (wait != WAIT_OBJECT_0 + 1) break;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_valid = false;
+    }
+
+    if (changed) CloseHandle(changed);
+}
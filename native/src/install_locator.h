@@ -0,0 +1,63 @@
+/**
+ * eDrawings Install Locator
+ *
+ * Finds the eDrawings install once and remembers it: the control's
+ * registered server (HKLM CLSID InprocServer32), the InstallPath the
+ * installer writes, and only if both are missing the well-known folders.
+ * The version comes from the control DLL's version resource (eDrawings.exe
+ * when the control isn't registered).
+ *
+ * The answer stays cached until the registry says otherwise: a watcher
+ * thread sits in RegNotifyChangeKeyValue on HKLM\SOFTWARE\SolidWorks (or on
+ * HKLM\SOFTWARE until that key exists), and any change there drops the
+ * cache for the next Get() to resolve again. No polling, and no file probes
+ * on a warm call. If the watch can't be armed, every Get() resolves afresh.
+ *
+ * Thread-safe. N-API free.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct EDrawingsInstall {
+    bool installed = false;
+    std::wstring path;         // eDrawings.exe, or the install folder if no exe was found
+    std::wstring controlPath;  // the registered control DLL; empty if not registered
+    std::wstring version;      // "major.minor.build.revision"; empty if unreadable
+    const char* source = "";   // "clsid", "registry" or "path"
+};
+
+class InstallLocator {
+public:
+    static InstallLocator& Shared();
+
+    // Cached install; resolves (and starts the watcher) on first use.
+    // refresh re-resolves even if nothing changed.
+    EDrawingsInstall Get(bool refresh = false);
+
+    // Stop and join the watcher
+    void Stop();
+
+private:
+    InstallLocator() = default;
+    InstallLocator(const InstallLocator&) = delete;
+    InstallLocator& operator=(const InstallLocator&) = delete;
+
+    static EDrawingsInstall Resolve();
+    void StartWatchLocked();
+    void WatchLoop();
+
+    std::mutex m_mutex;
+    EDrawingsInstall m_cached;
+    bool m_valid = false;
+    bool m_watching = false;  // a change notification is armed
+
+    std::thread m_thread;
+    HANDLE m_stopEvent = nullptr;
+    HANDLE m_armed = nullptr;   // set once the first watch is armed (or failed)
+};
@@ -0,0 +1,161 @@
+/**
+ * Job Registry
+ */
+
+#include "job_registry.h"
+
+#include <windows.h>
+#include <algorithm>
+
+const char* const kCancelledError = "Cancelled";
+
+// Lowercase, backslashes, no \\?\ prefix, no trailing separator, so
+// prefix tests are plain string compares
+static std::wstring NormalizePath(const std::wstring& path) {
+    std::wstring normalized = path;
+    std::replace(normalized.begin(), normalized.end(), L'/', L'\\');
+    if (normalized.compare(0, 4, L"\\\\?\\") == 0) normalized.erase(0, 4);
+    while (!normalized.empty() && normalized.back() == L'\\') normalized.pop_back();
+    if (!normalized.empty()) {
+        CharLowerBuffW(&normalized[0], static_cast<DWORD>(normalized.size()));
+    }
+    return normalized;
+}
+
+// path is folder or somewhere below it; both normalized
+static bool IsUnder(const std::wstring& path, const std::wstring& folder) {
+    if (path.size() < folder.size() || path.compare(0, folder.size(), folder) != 0) return false;
+    return path.size() == folder.size() || path[folder.size()] == L'\\';
+}
+
+static std::wstring CommonDirectory(const std::vector<std::wstring>& paths) {
+    if (paths.empty()) return std::wstring();
+    std::wstring common = NormalizePath(paths.front());
+    if (paths.size() == 1) return common;
+
+    for (size_t i = 1; i < paths.size() && !common.empty(); i++) {
+        std::wstring path = NormalizePath(paths[i]);
+        size_t length = 0;
+        size_t limit = std::min(common.size(), path.size());
+        while (length < limit && common[length] == path[length]) length++;
+        // Keep the match only if it ends on a name boundary in both paths
+        bool commonEnds = length == common.size() || common[length] == L'\\';
+        bool pathEnds = length == path.size() || path[length] == L'\\';
+        if (!(commonEnds && pathEnds)) {
+            size_t separator = length == 0 ? std::wstring::npos : common.rfind(L'\\', length - 1);
+            length = separator == std::wstring::npos ? 0 : separator;
+        }
+        common.resize(length);
+    }
+    return common;
+}
+
+std::shared_ptr<CancelToken> CancelToken::Create(uint64_t id, const std::vector<std::wstring>& paths) {
+    std::shared_ptr<CancelToken> token(new CancelToken(id, CommonDirectory(paths)));
+    JobRegistry::Shared().Add(token.get());
+    return token;
+}
+
+std::shared_ptr<CancelToken> CancelToken::Create(uint64_t id, const std::wstring& path) {
+    return Create(id, std::vector<std::wstring>{ path });
+}
+
+CancelToken::CancelToken(uint64_t id, std::wstring commonPrefix)
+    : m_id(id), m_commonPrefix(std::move(commonPrefix)) {}
+
+CancelToken::~CancelToken() {
+    JobRegistry::Shared().Remove(this);
+}
+
+bool CancelToken::IsCancelled(const std::wstring& path) const {
+    if (IsCancelled()) return true;
+    if (!m_hasFolders.load(std::memory_order_acquire)) return false;
+
+    std::wstring normalized = NormalizePath(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::wstring& folder : m_folders) {
+        if (IsUnder(normalized, folder)) return true;
+    }
+    return false;
+}
+
+void CancelToken::OnCancel(std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!IsCancelled()) {
+            m_onCancel = std::move(fn);
+            return;
+        }
+    }
+    fn();
+}
+
+bool CancelToken::CancelAll() {
+    std::function<void()> onCancel;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cancelled.exchange(true, std::memory_order_acq_rel)) return false;
+        onCancel = std::move(m_onCancel);
+    }
+    if (onCancel) onCancel();
+    return true;
+}
+
+bool CancelToken::CancelFolder(const std::wstring& folder) {
+    // Every path is under the folder: same as cancelling the job
+    if (IsUnder(m_commonPrefix, folder)) return CancelAll();
+    // The folder is not under the paths' common directory: no path can match
+    if (!m_commonPrefix.empty() && !IsUnder(folder, m_commonPrefix)) return false;
+    if (IsCancelled()) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_folders.push_back(folder);
+    m_hasFolders.store(true, std::memory_order_release);
+    return true;
+}
+
+JobRegistry& JobRegistry::Shared() {
+    static JobRegistry registry;
+    return registry;
+}
+
+void JobRegistry::Add(CancelToken* token) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tokens.push_back(token);
+}
+
+void JobRegistry::Remove(CancelToken* token) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find(m_tokens.begin(), m_tokens.end(), token);
+    if (it == m_tokens.end()) return;
+    *it = m_tokens.back();
+    m_tokens.pop_back();
+}
+
+bool JobRegistry::CancelJob(uint64_t id) {
+    if (id == 0) return false;
+    // Held throughout so no token can be destroyed mid-cancel
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool cancelled = false;
+    for (CancelToken* token : m_tokens) {
+        if (token->Id() == id) cancelled = token->CancelAll() || cancelled;
+    }
+    return cancelled;
+}
+
+size_t JobRegistry::CancelUnder(const std::wstring& folder) {
+    std::wstring normalized = NormalizePath(folder);
+    if (normalized.empty()) return 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t affected = 0;
+    for (CancelToken* token : m_tokens) {
+        if (token->CancelFolder(normalized)) affected++;
+    }
+    return affected;
+}
+
+size_t JobRegistry::ActiveCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tokens.size();
+}
@@ -0,0 +1,105 @@
+/**
+ * Job Registry
+ *
+ * Every native async job (load, render, thumbnails, hashing, lock probes)
+ * carries a CancelToken registered here while it is alive. Tokens are
+ * cancelled either whole, by the id JS gave the job (cancelJob), or per
+ * path, by folder (cancelJobsUnder): a batch spanning several folders
+ * drops only the files under the cancelled one.
+ *
+ * Cancellation is cooperative. Jobs check their token before each file and
+ * the hash engine checks it between reads, so a running job stops at its
+ * next checkpoint and reports "Cancelled" for the rest. Work that cannot be
+ * interrupted (a shell thumbnail handler, OpenDoc) finishes its current
+ * file. Jobs that need more than polling register an OnCancel hook.
+ *
+ * Priorities order the worker pool queue (see thread_pool.h).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class JobPriority : uint8_t {
+    Visible,   // on screen now: runs before anything else queued
+    Normal,
+    Prefetch,  // speculative: never takes the last free worker
+};
+
+static const size_t kJobPriorityCount = 3;
+
+extern const char* const kCancelledError;
+
+class CancelToken {
+public:
+    // Registered until the last reference goes. id 0 is never matched by
+    // CancelJob; `paths` only decides which folders can reach the token.
+    static std::shared_ptr<CancelToken> Create(uint64_t id, const std::vector<std::wstring>& paths);
+    static std::shared_ptr<CancelToken> Create(uint64_t id, const std::wstring& path);
+    ~CancelToken();
+
+    CancelToken(const CancelToken&) = delete;
+    CancelToken& operator=(const CancelToken&) = delete;
+
+    // The whole job was cancelled
+    bool IsCancelled() const { return m_cancelled.load(std::memory_order_acquire); }
+
+    // The whole job, or a folder containing path, was cancelled. A couple
+    // of relaxed loads until some folder cancellation reaches this token.
+    bool IsCancelled(const std::wstring& path) const;
+
+    // Run fn once when the job is cancelled, on the cancelling thread (now,
+    // if it already was). Must not call back into the registry.
+    void OnCancel(std::function<void()> fn);
+
+    uint64_t Id() const { return m_id; }
+
+private:
+    friend class JobRegistry;
+
+    CancelToken(uint64_t id, std::wstring commonPrefix);
+
+    bool CancelAll();
+    bool CancelFolder(const std::wstring& folder);  // normalized
+
+    const uint64_t m_id;
+    const std::wstring m_commonPrefix;  // normalized longest common directory of the paths
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<bool> m_hasFolders{false};
+    mutable std::mutex m_mutex;
+    std::vector<std::wstring> m_folders;  // normalized
+    std::function<void()> m_onCancel;
+};
+
+using CancelTokenPtr = std::shared_ptr<CancelToken>;
+
+class JobRegistry {
+public:
+    static JobRegistry& Shared();
+
+    // Cancel the job registered under id; false if none is running
+    bool CancelJob(uint64_t id);
+
+    // Cancel every file under folder (or folder itself) across all jobs.
+    // Returns how many jobs were affected.
+    size_t CancelUnder(const std::wstring& folder);
+
+    size_t ActiveCount();
+
+private:
+    friend class CancelToken;
+
+    JobRegistry() = default;
+
+    void Add(CancelToken* token);
+    void Remove(CancelToken* token);
+
+    std::mutex m_mutex;
+    std::vector<CancelToken*> m_tokens;  // tokens remove themselves on destruction
+};
@@ -0,0 +1,37 @@
+/**
+ * Job Cancellation Bindings
+ *
+ * cancelJob(jobId) -> boolean
+ * cancelJobsUnder(folder) -> number of jobs affected
+ *
+ * jobId is whatever the caller passed in an async call's options. Folder
+ * cancellation matches case-insensitively on whole path components and
+ * reaches every running or queued job, whoever started it.
+ */
+
+#include "addon.h"
+
+#include <string>
+
+#include "job_registry.h"
+
+static Napi::Value CancelJob(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    int64_t id = 0;
+    if (!ReadArgs(info, "Job id expected", &id)) return env.Null();
+    return Napi::Boolean::New(env, JobRegistry::Shared().CancelJob(static_cast<uint64_t>(id)));
+}
+
+static Napi::Value CancelJobsUnder(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::wstring folder;
+    if (!ReadArgs(info, "Folder path expected", &folder)) return env.Null();
+    return Napi::Number::New(env, static_cast<double>(JobRegistry::Shared().CancelUnder(folder)));
+}
+
+void InitJobBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("cancelJob", Napi::Function::New(env, CancelJob));
+    exports.Set("cancelJobsUnder", Napi::Function::New(env, CancelJobsUnder));
+}
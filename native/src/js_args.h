@@ -0,0 +1,232 @@
+/**
+ * Typed JS Arguments
+ *
+ * Argument checks and conversions for the bindings, generated from the C++
+ * types of the outputs instead of written out in every method:
+ *
+ *   std::wstring path;
+ *   int32_t width, height;
+ *   if (!ReadArgs(info, "File path, width and height expected", &path, &width, &height)) {
+ *       return env.Null();
+ *   }
+ *
+ * checks the argument count and every type before converting anything, and
+ * throws one TypeError with the usage message if something is off.
+ * std::optional<T> outputs may be omitted or undefined; they must come last.
+ *
+ * Strings come out of V8 as UTF-16, which is what the Win32 path APIs take:
+ * no UTF-8 round trip, no MultiByteToWideChar. Every read goes through one
+ * thread-local buffer, so a string argument costs one N-API call plus the
+ * copy into its std::wstring (WideScratch callers skip even that).
+ *
+ * Batch APIs take their paths as one path table (ReadPathTable): a string
+ * or Uint16Array of '\0'-terminated paths, read in one call and split
+ * natively, instead of a JS array read one element at a time.
+ */
+
+#pragma once
+
+#include <napi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be UTF-16");
+
+// The string's UTF-16 in this thread's scratch buffer, NUL-terminated.
+// Valid until the next WideScratch on the thread; empty for a non-string.
+inline std::wstring_view WideScratch(const Napi::Value& value) {
+    static thread_local std::vector<char16_t> buffer(512);
+
+    napi_env env = value.Env();
+    size_t copied = 0;
+    if (napi_get_value_string_utf16(env, value, buffer.data(), buffer.size(), &copied) != napi_ok) {
+        return std::wstring_view();
+    }
+    if (copied + 1 == buffer.size()) {
+        // Filled to the end: it may have been cut short
+        size_t length = 0;
+        napi_get_value_string_utf16(env, value, nullptr, 0, &length);
+        if (length > copied) {
+            buffer.resize(length + 1);
+            napi_get_value_string_utf16(env, value, buffer.data(), buffer.size(), &copied);
+        }
+    }
+    return std::wstring_view(reinterpret_cast<const wchar_t*>(buffer.data()), copied);
+}
+
+inline std::wstring JsToWide(const Napi::Value& value) {
+    return std::wstring(WideScratch(value));
+}
+
+inline Napi::String WideToJs(Napi::Env env, const std::wstring& wide) {
+    return Napi::String::New(env, reinterpret_cast<const char16_t*>(wide.data()), wide.size());
+}
+
+// Conversion for one C++ argument type: Is() checks, Read() converts
+template <typename T>
+struct JsArg;
+
+struct JsRequiredArg {
+    static constexpr bool kOptional = false;
+};
+
+template <>
+struct JsArg<std::wstring> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsString(); }
+    static void Read(const Napi::Value& value, std::wstring* out) { out->assign(WideScratch(value)); }
+};
+
+template <>
+struct JsArg<std::string> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsString(); }
+    static void Read(const Napi::Value& value, std::string* out) { *out = value.As<Napi::String>().Utf8Value(); }
+};
+
+template <>
+struct JsArg<double> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsNumber(); }
+    static void Read(const Napi::Value& value, double* out) { *out = value.As<Napi::Number>().DoubleValue(); }
+};
+
+template <>
+struct JsArg<int32_t> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsNumber(); }
+    static void Read(const Napi::Value& value, int32_t* out) { *out = value.As<Napi::Number>().Int32Value(); }
+};
+
+template <>
+struct JsArg<uint32_t> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsNumber(); }
+    static void Read(const Napi::Value& value, uint32_t* out) { *out = value.As<Napi::Number>().Uint32Value(); }
+};
+
+template <>
+struct JsArg<int64_t> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsNumber(); }
+    static void Read(const Napi::Value& value, int64_t* out) { *out = value.As<Napi::Number>().Int64Value(); }
+};
+
+template <>
+struct JsArg<bool> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsBoolean(); }
+    static void Read(const Napi::Value& value, bool* out) { *out = value.As<Napi::Boolean>().Value(); }
+};
+
+template <>
+struct JsArg<Napi::Object> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsObject(); }
+    static void Read(const Napi::Value& value, Napi::Object* out) { *out = value.As<Napi::Object>(); }
+};
+
+template <>
+struct JsArg<Napi::Function> : JsRequiredArg {
+    static bool Is(const Napi::Value& value) { return value.IsFunction(); }
+    static void Read(const Napi::Value& value, Napi::Function* out) { *out = value.As<Napi::Function>(); }
+};
+
+template <typename T>
+struct JsArg<std::optional<T>> {
+    static constexpr bool kOptional = true;
+    static bool Is(const Napi::Value& value) { return value.IsUndefined() || JsArg<T>::Is(value); }
+    static void Read(const Napi::Value& value, std::optional<T>* out) {
+        if (value.IsUndefined()) {
+            out->reset();
+            return;
+        }
+        T converted;
+        JsArg<T>::Read(value, &converted);
+        *out = std::move(converted);
+    }
+};
+
+// A positional signature, checked whole before anything is converted
+template <typename... T>
+struct JsSignature {
+    static constexpr size_t kRequired = ((JsArg<T>::kOptional ? 0 : 1) + ... + 0);
+
+    static constexpr bool OptionalsTrail() {
+        const bool optional[] = { false, JsArg<T>::kOptional... };
+        for (size_t i = 1; i < std::size(optional); i++) {
+            if (optional[i - 1] && !optional[i]) return false;
+        }
+        return true;
+    }
+    static_assert(OptionalsTrail(), "optional arguments must come last");
+
+    // Throws the usage message and returns false unless every argument fits
+    static bool Read(const Napi::CallbackInfo& info, const char* usage, T*... out) {
+        return ReadAt(info, usage, std::index_sequence_for<T...>(), out...);
+    }
+
+private:
+    template <size_t... I>
+    static bool ReadAt(const Napi::CallbackInfo& info, const char* usage, std::index_sequence<I...>, T*... out) {
+        // info[i] past the end reads as undefined, which only optionals accept
+        if (info.Length() < kRequired || !(JsArg<T>::Is(info[I]) && ...)) {
+            Napi::TypeError::New(info.Env(), usage).ThrowAsJavaScriptException();
+            return false;
+        }
+        (JsArg<T>::Read(info[I], out), ...);
+        return true;
+    }
+};
+
+template <typename... T>
+inline bool ReadArgs(const Napi::CallbackInfo& info, const char* usage, T*... out) {
+    return JsSignature<T...>::Read(info, usage, out...);
+}
+
+// Split a path table: every '\0' ends one path, empty ones included, so
+// n terminators are n paths in the caller's order. Text after the last
+// '\0' is one more path (a table written with join('\0') still splits).
+inline void SplitPathTable(std::wstring_view table, std::vector<std::wstring>* out) {
+    out->reserve(out->size() + std::count(table.begin(), table.end(), L'\0') + 1);
+    size_t start = 0;
+    while (start < table.size()) {
+        size_t end = table.find(L'\0', start);
+        if (end == std::wstring_view::npos) end = table.size();
+        out->emplace_back(table.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+// Paths from a path table (a string or Uint16Array of '\0'-terminated
+// UTF-16 paths) or from an array of strings. Throws and returns false
+// on anything else.
+inline bool ReadPathTable(const Napi::Value& value, std::vector<std::wstring>* out) {
+    Napi::Env env = value.Env();
+    if (value.IsString()) {
+        SplitPathTable(WideScratch(value), out);
+        return true;
+    }
+    if (value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_uint16_array) {
+        Napi::Uint16Array units = value.As<Napi::Uint16Array>();
+        SplitPathTable(std::wstring_view(reinterpret_cast<const wchar_t*>(units.Data()), units.ElementLength()), out);
+        return true;
+    }
+    if (!value.IsArray()) {
+        Napi::TypeError::New(env, "Array or table of file paths expected").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    Napi::Array array = value.As<Napi::Array>();
+    uint32_t length = array.Length();
+    out->reserve(out->size() + length);
+    for (uint32_t i = 0; i < length; i++) {
+        Napi::Value item = array.Get(i);
+        if (!item.IsString()) {
+            Napi::TypeError::New(env, "File paths must be strings").ThrowAsJavaScriptException();
+            return false;
+        }
+        out->emplace_back(WideScratch(item));
+    }
+    return true;
+}
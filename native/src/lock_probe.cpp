@@ -0,0 +1,96 @@
+/**
+ * File Lock Probing
+ */
+
+#include "lock_probe.h"
+
+#include <windows.h>
+#include <restartmanager.h>
+
+#include "string_util.h"
+
+// A file rarely has more holders than this; RmGetList says how many it
+// really needs if so, and we retry once
+static const UINT kInitialOwnerSlots = 8;
+
+static std::string ExeNameForProcess(DWORD processId) {
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!process) return std::string();
+
+    wchar_t path[MAX_PATH];
+    DWORD length = MAX_PATH;
+    std::string name;
+    if (QueryFullProcessImageNameW(process, 0, path, &length)) {
+        std::wstring full(path, length);
+        size_t slash = full.find_last_of(L"\\/");
+        name = WideToUtf8(slash == std::wstring::npos ? full : full.substr(slash + 1));
+    }
+    CloseHandle(process);
+    return name;
+}
+
+static std::vector<LockOwner> QueryOwners(const std::wstring& path) {
+    std::vector<LockOwner> owners;
+
+    DWORD session = 0;
+    WCHAR sessionKey[CCH_RM_SESSION_KEY + 1] = {};
+    if (RmStartSession(&session, 0, sessionKey) != ERROR_SUCCESS) return owners;
+
+    LPCWSTR files[] = { path.c_str() };
+    if (RmRegisterResources(session, 1, files, 0, nullptr, 0, nullptr) == ERROR_SUCCESS) {
+        std::vector<RM_PROCESS_INFO> processes(kInitialOwnerSlots);
+        UINT needed = 0;
+        UINT count = static_cast<UINT>(processes.size());
+        DWORD reasons = 0;
+        DWORD status = RmGetList(session, &needed, &count, processes.data(), &reasons);
+        if (status == ERROR_MORE_DATA) {
+            processes.resize(needed);
+            count = needed;
+            status = RmGetList(session, &needed, &count, processes.data(), &reasons);
+        }
+        if (status == ERROR_SUCCESS) {
+            for (UINT i = 0; i < count; i++) {
+                const RM_PROCESS_INFO& info = processes[i];
+                LockOwner owner;
+                owner.processId = info.Process.dwProcessId;
+                owner.startTime = (static_cast<uint64_t>(info.Process.ProcessStartTime.dwHighDateTime) << 32) |
+                    info.Process.ProcessStartTime.dwLowDateTime;
+                owner.appName = WideToUtf8(info.strAppName);
+                owner.exeName = ExeNameForProcess(info.Process.dwProcessId);
+                owner.appType = static_cast<uint32_t>(info.ApplicationType);
+                owners.push_back(std::move(owner));
+            }
+        }
+    }
+
+    RmEndSession(session);
+    return owners;
+}
+
+LockProbe ProbeLock(const std::wstring& path, bool withOwners) {
+    LockProbe probe;
+
+    HANDLE file = CreateFileW(path.c_str(), DELETE, 0, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+        probe.state = LockState::Unlocked;
+        return probe;
+    }
+
+    switch (GetLastError()) {
+        case ERROR_SHARING_VIOLATION:
+        case ERROR_LOCK_VIOLATION:
+            probe.state = LockState::Locked;
+            if (withOwners) probe.owners = QueryOwners(path);
+            break;
+        case ERROR_FILE_NOT_FOUND:
+        case ERROR_PATH_NOT_FOUND:
+            probe.state = LockState::Missing;
+            break;
+        default:
+            probe.state = LockState::Failed;
+            break;
+    }
+    return probe;
+}
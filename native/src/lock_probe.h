@@ -0,0 +1,42 @@
+/**
+ * File Lock Probing
+ *
+ * Answers "would moving this file fail because something has it open?"
+ * without touching its contents. The probe opens the file for DELETE - the
+ * access a rename needs - with no sharing, which fails with a sharing
+ * violation as soon as any other handle is open on it, and closes it
+ * again at once. Optionally asks the Restart Manager which processes hold
+ * a locked file.
+ *
+ * N-API free; safe to call from any thread.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class LockState : uint8_t {
+    Unlocked,
+    Locked,    // sharing or lock violation
+    Missing,   // file or path not found
+    Failed,    // anything else (access denied, ...)
+};
+
+struct LockOwner {
+    uint32_t processId = 0;
+    uint64_t startTime = 0;  // FILETIME; together with the PID identifies the process
+    std::string appName;     // Restart Manager's friendly name
+    std::string exeName;     // image file name, when the process can be queried
+    uint32_t appType = 0;    // RM_APP_TYPE
+};
+
+struct LockProbe {
+    LockState state = LockState::Failed;
+    std::vector<LockOwner> owners;
+};
+
+// withOwners: query the Restart Manager for locked files (costs a session
+// per file, so only locked ones pay)
+LockProbe ProbeLock(const std::wstring& path, bool withOwners);
@@ -0,0 +1,151 @@
+/**
+ * Lock Probe Bindings
+ *
+ * probeLocks(paths[], { owners, priority, jobId }) -> Promise<LockReport>
+ *
+ * Paths are probed in chunks across the shared worker pool and reported in
+ * one compact result: bitmaps with bit i (LSB first, byte i >> 3) set for
+ * path i, plus a deduplicated table of owning processes and, for each
+ * locked path, indices into it. Cancelled paths are reported as failed.
+ *
+ *   { count, lockedCount, locked, missing, failed,       // Buffers, ceil(count / 8) bytes
+ *     owners: [{ pid, appName, exeName, appType }],
+ *     holders: [{ index, owners: [ownerIndex, ...] }] }
+ */
+
+#include "addon.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lock_probe.h"
+#include "native_stats.h"
+#include "thread_pool.h"
+
+// Small enough to spread over every worker, large enough that queueing
+// costs nothing next to the opens
+static const size_t kPathsPerJob = 64;
+
+struct LockBatch {
+    std::vector<std::wstring> paths;
+    std::vector<LockProbe> results;
+    bool withOwners = true;
+    JobOptions job;
+    CancelTokenPtr token;
+    std::atomic<size_t> remaining{0};
+    AsyncCompletion* completion = nullptr;
+};
+
+static Napi::Value BuildLockReport(Napi::Env env, LockBatch* batch) {
+    size_t count = batch->results.size();
+    size_t bitmapBytes = (count + 7) / 8;
+    std::vector<uint8_t> locked(bitmapBytes), missing(bitmapBytes), failed(bitmapBytes);
+
+    Napi::Array owners = Napi::Array::New(env);
+    Napi::Array holders = Napi::Array::New(env);
+    std::map<std::pair<uint32_t, uint64_t>, uint32_t> ownerIndex;
+    uint32_t lockedCount = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        LockProbe& probe = batch->results[i];
+        uint8_t bit = static_cast<uint8_t>(1u << (i & 7));
+        switch (probe.state) {
+            case LockState::Locked: locked[i >> 3] |= bit; lockedCount++; break;
+            case LockState::Missing: missing[i >> 3] |= bit; break;
+            case LockState::Failed: failed[i >> 3] |= bit; break;
+            default: break;
+        }
+        if (probe.owners.empty()) continue;
+
+        Napi::Array indices = Napi::Array::New(env, probe.owners.size());
+        for (size_t j = 0; j < probe.owners.size(); j++) {
+            LockOwner& owner = probe.owners[j];
+            auto key = std::make_pair(owner.processId, owner.startTime);
+            auto found = ownerIndex.find(key);
+            if (found == ownerIndex.end()) {
+                Napi::Object entry = Napi::Object::New(env);
+                entry.Set("pid", Napi::Number::New(env, owner.processId));
+                entry.Set("appName", Napi::String::New(env, owner.appName));
+                entry.Set("exeName", Napi::String::New(env, owner.exeName));
+                entry.Set("appType", Napi::Number::New(env, owner.appType));
+                uint32_t index = owners.Length();
+                owners.Set(index, entry);
+                found = ownerIndex.emplace(key, index).first;
+            }
+            indices.Set(static_cast<uint32_t>(j), Napi::Number::New(env, found->second));
+        }
+        Napi::Object holder = Napi::Object::New(env);
+        holder.Set("index", Napi::Number::New(env, static_cast<double>(i)));
+        holder.Set("owners", indices);
+        holders.Set(holders.Length(), holder);
+    }
+
+    Napi::Object report = Napi::Object::New(env);
+    report.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+    report.Set("lockedCount", Napi::Number::New(env, lockedCount));
+    report.Set("locked", TakeBuffer(env, std::move(locked)));
+    report.Set("missing", TakeBuffer(env, std::move(missing)));
+    report.Set("failed", TakeBuffer(env, std::move(failed)));
+    report.Set("owners", owners);
+    report.Set("holders", holders);
+    return report;
+}
+
+// probeLocks(paths: string[] | path table, options?: { owners?: boolean, priority?, jobId? })
+static Napi::Value ProbeLocks(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto batch = std::make_shared<LockBatch>();
+    if (!ReadPathTable(info[0], &batch->paths)) return env.Null();
+
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Value owners = info[1].As<Napi::Object>().Get("owners");
+        if (owners.IsBoolean()) batch->withOwners = owners.As<Napi::Boolean>().Value();
+        if (!ReadJobOptions(env, info[1], &batch->job)) return env.Null();
+    }
+
+    batch->results.resize(batch->paths.size());
+    batch->completion = AsyncCompletion::Create(env, "probeLocks");
+    Napi::Promise promise = batch->completion->Promise();
+
+    size_t jobs = (batch->paths.size() + kPathsPerJob - 1) / kPathsPerJob;
+    batch->remaining = jobs;
+    if (jobs == 0) {
+        batch->completion->Resolve([batch](Napi::Env env) {
+            return BuildLockReport(env, batch.get());
+        });
+        return promise;
+    }
+
+    batch->token = CancelToken::Create(batch->job.jobId, batch->paths);
+    for (size_t job = 0; job < jobs; job++) {
+        ThreadPool::Shared().Submit([batch, job]() {
+            size_t end = std::min(batch->paths.size(), (job + 1) * kPathsPerJob);
+            for (size_t i = job * kPathsPerJob; i < end; i++) {
+                if (batch->token->IsCancelled(batch->paths[i])) {
+                    batch->results[i].state = LockState::Failed;
+                    continue;
+                }
+                ScopedNativeTimer timer(NativeOp::ProbeLock);
+                batch->results[i] = ProbeLock(batch->paths[i], batch->withOwners);
+            }
+            if (--batch->remaining == 0) {
+                batch->token.reset();
+                batch->completion->Resolve([batch](Napi::Env env) {
+                    return BuildLockReport(env, batch.get());
+                });
+            }
+        }, batch->job.priority);
+    }
+
+    return promise;
+}
+
+void InitLockProbeBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("probeLocks", Napi::Function::New(env, ProbeLocks));
+}
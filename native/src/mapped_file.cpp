@@ -0,0 +1,76 @@
+/**
+ * Read-only Mapped File
+ */
+
+#include "mapped_file.h"
+
+#include <windows.h>
+#include <cstring>
+
+// Kept free of C++ objects so __try is allowed; an EXCEPTION_IN_PAGE_ERROR
+// is the only fault a valid, bounds-checked view can raise
+static bool GuardedCopy(void* dst, const void* src, size_t length) {
+    __try {
+        memcpy(dst, src, length);
+        return true;
+    } __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER
+                                                               : EXCEPTION_CONTINUE_SEARCH) {
+        return false;
+    }
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::wstring& path, std::string* error) {
+    Close();
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        DWORD lastError = GetLastError();
+        *error = lastError == ERROR_FILE_NOT_FOUND || lastError == ERROR_PATH_NOT_FOUND
+            ? "File not found" : "Could not open file";
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        *error = "File is empty";
+        return false;
+    }
+
+    // The view keeps the mapping (and the file) alive once mapped
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        *error = "Could not map file";
+        return false;
+    }
+
+    m_view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!m_view) {
+        *error = "Could not map file";
+        return false;
+    }
+
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    m_size = 0;
+}
+
+bool MappedFile::Read(uint64_t offset, void* dst, size_t length) const {
+    if (!m_view || offset > m_size || length > m_size - offset) return false;
+    return GuardedCopy(dst, m_view + offset, length);
+}
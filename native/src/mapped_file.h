@@ -0,0 +1,39 @@
+/**
+ * Read-only Mapped File
+ *
+ * Maps a whole file into the address space without reading it; pages are
+ * faulted in only where something is read. The file is opened with full
+ * sharing, so documents open in SOLIDWORKS (or being synced) stay readable.
+ *
+ * Reads go through Read(), which turns an in-page error (network share
+ * dropped, file truncated underneath us) into a failed read instead of a
+ * crash.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "compound_file.h"
+
+class MappedFile : public ByteSource {
+public:
+    MappedFile() = default;
+    ~MappedFile() override;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::wstring& path, std::string* error);
+    void Close();
+
+    bool IsOpen() const { return m_view != nullptr; }
+    const uint8_t* Data() const { return m_view; }
+
+    uint64_t Size() const override { return m_size; }
+    bool Read(uint64_t offset, void* dst, size_t length) const override;
+
+private:
+    const uint8_t* m_view = nullptr;
+    uint64_t m_size = 0;
+};
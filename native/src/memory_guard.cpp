@@ -0,0 +1,100 @@
+/**
+ * Memory Guard
+ */
+
+#include "memory_guard.h"
+
+#include <psapi.h>
+
+// How often commit is compared with the budget
+static const DWORD kPollMs = 2000;
+
+// After a trim, time for closed documents to be released before looking
+// again. The low-memory object stays signalled for as long as memory is
+// low, so without this the guard would trim in a tight loop.
+static const DWORD kSettleMs = 5000;
+
+MemoryGuard& MemoryGuard::Shared() {
+    static MemoryGuard guard;
+    return guard;
+}
+
+uint64_t MemoryGuard::CommitBytes() {
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(),
+            reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+        return 0;
+    }
+    return counters.PrivateUsage;
+}
+
+void MemoryGuard::Start(TrimCallback trim) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_thread.joinable()) return;
+
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent) return;
+    m_lowMemory = CreateMemoryResourceNotification(LowMemoryResourceNotification);
+    m_trim = std::move(trim);
+    m_thread = std::thread(&MemoryGuard::WatchLoop, this);
+}
+
+void MemoryGuard::Stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) return;
+
+    SetEvent(m_stopEvent);
+    m_thread.join();
+    CloseHandle(m_stopEvent);
+    m_stopEvent = nullptr;
+    if (m_lowMemory) {
+        CloseHandle(m_lowMemory);
+        m_lowMemory = nullptr;
+    }
+    m_trim = nullptr;
+}
+
+void MemoryGuard::WatchLoop() {
+    HANDLE handles[2] = { m_stopEvent, m_lowMemory };
+    DWORD count = m_lowMemory ? 2 : 1;
+
+    for (;;) {
+        DWORD wait = WaitForMultipleObjects(count, handles, FALSE, kPollMs);
+        if (wait == WAIT_OBJECT_0 || wait == WAIT_FAILED) return;
+
+        bool low = wait == WAIT_OBJECT_0 + 1;
+        uint64_t budget = Budget();
+        bool over = budget > 0 && CommitBytes() > budget;
+        if (!low && !over) continue;
+
+        m_pressureEvents.fetch_add(1, std::memory_order_relaxed);
+        m_trim(low ? 0 : budget);
+
+        if (WaitForSingleObject(m_stopEvent, kSettleMs) == WAIT_OBJECT_0) return;
+    }
+}
+
+MemoryStats MemoryGuard::Snapshot() const {
+    MemoryStats stats;
+    stats.commitBytes = CommitBytes();
+    stats.budgetBytes = Budget();
+    {
+        // Stop closes the handle under the same lock
+        std::lock_guard<std::mutex> lock(m_mutex);
+        BOOL low = FALSE;
+        if (m_lowMemory && QueryMemoryResourceNotification(m_lowMemory, &low)) {
+            stats.lowMemory = low != FALSE;
+        }
+    }
+    stats.pressureEvents = m_pressureEvents.load(std::memory_order_relaxed);
+    stats.documentsEvicted = m_documentsEvicted.load(std::memory_order_relaxed);
+    stats.controlsEvicted = m_controlsEvicted.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MemoryGuard::ResetCounters() {
+    m_pressureEvents.store(0, std::memory_order_relaxed);
+    m_documentsEvicted.store(0, std::memory_order_relaxed);
+    m_controlsEvicted.store(0, std::memory_order_relaxed);
+}
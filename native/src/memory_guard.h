@@ -0,0 +1,75 @@
+/**
+ * Memory Guard
+ *
+ * Watches process commit (private bytes) against an optional budget, and
+ * the system's low-memory resource notification. When either trips, the
+ * trim callback runs on the guard's thread with a target: the commit to
+ * get back under, or 0 when the whole machine is short of memory (drop
+ * everything idle). The preview side posts that to each apartment's pool
+ * (see ControlPool::TrimForMemory).
+ *
+ * Eviction counters live here rather than in the pools, so stats can read
+ * them without a round trip to the apartments.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct MemoryStats {
+    uint64_t commitBytes = 0;
+    uint64_t budgetBytes = 0;       // 0: no budget
+    bool lowMemory = false;         // the system reports low memory right now
+    uint64_t pressureEvents = 0;    // times a trim was requested
+    uint64_t documentsEvicted = 0;  // resident documents closed to free memory or make room
+    uint64_t controlsEvicted = 0;   // idle controls destroyed under pressure
+};
+
+class MemoryGuard {
+public:
+    using TrimCallback = std::function<void(uint64_t targetBytes)>;
+
+    static MemoryGuard& Shared();
+
+    // Process private bytes (commit charge)
+    static uint64_t CommitBytes();
+
+    // Start watching; safe to call repeatedly (the first callback stays)
+    void Start(TrimCallback trim);
+
+    // Stop and join the watcher. Called before the apartments stop.
+    void Stop();
+
+    // Commit budget in bytes; 0 leaves only system low memory as a trigger
+    void SetBudget(uint64_t bytes) { m_budget.store(bytes, std::memory_order_relaxed); }
+    uint64_t Budget() const { return m_budget.load(std::memory_order_relaxed); }
+
+    void RecordDocumentEvicted() { m_documentsEvicted.fetch_add(1, std::memory_order_relaxed); }
+    void RecordControlEvicted() { m_controlsEvicted.fetch_add(1, std::memory_order_relaxed); }
+
+    MemoryStats Snapshot() const;
+    void ResetCounters();
+
+private:
+    MemoryGuard() = default;
+    MemoryGuard(const MemoryGuard&) = delete;
+    MemoryGuard& operator=(const MemoryGuard&) = delete;
+
+    void WatchLoop();
+
+    mutable std::mutex m_mutex;  // guards the thread and both handles
+    std::thread m_thread;
+    TrimCallback m_trim;
+    HANDLE m_stopEvent = nullptr;
+    HANDLE m_lowMemory = nullptr;  // null if the notification is unavailable
+
+    std::atomic<uint64_t> m_budget{0};
+    std::atomic<uint64_t> m_pressureEvents{0};
+    std::atomic<uint64_t> m_documentsEvicted{0};
+    std::atomic<uint64_t> m_controlsEvicted{0};
+};
@@ -0,0 +1,170 @@
+/**
+ * Native Latency Statistics
+ */
+
+#include "native_stats.h"
+
+#include <windows.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Values are microseconds. Below 2^kSubBits they index a bucket directly;
+// above, a bucket is (exponent, top kSubBits bits of the mantissa).
+static const uint32_t kSubBits = 3;
+static const uint32_t kSubBuckets = 1u << kSubBits;
+static const uint32_t kMaxExponent = 31;  // up to 2^32 us (~71 minutes); longer clamps
+static const uint32_t kBucketCount = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+static const size_t kOpCount = static_cast<size_t>(NativeOp::Count);
+
+static const char* const kOpNames[kOpCount] = {
+    "createControl", "populateDispatch", "getIDsOfNames", "attachToWindow", "loadFile",
+    "loadFileAsync", "openDoc", "setBounds", "invoke", "renderToBuffer", "extractThumbnail",
+    "readPreviewStream", "hashFile", "enumerateTree", "probeLock", "copyFile",
+    "readChunk", "chunkFile", "syncBounds", "readProperties",
+};
+
+// Written by its owning thread only; read by anyone
+struct ThreadHistograms {
+    std::atomic<uint32_t> buckets[kOpCount][kBucketCount];
+    std::atomic<uint64_t> sumUs[kOpCount];
+};
+
+struct Totals {
+    uint64_t buckets[kOpCount][kBucketCount] = {};
+    uint64_t sumUs[kOpCount] = {};
+};
+
+static std::mutex g_registryMutex;
+static std::vector<ThreadHistograms*> g_registry;  // never freed: threads may outlive a reader
+static Totals g_baseline;
+
+static thread_local ThreadHistograms* t_histograms = nullptr;
+
+static ThreadHistograms* CurrentHistograms() {
+    if (t_histograms) return t_histograms;
+    auto* histograms = new ThreadHistograms();
+    for (auto& op : histograms->buckets) {
+        for (auto& bucket : op) bucket.store(0, std::memory_order_relaxed);
+    }
+    for (auto& sum : histograms->sumUs) sum.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    g_registry.push_back(histograms);
+    t_histograms = histograms;
+    return histograms;
+}
+
+static uint32_t BucketFor(uint64_t us) {
+    if (us < kSubBuckets) return static_cast<uint32_t>(us);
+    uint32_t exponent = 63;
+    while (!(us >> exponent)) exponent--;
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    uint32_t sub = static_cast<uint32_t>(us >> (exponent - kSubBits)) & (kSubBuckets - 1);
+    return (exponent - kSubBits + 1) * kSubBuckets + sub;
+}
+
+static double BucketLow(uint32_t bucket) {
+    if (bucket < kSubBuckets) return bucket;
+    uint32_t exponent = bucket / kSubBuckets + kSubBits - 1;
+    uint32_t sub = bucket % kSubBuckets;
+    return static_cast<double>(static_cast<uint64_t>(kSubBuckets + sub) << (exponent - kSubBits));
+}
+
+static double BucketWidth(uint32_t bucket) {
+    if (bucket < kSubBuckets) return 1;
+    uint32_t exponent = bucket / kSubBuckets + kSubBits - 1;
+    return static_cast<double>(1ull << (exponent - kSubBits));
+}
+
+static int64_t Frequency() {
+    static const int64_t frequency = []() {
+        LARGE_INTEGER value;
+        QueryPerformanceFrequency(&value);
+        return value.QuadPart;
+    }();
+    return frequency;
+}
+
+int64_t NativeStats::Now() {
+    LARGE_INTEGER value;
+    QueryPerformanceCounter(&value);
+    return value.QuadPart;
+}
+
+void NativeStats::Record(NativeOp op, int64_t startTicks) {
+    int64_t ticks = Now() - startTicks;
+    if (ticks < 0) ticks = 0;
+    int64_t frequency = Frequency();
+    // Split to avoid overflowing ticks * 1e6 on long operations
+    uint64_t us = static_cast<uint64_t>(ticks / frequency) * 1000000 +
+        static_cast<uint64_t>((ticks % frequency) * 1000000 / frequency);
+
+    ThreadHistograms* histograms = CurrentHistograms();
+    size_t index = static_cast<size_t>(op);
+    // Single writer: a plain load + store, no locked read-modify-write
+    auto& bucket = histograms->buckets[index][BucketFor(us)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    auto& sum = histograms->sumUs[index];
+    sum.store(sum.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+}
+
+// Caller holds g_registryMutex
+static void SumRegistry(Totals* totals) {
+    for (ThreadHistograms* histograms : g_registry) {
+        for (size_t op = 0; op < kOpCount; op++) {
+            for (uint32_t b = 0; b < kBucketCount; b++) {
+                totals->buckets[op][b] += histograms->buckets[op][b].load(std::memory_order_relaxed);
+            }
+            totals->sumUs[op] += histograms->sumUs[op].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+std::vector<NativeOpSummary> NativeStats::Snapshot() {
+    auto totals = std::make_unique<Totals>();
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        SumRegistry(totals.get());
+        for (size_t op = 0; op < kOpCount; op++) {
+            for (uint32_t b = 0; b < kBucketCount; b++) totals->buckets[op][b] -= g_baseline.buckets[op][b];
+            totals->sumUs[op] -= g_baseline.sumUs[op];
+        }
+    }
+
+    std::vector<NativeOpSummary> summaries(kOpCount);
+    for (size_t op = 0; op < kOpCount; op++) {
+        NativeOpSummary& summary = summaries[op];
+        summary.name = kOpNames[op];
+        const uint64_t* buckets = totals->buckets[op];
+        for (uint32_t b = 0; b < kBucketCount; b++) summary.count += buckets[b];
+        if (summary.count == 0) continue;
+
+        summary.meanUs = static_cast<double>(totals->sumUs[op]) / summary.count;
+
+        // Percentiles report the bucket midpoint
+        const double quantiles[] = { 0.50, 0.90, 0.99 };
+        double* outputs[] = { &summary.p50Us, &summary.p90Us, &summary.p99Us };
+        uint64_t seen = 0;
+        size_t next = 0;
+        for (uint32_t b = 0; b < kBucketCount && next < 3; b++) {
+            seen += buckets[b];
+            while (next < 3 && seen >= static_cast<uint64_t>(quantiles[next] * summary.count + 0.5) && seen > 0) {
+                *outputs[next++] = BucketLow(b) + BucketWidth(b) / 2;
+            }
+        }
+        for (uint32_t b = kBucketCount; b-- > 0;) {
+            if (buckets[b]) {
+                summary.maxUs = BucketLow(b) + BucketWidth(b);
+                break;
+            }
+        }
+    }
+    return summaries;
+}
+
+void NativeStats::Reset() {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    g_baseline = Totals();
+    SumRegistry(&g_baseline);
+}
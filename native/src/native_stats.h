@@ -0,0 +1,78 @@
+/**
+ * Native Latency Statistics
+ *
+ * QueryPerformanceCounter timings for every native entry point, kept as
+ * HDR-style log-linear histograms: exact below 8 us, then eight buckets
+ * per power of two (within 12.5%) up to about an hour.
+ *
+ * Recording is lock-free. Each thread writes only its own histogram block,
+ * registered once on first use, with relaxed atomic stores, so a record
+ * costs two QPC reads and a couple of uncontended stores. Readers sum every
+ * block. Reset takes a baseline instead of zeroing other threads' counters.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+enum class NativeOp : uint32_t {
+    CreateControl,      // container window + CoCreateInstance
+    PopulateDispatch,   // one-time type-info walk
+    GetIDsOfNames,      // DISPID cache miss
+    AttachToWindow,     // request to control re-parented (includes queueing)
+    LoadFile,
+    LoadFileAsync,      // request to load-complete event
+    OpenDoc,            // the OpenDoc call itself
+    SetBounds,          // request to SetWindowPos done (includes queueing)
+    Invoke,
+    RenderToBuffer,
+    ExtractThumbnail,
+    ReadPreviewStream,
+    HashFile,
+    EnumerateTree,
+    ProbeLock,
+    CopyFile,           // one file of a copyBatch, either path
+    ReadChunk,          // one chunk reader Next(), including the wait for its read
+    ChunkFile,          // one whole chunkFile: read, boundaries and chunk hashes
+    SyncBounds,         // synced rect read from its slot to window moved
+    ReadProperties,     // one file's property sets, open to parsed
+    Count
+};
+
+struct NativeOpSummary {
+    const char* name;  // camelCase, as reported to JS
+    uint64_t count = 0;
+    double meanUs = 0;
+    double p50Us = 0;
+    double p90Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;  // upper edge of the highest occupied bucket
+};
+
+class NativeStats {
+public:
+    // QPC ticks, for a later Record
+    static int64_t Now();
+
+    // Record the time since `startTicks` for op, on the calling thread's histogram
+    static void Record(NativeOp op, int64_t startTicks);
+
+    // One entry per NativeOp, in enum order, since the last Reset
+    static std::vector<NativeOpSummary> Snapshot();
+    static void Reset();
+};
+
+// Records the lifetime of the scope
+class ScopedNativeTimer {
+public:
+    explicit ScopedNativeTimer(NativeOp op) : m_op(op), m_start(NativeStats::Now()) {}
+    ~ScopedNativeTimer() { NativeStats::Record(m_op, m_start); }
+
+    ScopedNativeTimer(const ScopedNativeTimer&) = delete;
+    ScopedNativeTimer& operator=(const ScopedNativeTimer&) = delete;
+
+private:
+    NativeOp m_op;
+    int64_t m_start;
+};
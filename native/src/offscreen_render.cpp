@@ -0,0 +1,185 @@
+/**
+ * Offscreen Rendering
+ */
+
+#include "offscreen_render.h"
+
+#include <windows.h>
+#include <atlbase.h>
+#include <memory>
+
+#include "control_pool.h"
+#include "string_util.h"
+
+#ifndef PW_RENDERFULLCONTENT
+#define PW_RENDERFULLCONTENT 0x00000002
+#endif
+
+// Large assemblies can take a while; past this the render is abandoned
+static const DWORD kLoadTimeoutMs = 60000;
+
+// Run the apartment's message loop in place until done() or the timeout.
+// Jobs posted meanwhile wait (StaThread doesn't re-enter its queue), but
+// window and COM messages - including the control's load events - flow.
+template <typename Done>
+static bool PumpUntil(Done done, DWORD timeoutMs) {
+    ULONGLONG deadline = GetTickCount64() + timeoutMs;
+    while (!done()) {
+        ULONGLONG now = GetTickCount64();
+        if (now >= deadline) return false;
+
+        MsgWaitForMultipleObjectsEx(0, nullptr, static_cast<DWORD>(deadline - now),
+            QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+        MSG msg;
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) {
+                // Leave it for the real loop
+                PostQuitMessage(static_cast<int>(msg.wParam));
+                return false;
+            }
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+    return true;
+}
+
+static bool LoadAndWait(PooledControl* control, const std::wstring& path, std::string* error) {
+    DispatchValue arg;
+    arg.kind = DispatchValue::Kind::String;
+    arg.stringValue = path;
+
+    if (!control->events) {
+        // No connection point: OpenDoc returning is all we can observe
+        if (FAILED(InvokeControl(control, L"OpenDoc", { arg }))) {
+            *error = "OpenDoc failed";
+            return false;
+        }
+        return true;
+    }
+
+    auto outcome = std::make_shared<LoadEvent>();
+    auto settled = std::make_shared<bool>(false);
+    ControlEventSink* events = control->events;
+    events->SetListener([outcome, settled](const LoadEvent& ev) {
+        if (ev.type == LoadEvent::Type::Progress) return;
+        *outcome = ev;
+        *settled = true;
+    });
+
+    bool loaded = SUCCEEDED(InvokeControl(control, L"OpenDoc", { arg }));
+    if (loaded) {
+        loaded = PumpUntil([settled]() { return *settled; }, kLoadTimeoutMs);
+        if (!loaded) {
+            *error = "Timed out loading document";
+        } else if (outcome->type != LoadEvent::Type::Complete) {
+            loaded = false;
+            *error = outcome->errorMessage.empty() ? "Failed to load document"
+                : WideToUtf8(outcome->errorMessage);
+        }
+    } else {
+        *error = "OpenDoc failed";
+    }
+    events->SetListener(nullptr);
+    return loaded;
+}
+
+static bool DrawToPixels(PooledControl* control, uint32_t width, uint32_t height, RenderedImage* image) {
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = static_cast<LONG>(width);
+    info.bmiHeader.biHeight = -static_cast<LONG>(height);  // top-down
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    HDC screen = GetDC(nullptr);
+    HDC memory = CreateCompatibleDC(screen);
+    ReleaseDC(nullptr, screen);
+    if (!memory) {
+        image->error = "Could not create drawing surface";
+        return false;
+    }
+
+    void* bits = nullptr;
+    HBITMAP dib = CreateDIBSection(memory, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!dib || !bits) {
+        DeleteDC(memory);
+        image->error = "Could not create drawing surface";
+        return false;
+    }
+    HGDIOBJ previous = SelectObject(memory, dib);
+
+    RECT rect = { 0, 0, static_cast<LONG>(width), static_cast<LONG>(height) };
+    FillRect(memory, &rect, static_cast<HBRUSH>(GetStockObject(WHITE_BRUSH)));
+
+    // The control draws itself into any DC through IViewObject; if it only
+    // paints in-place, ask its window to render into ours instead
+    HRESULT hr = E_NOINTERFACE;
+    CComQIPtr<IViewObject> view(control->pControl);
+    if (view) {
+        RECTL bounds = { 0, 0, static_cast<LONG>(width), static_cast<LONG>(height) };
+        hr = view->Draw(DVASPECT_CONTENT, -1, nullptr, nullptr, nullptr, memory, &bounds,
+            nullptr, nullptr, 0);
+    }
+    if (FAILED(hr) && PrintWindow(control->hwndContainer, memory, PW_RENDERFULLCONTENT)) {
+        hr = S_OK;
+    }
+    GdiFlush();
+
+    if (SUCCEEDED(hr)) {
+        // BGRX -> RGBA; GDI leaves the fourth byte undefined
+        const uint8_t* src = static_cast<const uint8_t*>(bits);
+        image->rgba.resize(static_cast<size_t>(width) * height * 4);
+        uint8_t* dst = image->rgba.data();
+        for (size_t i = 0, n = static_cast<size_t>(width) * height; i < n; i++) {
+            dst[i * 4 + 0] = src[i * 4 + 2];
+            dst[i * 4 + 1] = src[i * 4 + 1];
+            dst[i * 4 + 2] = src[i * 4 + 0];
+            dst[i * 4 + 3] = 0xFF;
+        }
+        image->width = width;
+        image->height = height;
+    } else {
+        image->error = "Control could not be drawn";
+    }
+
+    SelectObject(memory, previous);
+    DeleteObject(dib);
+    DeleteDC(memory);
+    return SUCCEEDED(hr);
+}
+
+RenderedImage RenderDocument(const std::wstring& path, uint32_t width, uint32_t height,
+    int viewOrientation) {
+
+    RenderedImage image;
+    if (GetFileAttributesW(path.c_str()) == INVALID_FILE_ATTRIBUTES) {
+        image.error = "File not found";
+        return image;
+    }
+
+    ControlPool& pool = ControlPool::Current();
+    PooledControl* control = pool.AcquireOffscreen(static_cast<int>(width), static_cast<int>(height));
+    if (!control) {
+        image.error = "eDrawings control unavailable";
+        return image;
+    }
+
+    if (LoadAndWait(control, path, &image.error)) {
+        if (viewOrientation >= 0) {
+            DispatchValue orientation;
+            orientation.kind = DispatchValue::Kind::Int;
+            orientation.intValue = viewOrientation;
+            InvokeControl(control, L"ViewOrientation", { orientation });
+            // Let the view settle before capturing
+            PumpUntil([]() { return false; }, 50);
+        }
+        image.success = DrawToPixels(control, width, height, &image);
+    }
+
+    // Closes the document and parks the control for the next render
+    pool.Release(control);
+    return image;
+}
@@ -0,0 +1,30 @@
+/**
+ * Offscreen Rendering
+ *
+ * Loads a document into a pooled eDrawings control that never leaves the
+ * hidden parking window and captures it with IViewObject::Draw into a
+ * 32-bit DIB section. Used for list / hover previews sharper than the
+ * embedded thumbnail, without showing any window.
+ *
+ * Must run on a preview apartment (it uses that apartment's control
+ * pool). Blocks the apartment - while still pumping its messages - until
+ * the document finishes loading.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RenderedImage {
+    bool success = false;
+    std::string error;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;  // top-down, 4 bytes per pixel
+};
+
+// viewOrientation < 0 leaves the document's saved view
+RenderedImage RenderDocument(const std::wstring& path, uint32_t width, uint32_t height,
+    int viewOrientation);
@@ -0,0 +1,226 @@
+/**
+ * SHA-256
+ */
+
+#include "sha256.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SHA256_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SHA256_TARGET
+#else
+#include <cpuid.h>
+#define SHA256_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#endif
+#endif
+
+static const uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+using CompressFn = void (*)(uint32_t state[8], const uint8_t* data, size_t blocks);
+
+static inline uint32_t Rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void CompressPortable(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    uint32_t w[64];
+    while (blocks--) {
+        for (int i = 0; i < 16; i++) {
+            w[i] = (static_cast<uint32_t>(data[i * 4]) << 24) | (static_cast<uint32_t>(data[i * 4 + 1]) << 16) |
+                (static_cast<uint32_t>(data[i * 4 + 2]) << 8) | data[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t s1 = Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = h + s1 + ch + kRoundConstants[i] + w[i];
+            uint32_t s0 = Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        data += Sha256::kBlockSize;
+    }
+}
+
+#ifdef SHA256_X86
+// SHA-NI: the state lives as ABEF / CDGH lane pairs; each sha256rnds2 runs
+// two rounds and msg1/msg2 extend the schedule four words at a time
+SHA256_TARGET
+static void CompressShaNi(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);          // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);       // CDGH
+
+    while (blocks--) {
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+        __m128i w[4];
+
+        for (int i = 0; i < 16; i++) {
+            __m128i& current = w[i & 3];
+            if (i < 4) {
+                current = _mm_shuffle_epi8(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byteSwap);
+            } else {
+                const __m128i& previous = w[(i - 1) & 3];
+                __m128i extended = _mm_sha256msg1_epu32(current, w[(i - 3) & 3]);
+                extended = _mm_add_epi32(extended, _mm_alignr_epi8(previous, w[(i - 2) & 3], 4));
+                current = _mm_sha256msg2_epu32(extended, previous);
+            }
+
+            __m128i message = _mm_add_epi32(current,
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(&kRoundConstants[i * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+            message = _mm_shuffle_epi32(message, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+        data += Sha256::kBlockSize;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);        // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);     // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);  // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);     // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+static bool CpuHasShaNi() {
+    unsigned int leaf1[4] = {}, leaf7[4] = {};
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    memcpy(leaf1, regs, sizeof(regs));
+    __cpuidex(regs, 7, 0);
+    memcpy(leaf7, regs, sizeof(regs));
+#else
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __get_cpuid(1, &leaf1[0], &leaf1[1], &leaf1[2], &leaf1[3]);
+    __get_cpuid_count(7, 0, &leaf7[0], &leaf7[1], &leaf7[2], &leaf7[3]);
+#endif
+    bool ssse3 = (leaf1[2] & (1u << 9)) != 0;
+    bool sse41 = (leaf1[2] & (1u << 19)) != 0;
+    bool sha = (leaf7[1] & (1u << 29)) != 0;
+    return ssse3 && sse41 && sha;
+}
+#endif
+
+static CompressFn SelectCompress() {
+#ifdef SHA256_X86
+    if (CpuHasShaNi()) return CompressShaNi;
+#endif
+    return CompressPortable;
+}
+
+static const CompressFn g_compress = SelectCompress();
+
+bool Sha256::IsHardwareAccelerated() {
+#ifdef SHA256_X86
+    return g_compress == CompressShaNi;
+#else
+    return false;
+#endif
+}
+
+void Sha256::Reset() {
+    static const uint32_t kInitialState[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memcpy(m_state, kInitialState, sizeof(m_state));
+    m_buffered = 0;
+    m_totalBytes = 0;
+}
+
+void Sha256::Update(const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_totalBytes += length;
+
+    if (m_buffered > 0) {
+        size_t take = kBlockSize - m_buffered < length ? kBlockSize - m_buffered : length;
+        memcpy(m_buffer + m_buffered, bytes, take);
+        m_buffered += take;
+        bytes += take;
+        length -= take;
+        if (m_buffered < kBlockSize) return;
+        g_compress(m_state, m_buffer, 1);
+        m_buffered = 0;
+    }
+
+    // Whole blocks straight from the caller's buffer, no copy
+    size_t blocks = length / kBlockSize;
+    if (blocks > 0) {
+        g_compress(m_state, bytes, blocks);
+        bytes += blocks * kBlockSize;
+        length -= blocks * kBlockSize;
+    }
+
+    if (length > 0) {
+        memcpy(m_buffer, bytes, length);
+        m_buffered = length;
+    }
+}
+
+void Sha256::Final(uint8_t digest[kDigestSize]) {
+    uint64_t bitLength = m_totalBytes * 8;
+
+    uint8_t padding[kBlockSize * 2] = { 0x80 };
+    size_t padLength = (m_buffered < 56 ? 56 : 120) - m_buffered;
+    for (int i = 0; i < 8; i++) {
+        padding[padLength + i] = static_cast<uint8_t>(bitLength >> (56 - i * 8));
+    }
+    Update(padding, padLength + 8);
+
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = static_cast<uint8_t>(m_state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(m_state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(m_state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(m_state[i]);
+    }
+}
+
+std::string Sha256::FinalHex() {
+    static const char kHex[] = "0123456789abcdef";
+    uint8_t digest[kDigestSize];
+    Final(digest);
+
+    std::string hex(kDigestSize * 2, '0');
+    for (size_t i = 0; i < kDigestSize; i++) {
+        hex[i * 2] = kHex[digest[i] >> 4];
+        hex[i * 2 + 1] = kHex[digest[i] & 0x0F];
+    }
+    return hex;
+}
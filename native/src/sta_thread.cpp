@@ -0,0 +1,168 @@
+/**
+ * STA Worker Thread
+ *
+ * Jobs are queued under a mutex and the apartment is woken by posting to a
+ * message-only window rather than PostThreadMessage, so a modal loop inside
+ * a COM call (OpenDoc pumps messages while parsing) can't swallow the wakeup.
+ */
+
+#include "sta_thread.h"
+
+static const UINT kRunJobsMessage = WM_APP + 1;
+static const wchar_t* kDispatcherClass = L"BluePLMStaDispatcher";
+
+LRESULT CALLBACK StaThread::DispatcherWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    if (msg == kRunJobsMessage) {
+        auto* self = reinterpret_cast<StaThread*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+        if (self) self->DrainJobs();
+        return 0;
+    }
+    return DefWindowProcW(hwnd, msg, wParam, lParam);
+}
+
+StaThread::~StaThread() {
+    Stop();
+}
+
+bool StaThread::Start() {
+    if (m_running) return m_comReady;
+
+    HANDLE readyEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!readyEvent) return false;
+
+    m_thread = std::thread(&StaThread::Run, this, readyEvent);
+    WaitForSingleObject(readyEvent, INFINITE);
+    CloseHandle(readyEvent);
+
+    if (!m_comReady) {
+        m_thread.join();
+        return false;
+    }
+
+    m_running = true;
+    return true;
+}
+
+void StaThread::Stop() {
+    if (!m_running) return;
+    m_running = false;
+
+    // Queue the quit last: nothing posted after this point is accepted
+    HWND hwndDispatcher = m_hwndDispatcher.exchange(nullptr);
+    if (hwndDispatcher) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(nullptr);  // a null job means "quit after draining"
+        }
+        PostMessageW(hwndDispatcher, kRunJobsMessage, 0, 0);
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_threadId = 0;
+}
+
+bool StaThread::Post(Job job) {
+    HWND hwndDispatcher = m_hwndDispatcher;
+    if (!hwndDispatcher) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    return PostMessageW(hwndDispatcher, kRunJobsMessage, 0, 0) != 0;
+}
+
+bool StaThread::Invoke(Job job) {
+    if (IsCurrentThread()) {
+        job();
+        return true;
+    }
+
+    HANDLE doneEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!doneEvent) return false;
+
+    bool posted = Post([&job, doneEvent]() {
+        job();
+        SetEvent(doneEvent);
+    });
+
+    if (posted) {
+        // Only dispatch *sent* messages: posted input stays queued for the
+        // caller's own loop, but cross-thread SendMessage can't deadlock us.
+        while (MsgWaitForMultipleObjectsEx(1, &doneEvent, INFINITE, QS_SENDMESSAGE, 0)
+               == WAIT_OBJECT_0 + 1) {
+            MSG msg;
+            PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+        }
+    }
+
+    CloseHandle(doneEvent);
+    return posted;
+}
+
+void StaThread::Run(HANDLE readyEvent) {
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+    if (FAILED(hr)) {
+        SetEvent(readyEvent);
+        return;
+    }
+
+    WNDCLASSEXW wc = {};
+    wc.cbSize = sizeof(WNDCLASSEXW);
+    wc.lpfnWndProc = DispatcherWndProc;
+    wc.hInstance = GetModuleHandle(nullptr);
+    wc.lpszClassName = kDispatcherClass;
+    RegisterClassExW(&wc);  // fails harmlessly when another apartment registered it
+
+    HWND hwndDispatcher = CreateWindowExW(0, kDispatcherClass, L"", 0, 0, 0, 0, 0,
+        HWND_MESSAGE, nullptr, GetModuleHandle(nullptr), nullptr);
+    if (!hwndDispatcher) {
+        CoUninitialize();
+        SetEvent(readyEvent);
+        return;
+    }
+    SetWindowLongPtrW(hwndDispatcher, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+    m_hwndDispatcher = hwndDispatcher;
+    m_threadId = GetCurrentThreadId();
+    m_comReady = true;
+    SetEvent(readyEvent);
+
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+
+    DrainJobs();
+    DestroyWindow(hwndDispatcher);
+    CoUninitialize();
+}
+
+void StaThread::DrainJobs() {
+    // Re-entrancy guard: a modal loop inside a job may dispatch our wakeup
+    // again. Leave the queue to the outer drain so jobs stay in order.
+    static thread_local bool draining = false;
+    if (draining) return;
+    draining = true;
+
+    for (;;) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_jobs.empty()) break;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        if (!job) {
+            PostQuitMessage(0);
+            continue;
+        }
+        m_busy = true;
+        job();
+        m_busy = false;
+    }
+
+    draining = false;
+}
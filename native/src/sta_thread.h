@@ -0,0 +1,65 @@
+/**
+ * STA Worker Thread
+ *
+ * A dedicated single-threaded apartment with its own GetMessage loop.
+ * Everything that touches the eDrawings control runs here so the ActiveX
+ * control gets a real message pump and long calls like OpenDoc never run
+ * on Node's main thread.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class StaThread {
+public:
+    using Job = std::function<void()>;
+
+    StaThread() = default;
+    ~StaThread();
+
+    StaThread(const StaThread&) = delete;
+    StaThread& operator=(const StaThread&) = delete;
+
+    // Start the thread and wait until its message queue exists.
+    // Safe to call repeatedly; returns false if COM could not be initialized.
+    bool Start();
+
+    // Run queued jobs, then leave the message loop and join the thread.
+    // The object stays usable: Post and Invoke just fail from then on.
+    void Stop();
+
+    // Queue a job to run on the apartment. Returns false if not running.
+    bool Post(Job job);
+
+    // Run a job on the apartment and wait for it. While waiting, the caller
+    // keeps servicing sent messages so cross-thread SetParent/SetWindowPos
+    // from the apartment can't deadlock against the waiting thread.
+    bool Invoke(Job job);
+
+    bool IsCurrentThread() const { return GetCurrentThreadId() == m_threadId; }
+    bool IsRunning() const { return m_running; }
+
+    // A job is running right now (possibly pumping inside a modal loop)
+    bool IsBusy() const { return m_busy; }
+
+private:
+    static LRESULT CALLBACK DispatcherWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+    void Run(HANDLE readyEvent);
+    void DrainJobs();
+
+    std::thread m_thread;
+    DWORD m_threadId = 0;
+    std::atomic<HWND> m_hwndDispatcher{nullptr};  // null once stopping
+    bool m_running = false;
+    bool m_comReady = false;
+    std::atomic<bool> m_busy{false};
+
+    std::mutex m_mutex;
+    std::deque<Job> m_jobs;
+};
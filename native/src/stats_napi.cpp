@@ -0,0 +1,61 @@
+/**
+ * Native Statistics Bindings
+ *
+ * getNativeStats() -> { [op]: { count, meanUs, p50Us, p90Us, p99Us, maxUs } }
+ * getMemoryStats() -> { commitBytes, budgetBytes, lowMemory, pressureEvents,
+ *                       documentsEvicted, controlsEvicted }
+ * resetNativeStats()  (latencies and eviction counters)
+ *
+ * Synchronous: a snapshot sums a few KB of counters per thread that has
+ * ever recorded, far cheaper than a round trip to the pool.
+ */
+
+#include "addon.h"
+
+#include <vector>
+
+#include "memory_guard.h"
+#include "native_stats.h"
+
+static Napi::Value GetNativeStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    Napi::Object stats = Napi::Object::New(env);
+    for (const NativeOpSummary& summary : NativeStats::Snapshot()) {
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("count", Napi::Number::New(env, static_cast<double>(summary.count)));
+        entry.Set("meanUs", Napi::Number::New(env, summary.meanUs));
+        entry.Set("p50Us", Napi::Number::New(env, summary.p50Us));
+        entry.Set("p90Us", Napi::Number::New(env, summary.p90Us));
+        entry.Set("p99Us", Napi::Number::New(env, summary.p99Us));
+        entry.Set("maxUs", Napi::Number::New(env, summary.maxUs));
+        stats.Set(summary.name, entry);
+    }
+    return stats;
+}
+
+static Napi::Value GetMemoryStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    MemoryStats memory = MemoryGuard::Shared().Snapshot();
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("commitBytes", Napi::Number::New(env, static_cast<double>(memory.commitBytes)));
+    stats.Set("budgetBytes", Napi::Number::New(env, static_cast<double>(memory.budgetBytes)));
+    stats.Set("lowMemory", Napi::Boolean::New(env, memory.lowMemory));
+    stats.Set("pressureEvents", Napi::Number::New(env, static_cast<double>(memory.pressureEvents)));
+    stats.Set("documentsEvicted", Napi::Number::New(env, static_cast<double>(memory.documentsEvicted)));
+    stats.Set("controlsEvicted", Napi::Number::New(env, static_cast<double>(memory.controlsEvicted)));
+    return stats;
+}
+
+static Napi::Value ResetNativeStats(const Napi::CallbackInfo& info) {
+    NativeStats::Reset();
+    MemoryGuard::Shared().ResetCounters();
+    return info.Env().Undefined();
+}
+
+void InitStatsBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("getNativeStats", Napi::Function::New(env, GetNativeStats));
+    exports.Set("getMemoryStats", Napi::Function::New(env, GetMemoryStats));
+    exports.Set("resetNativeStats", Napi::Function::New(env, ResetNativeStats));
+}
@@ -0,0 +1,27 @@
+/**
+ * UTF-8 / UTF-16 conversion shared by the bindings
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+
+// One pass: UTF-8 never needs more UTF-16 units than it has bytes. JS
+// strings skip this entirely (JsToWide reads their UTF-16 directly).
+inline std::wstring Utf8ToWide(const std::string& utf8) {
+    if (utf8.empty()) return std::wstring();
+    std::wstring wide(utf8.size(), L'\0');
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()),
+        &wide[0], static_cast<int>(wide.size()));
+    wide.resize(wlen > 0 ? wlen : 0);
+    return wide;
+}
+
+inline std::string WideToUtf8(const std::wstring& wide) {
+    int len = WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return std::string();
+    std::string utf8(len - 1, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), -1, &utf8[0], len, nullptr, nullptr);
+    return utf8;
+}
@@ -0,0 +1,104 @@
+/**
+ * Native Worker Pool
+ */
+
+#include "thread_pool.h"
+
+#include <windows.h>
+#include <algorithm>
+
+// Thumbnailing and hashing are I/O-heavy: a couple of threads past the core
+// count keeps the disk busy, but more than this only thrashes the cache.
+static const size_t kMinThreads = 2;
+static const size_t kMaxThreads = 8;
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool(std::clamp<size_t>(std::thread::hardware_concurrency(), kMinThreads, kMaxThreads));
+    return pool;
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : m_threadCount(std::max<size_t>(threadCount, 1)) {}
+
+ThreadPool::~ThreadPool() {
+    Shutdown();
+}
+
+void ThreadPool::EnsureStarted() {
+    // Caller holds m_mutex
+    if (!m_threads.empty() || m_stopping) return;
+    for (size_t i = 0; i < m_threadCount; i++) {
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+void ThreadPool::Submit(Job job, JobPriority priority) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        EnsureStarted();
+        m_jobs[static_cast<size_t>(priority)].push_back(std::move(job));
+    }
+    m_cv.notify_one();
+}
+
+// Caller holds m_mutex
+bool ThreadPool::HasRunnable() const {
+    for (size_t i = 0; i + 1 < kJobPriorityCount; i++) {
+        if (!m_jobs[i].empty()) return true;
+    }
+    // Keep one worker back from prefetch (unless there is only one)
+    size_t prefetchLimit = m_threadCount > 1 ? m_threadCount - 1 : 1;
+    return !m_jobs[kJobPriorityCount - 1].empty() && m_runningPrefetch < prefetchLimit;
+}
+
+void ThreadPool::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_threads.clear();
+}
+
+void ThreadPool::WorkerLoop() {
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+
+    for (;;) {
+        Job job;
+        bool prefetch = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stopping || HasRunnable(); });
+            // Queued work is dropped on shutdown: the env it would report to is gone
+            if (m_stopping) break;
+            for (size_t i = 0; i < kJobPriorityCount; i++) {
+                if (m_jobs[i].empty()) continue;
+                prefetch = i == kJobPriorityCount - 1;
+                job = std::move(m_jobs[i].front());
+                m_jobs[i].pop_front();
+                break;
+            }
+            if (prefetch) m_runningPrefetch++;
+        }
+        // Background mode lowers CPU, I/O and memory priority together, so
+        // prefetch reads queue behind anything the user is waiting for
+        if (prefetch) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+        job();
+        if (prefetch) {
+            SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_runningPrefetch--;
+            }
+            // A held-back prefetch job may now be runnable
+            m_cv.notify_one();
+        }
+    }
+
+    if (SUCCEEDED(hr)) CoUninitialize();
+}
@@ -0,0 +1,59 @@
+/**
+ * Native Worker Pool
+ *
+ * Fixed set of background threads for file work (thumbnail extraction,
+ * hashing, ...). Each worker is its own single-threaded apartment so
+ * apartment-threaded shell handlers and WIC can be created in-proc without
+ * bouncing through Node's main thread.
+ *
+ * Jobs are queued by priority: Visible jobs run before anything else that
+ * is waiting, and Prefetch jobs never occupy the last free worker, so a
+ * visible request starts without waiting for a running prefetch batch.
+ * Prefetch jobs also run in background mode (low CPU and I/O priority).
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "job_registry.h"
+
+class ThreadPool {
+public:
+    using Job = std::function<void()>;
+
+    // Process-wide pool sized to the machine. Threads start on first Submit.
+    static ThreadPool& Shared();
+
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(Job job, JobPriority priority = JobPriority::Normal);
+
+    // Drop queued jobs, let running ones finish and join the workers.
+    // Submit after this is a no-op.
+    void Shutdown();
+
+    size_t Size() const { return m_threadCount; }
+
+private:
+    void EnsureStarted();
+    void WorkerLoop();
+    bool HasRunnable() const;
+
+    size_t m_threadCount;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Job> m_jobs[kJobPriorityCount];
+    size_t m_runningPrefetch = 0;
+    std::vector<std::thread> m_threads;
+    bool m_stopping = false;
+};
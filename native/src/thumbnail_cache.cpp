@@ -0,0 +1,643 @@
+/**
+ * Persistent Thumbnail Cache
+ */
+
+#include "thumbnail_cache.h"
+
+#include <windows.h>
+#include <shlobj.h>
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+static const uint32_t kPackMagic = 0x50545042;    // "BPTP"
+static const uint32_t kIndexMagic = 0x49545042;   // "BPTI"
+static const uint32_t kRecordMagic = 0x52545042;  // "BPTR"
+static const uint32_t kFormatVersion = 2;  // 2: format in the key
+
+// Stale records (edited files) are never rewritten in place; an append that
+// would pass this size first compacts the pack down to its newest entries
+static const uint64_t kMaxPackBytes = 1ull << 30;
+static const uint64_t kCompactKeepBytes = kMaxPackBytes / 2;
+// Pending entries that trigger an index rewrite
+static const size_t kFlushThreshold = 256;
+static const uint32_t kMaxImageBytes = 16u * 1024 * 1024;
+
+enum ImageFormat : uint32_t { FormatUnknown = 0, FormatPng = 1, FormatJpeg = 2, FormatBmp = 3 };
+
+#pragma pack(push, 1)
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+};
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t length;
+    ThumbnailCacheKey key;
+    uint16_t width;
+    uint16_t height;
+    uint32_t format;
+};
+
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+    uint64_t packBytes;  // pack length covered by this index
+};
+
+struct IndexEntry {
+    ThumbnailCacheKey key;
+    uint64_t offset;
+    uint32_t length;
+    uint16_t width;
+    uint16_t height;
+    uint32_t format;
+};
+#pragma pack(pop)
+
+static uint32_t FormatFromMime(const std::string& mimeType) {
+    if (mimeType == "image/png") return FormatPng;
+    if (mimeType == "image/jpeg") return FormatJpeg;
+    if (mimeType == "image/bmp") return FormatBmp;
+    return FormatUnknown;
+}
+
+static const char* MimeFromFormat(uint32_t format) {
+    switch (format) {
+        case FormatPng: return "image/png";
+        case FormatJpeg: return "image/jpeg";
+        case FormatBmp: return "image/bmp";
+        default: return "application/octet-stream";
+    }
+}
+
+// The pack is opened overlapped so lookups and appends at different
+// offsets run side by side; each call waits on its own thread's event
+static HANDLE ThreadIoEvent() {
+    struct Event {
+        HANDLE handle = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        ~Event() { if (handle) CloseHandle(handle); }
+    };
+    thread_local Event event;
+    return event.handle;
+}
+
+static bool ReadAt(HANDLE file, uint64_t offset, void* dst, DWORD length) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    overlapped.hEvent = ThreadIoEvent();
+    if (!ReadFile(file, dst, length, nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING) return false;
+    DWORD read = 0;
+    return GetOverlappedResult(file, &overlapped, &read, TRUE) && read == length;
+}
+
+static bool WriteAt(HANDLE file, uint64_t offset, const void* src, DWORD length) {
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    overlapped.hEvent = ThreadIoEvent();
+    if (!WriteFile(file, src, length, nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING) return false;
+    DWORD written = 0;
+    return GetOverlappedResult(file, &overlapped, &written, TRUE) && written == length;
+}
+
+static HANDLE OpenPack(const std::wstring& path, DWORD disposition) {
+    return CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        disposition, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+}
+
+static bool Truncate(HANDLE file, uint64_t length) {
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(length);
+    return SetFilePointerEx(file, position, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+}
+
+bool ThumbnailCacheKey::operator<(const ThumbnailCacheKey& other) const {
+    return std::tie(volumeSerial, fileId, size, lastWriteTime, edge, format) <
+        std::tie(other.volumeSerial, other.fileId, other.size, other.lastWriteTime, other.edge, other.format);
+}
+
+bool ThumbnailCacheKey::operator==(const ThumbnailCacheKey& other) const {
+    return !(*this < other) && !(other < *this);
+}
+
+ThumbnailCache& ThumbnailCache::Shared() {
+    static ThumbnailCache cache;
+    return cache;
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    Close();
+}
+
+bool ThumbnailCache::KeyForFile(const std::wstring& path, ThumbnailCacheKey* key) {
+    // Attributes-only open: no read access needed, works on in-use files
+    HANDLE file = CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    BY_HANDLE_FILE_INFORMATION info = {};
+    BOOL ok = GetFileInformationByHandle(file, &info);
+    CloseHandle(file);
+    if (!ok) return false;
+
+    key->volumeSerial = info.dwVolumeSerialNumber;
+    key->fileId = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    key->size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    key->lastWriteTime = (static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+        info.ftLastWriteTime.dwLowDateTime;
+    key->edge = 0;
+    key->format = 0;
+    return true;
+}
+
+bool ThumbnailCache::Open(const std::wstring& directory, const std::vector<uint32_t>& edges,
+    ThumbnailFormat format, std::string* error) {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WaitIdleLocked(lock);
+    if (m_pack) {
+        FlushLocked();
+        m_index.Close();
+        CloseHandle(m_pack);
+        m_pack = nullptr;
+    }
+
+    int created = SHCreateDirectoryExW(nullptr, directory.c_str(), nullptr);
+    if (created != ERROR_SUCCESS && created != ERROR_ALREADY_EXISTS && created != ERROR_FILE_EXISTS) {
+        *error = "Could not create cache directory";
+        return false;
+    }
+
+    m_directory = directory;
+    m_edges = edges;
+    m_format = format;
+    m_pending.clear();
+    m_writing.clear();
+    m_appendFailed = false;
+    m_indexCount = 0;
+
+    HANDLE pack = OpenPack(m_directory + L"\\thumbs.pack", OPEN_ALWAYS);
+    if (pack == INVALID_HANDLE_VALUE) {
+        *error = "Could not open cache pack (in use by another instance?)";
+        return false;
+    }
+    m_pack = pack;
+
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(pack, &size);
+    m_packBytes = static_cast<uint64_t>(size.QuadPart);
+
+    PackHeader header = {};
+    bool valid = m_packBytes >= sizeof(header) && m_packBytes <= kMaxPackBytes &&
+        ReadAt(pack, 0, &header, sizeof(header)) && header.magic == kPackMagic &&
+        header.version == kFormatVersion;
+    if (!valid) {
+        // Unknown, outdated or oversized: start over
+        DeleteFileW((m_directory + L"\\thumbs.idx").c_str());
+        header.magic = kPackMagic;
+        header.version = kFormatVersion;
+        if (!Truncate(pack, 0) || !WriteAt(pack, 0, &header, sizeof(header))) {
+            CloseHandle(pack);
+            m_pack = nullptr;
+            *error = "Could not initialize cache pack";
+            return false;
+        }
+        m_packBytes = sizeof(header);
+    }
+
+    uint64_t indexed = MapIndexLocked() ? reinterpret_cast<const IndexHeader*>(m_index.Data())->packBytes
+                                        : sizeof(PackHeader);
+    RecoverTailLocked(indexed);
+    FlushLocked();
+    return true;
+}
+
+void ThumbnailCache::Close() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WaitIdleLocked(lock);
+    if (!m_pack) return;
+    FlushLocked();
+    m_index.Close();
+    m_indexCount = 0;
+    CloseHandle(m_pack);
+    m_pack = nullptr;
+}
+
+bool ThumbnailCache::IsOpen() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pack != nullptr;
+}
+
+std::vector<uint32_t> ThumbnailCache::Edges() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_edges;
+}
+
+ThumbnailFormat ThumbnailCache::Format() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_format;
+}
+
+bool ThumbnailCache::MapIndexLocked() {
+    m_index.Close();
+    m_indexCount = 0;
+
+    std::string error;
+    if (!m_index.Open(m_directory + L"\\thumbs.idx", &error)) return false;
+
+    IndexHeader header = {};
+    bool valid = m_index.Read(0, &header, sizeof(header)) && header.magic == kIndexMagic &&
+        header.version == kFormatVersion &&
+        m_index.Size() == sizeof(header) + header.count * sizeof(IndexEntry) &&
+        header.packBytes >= sizeof(PackHeader) && header.packBytes <= m_packBytes;
+    if (!valid) {
+        // Written against a pack we no longer have; rebuild from the pack
+        m_index.Close();
+        return false;
+    }
+
+    m_indexCount = header.count;
+    return true;
+}
+
+void ThumbnailCache::RecoverTailLocked(uint64_t indexedPackBytes) {
+    uint64_t offset = indexedPackBytes;
+    while (offset < m_packBytes) {
+        RecordHeader record = {};
+        if (m_packBytes - offset < sizeof(record) || !ReadAt(m_pack, offset, &record, sizeof(record)) ||
+            record.magic != kRecordMagic || record.length > kMaxImageBytes ||
+            record.length > m_packBytes - offset - sizeof(record)) {
+            // Torn write from a crash; drop it and everything after
+            Truncate(m_pack, offset);
+            m_packBytes = offset;
+            break;
+        }
+
+        Location location;
+        location.offset = offset + sizeof(record);
+        location.length = record.length;
+        location.width = record.width;
+        location.height = record.height;
+        location.format = record.format;
+        m_pending[record.key] = location;
+        offset = location.offset + record.length;
+    }
+}
+
+bool ThumbnailCache::FindLocked(const ThumbnailCacheKey& key, Location* location) {
+    auto pending = m_pending.find(key);
+    if (pending != m_pending.end()) {
+        *location = pending->second;
+        return true;
+    }
+    if (m_indexCount == 0) return false;
+
+    const uint8_t* entries = m_index.Data() + sizeof(IndexHeader);
+    uint64_t low = 0, high = m_indexCount;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        IndexEntry entry;
+        memcpy(&entry, entries + mid * sizeof(IndexEntry), sizeof(entry));
+        if (entry.key < key) {
+            low = mid + 1;
+        } else if (key < entry.key) {
+            high = mid;
+        } else {
+            location->offset = entry.offset;
+            location->length = entry.length;
+            location->width = entry.width;
+            location->height = entry.height;
+            location->format = entry.format;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThumbnailCache::WaitIdleLocked(std::unique_lock<std::mutex>& lock) {
+    // Nothing may swap or close m_pack under a read, an append or a compaction
+    m_idle.wait(lock, [this]() { return m_users == 0 && !m_compacting; });
+}
+
+void ThumbnailCache::EndUseLocked() {
+    if (--m_users == 0) m_idle.notify_all();
+}
+
+bool ThumbnailCache::Lookup(const ThumbnailCacheKey& key, ThumbnailImage* image) {
+    Location location;
+    HANDLE pack = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pack) return false;
+        if (!FindLocked(key, &location) || location.offset + location.length > m_packBytes) {
+            m_misses++;
+            return false;
+        }
+        pack = m_pack;
+        m_users++;
+    }
+
+    // Only the lookup is under the lock; the read runs alongside the others
+    image->data.resize(location.length);
+    bool read = ReadAt(pack, location.offset, image->data.data(), location.length);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        EndUseLocked();
+        if (!read) {
+            m_misses++;
+        } else {
+            m_hits++;
+        }
+    }
+    if (!read) {
+        image->data.clear();
+        return false;
+    }
+
+    image->success = true;
+    image->error.clear();
+    image->mimeType = MimeFromFormat(location.format);
+    image->source = "cache";
+    image->width = location.width;
+    image->height = location.height;
+    return true;
+}
+
+void ThumbnailCache::Store(const ThumbnailCacheKey& key, const ThumbnailImage& image) {
+    if (!image.success || image.data.empty() || image.data.size() > kMaxImageBytes) return;
+
+    RecordHeader record = {};
+    record.magic = kRecordMagic;
+    record.length = static_cast<uint32_t>(image.data.size());
+    record.key = key;
+    record.width = static_cast<uint16_t>(std::min<uint32_t>(image.width, UINT16_MAX));
+    record.height = static_cast<uint16_t>(std::min<uint32_t>(image.height, UINT16_MAX));
+    record.format = FormatFromMime(image.mimeType);
+
+    // One write per record keeps a torn append detectable by RecoverTail
+    std::vector<uint8_t> buffer(sizeof(record) + image.data.size());
+    memcpy(buffer.data(), &record, sizeof(record));
+    memcpy(buffer.data() + sizeof(record), image.data.data(), image.data.size());
+
+    uint64_t offset = 0;
+    HANDLE pack = nullptr;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Dropped while the pack is being compacted; the next miss stores it
+        if (!m_pack || m_compacting || m_appendFailed) return;
+
+        Location existing;
+        if (FindLocked(key, &existing)) return;
+
+        if (m_packBytes + buffer.size() > kMaxPackBytes) {
+            lock.unlock();
+            if (!Compact()) return;
+            continue;
+        }
+
+        // Reserve the range; the write itself happens outside the lock
+        offset = m_packBytes;
+        m_packBytes += buffer.size();
+        m_writing.insert(offset);
+        pack = m_pack;
+        m_users++;
+        break;
+    }
+
+    bool written = WriteAt(pack, offset, buffer.data(), static_cast<DWORD>(buffer.size()));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    EndUseLocked();
+    if (!written) {
+        if (offset + buffer.size() == m_packBytes) {
+            // Last reservation: give the range back
+            m_writing.erase(offset);
+            m_packBytes = offset;
+        } else {
+            // A hole with records after it would be read as a torn tail and
+            // take them along; keep the index short of it, and stop
+            // appending until the next Open or compaction
+            m_appendFailed = true;
+        }
+        return;
+    }
+    m_writing.erase(offset);
+
+    Location location;
+    location.offset = offset + sizeof(record);
+    location.length = record.length;
+    location.width = record.width;
+    location.height = record.height;
+    location.format = record.format;
+    m_pending[key] = location;
+
+    if (m_pending.size() >= kFlushThreshold) FlushLocked();
+}
+
+bool ThumbnailCache::Compact() {
+    // Records are appended, so offset order is age order: keep the newest
+    // up to kCompactKeepBytes in a fresh pack. Lookups keep using the old
+    // pack until the swap; Stores are dropped meanwhile.
+    std::vector<std::pair<ThumbnailCacheKey, Location>> live;
+    HANDLE pack = nullptr;
+    std::wstring directory;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pack || m_compacting) return false;
+        m_compacting = true;
+        m_users++;
+        pack = m_pack;
+        directory = m_directory;
+
+        std::map<ThumbnailCacheKey, Location> entries;
+        const uint8_t* indexed = m_indexCount ? m_index.Data() + sizeof(IndexHeader) : nullptr;
+        for (uint64_t i = 0; i < m_indexCount; i++) {
+            IndexEntry entry;
+            memcpy(&entry, indexed + i * sizeof(IndexEntry), sizeof(entry));
+            Location& location = entries[entry.key];
+            location.offset = entry.offset;
+            location.length = entry.length;
+            location.width = entry.width;
+            location.height = entry.height;
+            location.format = entry.format;
+        }
+        for (const auto& pending : m_pending) entries[pending.first] = pending.second;
+        live.assign(entries.begin(), entries.end());
+    }
+
+    std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) {
+        return a.second.offset > b.second.offset;
+    });
+    uint64_t kept = 0;
+    size_t count = 0;
+    while (count < live.size() && kept + sizeof(RecordHeader) + live[count].second.length <= kCompactKeepBytes) {
+        kept += sizeof(RecordHeader) + live[count].second.length;
+        count++;
+    }
+    live.resize(count);
+    std::reverse(live.begin(), live.end());
+
+    // Copy outside the lock, oldest kept record first
+    std::wstring packPath = directory + L"\\thumbs.pack";
+    std::wstring tempPath = packPath + L".tmp";
+    std::map<ThumbnailCacheKey, Location> moved;
+    uint64_t packBytes = sizeof(PackHeader);
+    HANDLE temp = OpenPack(tempPath, CREATE_ALWAYS);
+    bool ok = temp != INVALID_HANDLE_VALUE;
+    if (ok) {
+        PackHeader header = { kPackMagic, kFormatVersion };
+        ok = WriteAt(temp, 0, &header, sizeof(header));
+    }
+    std::vector<uint8_t> buffer;
+    for (size_t i = 0; ok && i < live.size(); i++) {
+        const Location& from = live[i].second;
+        buffer.resize(sizeof(RecordHeader) + from.length);
+        if (!ReadAt(pack, from.offset - sizeof(RecordHeader), buffer.data(), static_cast<DWORD>(buffer.size()))) {
+            continue;
+        }
+        RecordHeader record;
+        memcpy(&record, buffer.data(), sizeof(record));
+        if (record.magic != kRecordMagic || !(record.key == live[i].first) || record.length != from.length) {
+            continue;  // not what the index says; leave it behind
+        }
+        if (!WriteAt(temp, packBytes, buffer.data(), static_cast<DWORD>(buffer.size()))) {
+            ok = false;
+            break;
+        }
+        Location to = from;
+        to.offset = packBytes + sizeof(RecordHeader);
+        moved[live[i].first] = to;
+        packBytes += buffer.size();
+    }
+    if (temp != INVALID_HANDLE_VALUE) CloseHandle(temp);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    EndUseLocked();
+    // Lookups in flight still read the old pack
+    m_idle.wait(lock, [this]() { return m_users == 0; });
+    m_compacting = false;
+
+    bool swapped = false;
+    if (ok) {
+        m_index.Close();
+        m_indexCount = 0;
+        CloseHandle(m_pack);
+        // The old index describes the old pack: gone before the pack is
+        // replaced, so a crash in between rebuilds from a pack scan
+        DeleteFileW((directory + L"\\thumbs.idx").c_str());
+        swapped = MoveFileExW(tempPath.c_str(), packPath.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+
+        m_pending.clear();
+        m_writing.clear();
+        m_appendFailed = false;
+        m_pack = OpenPack(packPath, OPEN_EXISTING);
+        if (m_pack == INVALID_HANDLE_VALUE) {
+            m_pack = nullptr;
+        } else if (swapped) {
+            m_pending = std::move(moved);
+            m_packBytes = packBytes;
+        } else {
+            // Still the old pack, now without an index: rescan it
+            LARGE_INTEGER size = {};
+            GetFileSizeEx(m_pack, &size);
+            m_packBytes = static_cast<uint64_t>(size.QuadPart);
+            RecoverTailLocked(sizeof(PackHeader));
+        }
+        FlushLocked();
+    }
+    if (!swapped) DeleteFileW(tempPath.c_str());
+    m_idle.notify_all();
+    return swapped;
+}
+
+void ThumbnailCache::Flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FlushLocked();
+}
+
+void ThumbnailCache::FlushLocked() {
+    if (!m_pack || m_pending.empty()) return;
+
+    // Appends still being written leave a gap a crash would truncate at;
+    // index only what lies before the first of them
+    uint64_t durable = m_writing.empty() ? m_packBytes : *m_writing.begin();
+
+    // Merge the mapped (sorted) index with the pending (sorted) table
+    std::vector<IndexEntry> merged;
+    merged.reserve(static_cast<size_t>(m_indexCount) + m_pending.size());
+    const uint8_t* entries = m_indexCount ? m_index.Data() + sizeof(IndexHeader) : nullptr;
+    uint64_t i = 0;
+    auto pending = m_pending.begin();
+    while (i < m_indexCount || pending != m_pending.end()) {
+        if (pending != m_pending.end() && pending->second.offset >= durable) {
+            ++pending;
+            continue;
+        }
+        IndexEntry entry;
+        if (i < m_indexCount) memcpy(&entry, entries + i * sizeof(IndexEntry), sizeof(entry));
+
+        if (pending != m_pending.end() && (i >= m_indexCount || !(entry.key < pending->first))) {
+            if (i < m_indexCount && entry.key == pending->first) i++;  // pending wins
+            entry.key = pending->first;
+            entry.offset = pending->second.offset;
+            entry.length = pending->second.length;
+            entry.width = pending->second.width;
+            entry.height = pending->second.height;
+            entry.format = pending->second.format;
+            ++pending;
+        } else {
+            i++;
+        }
+        merged.push_back(entry);
+    }
+
+    IndexHeader header = {};
+    header.magic = kIndexMagic;
+    header.version = kFormatVersion;
+    header.count = merged.size();
+    header.packBytes = durable;
+
+    std::wstring indexPath = m_directory + L"\\thumbs.idx";
+    std::wstring tempPath = indexPath + L".tmp";
+    HANDLE temp = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (temp == INVALID_HANDLE_VALUE) return;
+
+    bool written = WriteAt(temp, 0, &header, sizeof(header)) &&
+        (merged.empty() || WriteAt(temp, sizeof(header), merged.data(),
+            static_cast<DWORD>(merged.size() * sizeof(IndexEntry))));
+    CloseHandle(temp);
+    if (!written) {
+        DeleteFileW(tempPath.c_str());
+        return;
+    }
+
+    // Readers only ever see the old index or the complete new one
+    m_index.Close();
+    m_indexCount = 0;
+    if (MoveFileExW(tempPath.c_str(), indexPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            it = it->second.offset < durable ? m_pending.erase(it) : std::next(it);
+        }
+    } else {
+        DeleteFileW(tempPath.c_str());
+    }
+    MapIndexLocked();
+}
+
+ThumbnailCacheStats ThumbnailCache::Stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ThumbnailCacheStats stats;
+    stats.entries = m_indexCount + m_pending.size();
+    stats.packBytes = m_pack ? m_packBytes : 0;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    return stats;
+}
@@ -0,0 +1,123 @@
+/**
+ * Persistent Thumbnail Cache
+ *
+ * Remembers encoded thumbnails between sessions so a warm start never
+ * re-extracts an unchanged file. Two files live in the cache directory:
+ *
+ *   thumbs.pack  appended records: header (key, size, format) + image
+ *   thumbs.idx   sorted array of (key -> pack offset), memory-mapped
+ *
+ * A key is (volume serial, file ID, size, last-write time, edge, format),
+ * read from one GetFileInformationByHandle call, so renames keep their entries
+ * and any edit to the file misses naturally. Lookups binary-search the
+ * mapped index and then read one record; nothing is loaded up-front.
+ *
+ * New entries go to the pack immediately and to a small in-memory table;
+ * the index is rewritten (merged, then atomically replaced) on Flush.
+ * Records appended after the last index write are recovered by scanning
+ * the pack tail on Open, so a crash loses nothing.
+ *
+ * The pack reaching 1 GB is compacted: the newest entries, up to half of
+ * that, are copied into a fresh pack that replaces it.
+ *
+ * Thread-safe; used from the shared worker pool. The mutex covers only
+ * the tables and the append offset. Reads and appends run positionally on
+ * the overlapped pack outside it, so workers never queue behind one
+ * another's disk I/O.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "thumbnail_extractor.h"
+
+#pragma pack(push, 1)
+struct ThumbnailCacheKey {
+    uint64_t fileId = 0;
+    uint64_t size = 0;
+    uint64_t lastWriteTime = 0;
+    uint32_t volumeSerial = 0;
+    uint32_t edge = 0;
+    uint32_t format = 0;  // ThumbnailFormat asked for, not the one produced
+
+    bool operator<(const ThumbnailCacheKey& other) const;
+    bool operator==(const ThumbnailCacheKey& other) const;
+};
+#pragma pack(pop)
+
+struct ThumbnailCacheStats {
+    uint64_t entries = 0;
+    uint64_t packBytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+class ThumbnailCache {
+public:
+    static ThumbnailCache& Shared();
+
+    ~ThumbnailCache();
+
+    // Opens (creating if needed) the cache in directory. edges are the
+    // sizes pre-rendered on a miss, in addition to whatever was asked for;
+    // format is what warming renders.
+    bool Open(const std::wstring& directory, const std::vector<uint32_t>& edges,
+        ThumbnailFormat format, std::string* error);
+    void Close();
+    bool IsOpen();
+    std::vector<uint32_t> Edges();
+    ThumbnailFormat Format();
+
+    // Identity of a file's current contents; key.edge and key.format are left 0
+    static bool KeyForFile(const std::wstring& path, ThumbnailCacheKey* key);
+
+    bool Lookup(const ThumbnailCacheKey& key, ThumbnailImage* image);
+    void Store(const ThumbnailCacheKey& key, const ThumbnailImage& image);
+
+    // Merge pending entries into the on-disk index
+    void Flush();
+
+    ThumbnailCacheStats Stats();
+
+private:
+    struct Location {
+        uint64_t offset = 0;  // of the image bytes in the pack
+        uint32_t length = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint32_t format = 0;
+    };
+
+    void WaitIdleLocked(std::unique_lock<std::mutex>& lock);
+    void EndUseLocked();
+    bool Compact();
+    bool FindLocked(const ThumbnailCacheKey& key, Location* location);
+    void RecoverTailLocked(uint64_t indexedPackBytes);
+    void FlushLocked();
+    bool MapIndexLocked();
+
+    std::mutex m_mutex;
+    std::wstring m_directory;
+    std::vector<uint32_t> m_edges;
+    ThumbnailFormat m_format = ThumbnailFormat::Auto;
+    void* m_pack = nullptr;  // HANDLE, overlapped; reads at offsets, writes append
+    uint64_t m_packBytes = 0;  // includes ranges reserved by appends in flight
+    std::set<uint64_t> m_writing;  // record offsets being appended
+    bool m_appendFailed = false;
+    bool m_compacting = false;
+    size_t m_users = 0;  // reads, appends and a compaction using m_pack outside the lock
+    std::condition_variable m_idle;
+    MappedFile m_index;
+    uint64_t m_indexCount = 0;
+    std::map<ThumbnailCacheKey, Location> m_pending;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
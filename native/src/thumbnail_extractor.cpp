@@ -0,0 +1,379 @@
+/**
+ * Thumbnail Extractor
+ *
+ * Compound files are memory-mapped and walked with CompoundFile, so only
+ * the header, directory and the preview stream's sectors are ever paged in -
+ * never the whole 300 MB assembly. SOLIDWORKS 2015+ files are not compound files;
+ * for those the installed shell thumbnail handler (IThumbnailProvider,
+ * reached through IShellItemImageFactory) does the work.
+ *
+ * \x05PreviewMetaFile is tried like the other streams, as the TS extractor
+ * does: WIC decodes it when it holds PNG, BMP or DIB bytes. An actual
+ * Windows metafile is skipped, since WIC has no WMF decoder; the shell
+ * handler gets that file instead.
+ */
+
+#include "thumbnail_extractor.h"
+
+#include <windows.h>
+#include <atlbase.h>
+#include <shlobj.h>
+#include <shobjidl.h>
+#include <shlwapi.h>
+#include <wincodec.h>
+#include <algorithm>
+
+#include "compound_file.h"
+#include "mapped_file.h"
+
+#pragma comment(lib, "windowscodecs.lib")
+
+const char16_t* const kPreviewStreamNames[] = {
+    u"PreviewPNG",
+    u"Preview",
+    u"PreviewBitmap",
+    u"\x05PreviewMetaFile",  // decoded only when it holds PNG, BMP or DIB bytes
+};
+const size_t kPreviewStreamCount = sizeof(kPreviewStreamNames) / sizeof(kPreviewStreamNames[0]);
+
+// Same floor as the JS fallback: anything smaller is a stub, not an image
+static const uint64_t kMinPreviewBytes = 100;
+// Previews are a few hundred KB at most; refuse to buffer anything absurd
+static const uint64_t kMaxPreviewBytes = 64ull * 1024 * 1024;
+static const uint32_t kDefaultMaxEdge = 256;
+// Past ~0.85 JPEG grows quickly for no visible gain at thumbnail sizes
+static const float kJpegQuality = 0.85f;
+
+// SolidWorks "Preview" streams are often a bare DIB (BITMAPINFOHEADER with
+// no file header). Prefix a BITMAPFILEHEADER so WIC's BMP decoder accepts it.
+static void WrapDibAsBmp(std::vector<uint8_t>* bytes) {
+    if (bytes->size() < sizeof(BITMAPINFOHEADER)) return;
+    const uint8_t* data = bytes->data();
+    if (!(data[0] == 0x28 && data[1] == 0x00 && data[2] == 0x00 && data[3] == 0x00)) return;
+
+    const BITMAPINFOHEADER* info = reinterpret_cast<const BITMAPINFOHEADER*>(data);
+    DWORD paletteBytes = 0;
+    if (info->biBitCount <= 8) {
+        DWORD colors = info->biClrUsed ? info->biClrUsed : (1u << info->biBitCount);
+        paletteBytes = colors * sizeof(RGBQUAD);
+    } else if (info->biCompression == BI_BITFIELDS) {
+        paletteBytes = 3 * sizeof(DWORD);
+    }
+
+    BITMAPFILEHEADER header = {};
+    header.bfType = 0x4D42;  // "BM"
+    header.bfSize = static_cast<DWORD>(sizeof(header) + bytes->size());
+    header.bfOffBits = static_cast<DWORD>(sizeof(header) + info->biSize + paletteBytes);
+
+    const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    bytes->insert(bytes->begin(), headerBytes, headerBytes + sizeof(header));
+}
+
+static HRESULT DecodeImage(IWICImagingFactory* wic, const std::vector<uint8_t>& bytes,
+    IWICBitmapSource** ppSource) {
+
+    CComPtr<IWICStream> stream;
+    HRESULT hr = wic->CreateStream(&stream);
+    if (SUCCEEDED(hr)) {
+        hr = stream->InitializeFromMemory(const_cast<BYTE*>(bytes.data()), static_cast<DWORD>(bytes.size()));
+    }
+
+    CComPtr<IWICBitmapDecoder> decoder;
+    if (SUCCEEDED(hr)) {
+        hr = wic->CreateDecoderFromStream(stream, nullptr, WICDecodeMetadataCacheOnDemand, &decoder);
+    }
+
+    CComPtr<IWICBitmapFrameDecode> frame;
+    if (SUCCEEDED(hr)) hr = decoder->GetFrame(0, &frame);
+
+    // The decoder reads lazily from `bytes`; materialize now so the caller
+    // doesn't have to keep the buffer alive
+    CComPtr<IWICBitmap> bitmap;
+    if (SUCCEEDED(hr)) hr = wic->CreateBitmapFromSource(frame, WICBitmapCacheOnLoad, &bitmap);
+    if (SUCCEEDED(hr)) *ppSource = bitmap.Detach();
+    return hr;
+}
+
+// Encode one frame of `source` (already in pixelFormat) into image->data
+static HRESULT Encode(IWICImagingFactory* wic, IWICBitmapSource* source, REFGUID container,
+    WICPixelFormatGUID pixelFormat, ThumbnailImage* image) {
+
+    UINT width = 0, height = 0;
+    HRESULT hr = source->GetSize(&width, &height);
+
+    CComPtr<IStream> output;
+    output.Attach(SHCreateMemStream(nullptr, 0));
+    if (SUCCEEDED(hr) && !output) hr = E_OUTOFMEMORY;
+
+    CComPtr<IWICBitmapEncoder> encoder;
+    if (SUCCEEDED(hr)) hr = wic->CreateEncoder(container, nullptr, &encoder);
+    if (SUCCEEDED(hr)) hr = encoder->Initialize(output, WICBitmapEncoderNoCache);
+
+    CComPtr<IWICBitmapFrameEncode> frame;
+    CComPtr<IPropertyBag2> properties;
+    if (SUCCEEDED(hr)) hr = encoder->CreateNewFrame(&frame, &properties);
+    if (SUCCEEDED(hr) && container == GUID_ContainerFormatJpeg) {
+        PROPBAG2 option = {};
+        option.pstrName = const_cast<LPOLESTR>(L"ImageQuality");
+        VARIANT value;
+        VariantInit(&value);
+        value.vt = VT_R4;
+        value.fltVal = kJpegQuality;
+        hr = properties->Write(1, &option, &value);
+    }
+    if (SUCCEEDED(hr)) hr = frame->Initialize(properties);
+    if (SUCCEEDED(hr)) hr = frame->SetSize(width, height);
+    if (SUCCEEDED(hr)) hr = frame->SetPixelFormat(&pixelFormat);
+    if (SUCCEEDED(hr)) hr = frame->WriteSource(source, nullptr);
+    if (SUCCEEDED(hr)) hr = frame->Commit();
+    if (SUCCEEDED(hr)) hr = encoder->Commit();
+    if (FAILED(hr)) return hr;
+
+    STATSTG stat = {};
+    hr = output->Stat(&stat, STATFLAG_NONAME);
+    if (FAILED(hr)) return hr;
+
+    LARGE_INTEGER zero = {};
+    output->Seek(zero, STREAM_SEEK_SET, nullptr);
+    image->data.resize(static_cast<size_t>(stat.cbSize.QuadPart));
+    ULONG read = 0;
+    hr = output->Read(image->data.data(), static_cast<ULONG>(image->data.size()), &read);
+    if (FAILED(hr)) return hr;
+    image->data.resize(read);
+
+    image->width = width;
+    image->height = height;
+    image->mimeType = container == GUID_ContainerFormatJpeg ? "image/jpeg" : "image/png";
+    return S_OK;
+}
+
+static HRESULT EncodePng(IWICImagingFactory* wic, IWICBitmapSource* source, ThumbnailImage* image) {
+    CComPtr<IWICFormatConverter> converter;
+    HRESULT hr = wic->CreateFormatConverter(&converter);
+    if (SUCCEEDED(hr)) {
+        hr = converter->Initialize(source, GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone,
+            nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    }
+    if (FAILED(hr)) return hr;
+    return Encode(wic, converter, GUID_ContainerFormatPng, GUID_WICPixelFormat32bppBGRA, image);
+}
+
+// JPEG has no alpha: composite over white first. For Auto, a transparent
+// pixel sends the image to PNG instead (*transparent set, nothing encoded).
+static HRESULT EncodeJpeg(IWICImagingFactory* wic, IWICBitmapSource* source, bool keepAlpha,
+    bool* transparent, ThumbnailImage* image) {
+
+    UINT width = 0, height = 0;
+    HRESULT hr = source->GetSize(&width, &height);
+
+    // Premultiplied, so over white is just c + (255 - a)
+    CComPtr<IWICFormatConverter> converter;
+    if (SUCCEEDED(hr)) hr = wic->CreateFormatConverter(&converter);
+    if (SUCCEEDED(hr)) {
+        hr = converter->Initialize(source, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone,
+            nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    }
+    if (FAILED(hr)) return hr;
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    hr = converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(pixels.size()), pixels.data());
+    if (FAILED(hr)) return hr;
+
+    UINT stride = (width * 3 + 3) & ~3u;
+    std::vector<uint8_t> flat(static_cast<size_t>(stride) * height);
+    *transparent = false;
+    for (UINT y = 0; y < height; y++) {
+        const uint8_t* in = pixels.data() + static_cast<size_t>(y) * width * 4;
+        uint8_t* out = flat.data() + static_cast<size_t>(y) * stride;
+        for (UINT x = 0; x < width; x++, in += 4, out += 3) {
+            uint8_t background = static_cast<uint8_t>(255 - in[3]);
+            if (background) *transparent = true;
+            out[0] = static_cast<uint8_t>(std::min(255, in[0] + background));
+            out[1] = static_cast<uint8_t>(std::min(255, in[1] + background));
+            out[2] = static_cast<uint8_t>(std::min(255, in[2] + background));
+        }
+    }
+    if (*transparent && keepAlpha) return S_OK;
+
+    CComPtr<IWICBitmap> bitmap;
+    hr = wic->CreateBitmapFromMemory(width, height, GUID_WICPixelFormat24bppBGR, stride,
+        static_cast<UINT>(flat.size()), flat.data(), &bitmap);
+    if (FAILED(hr)) return hr;
+    return Encode(wic, bitmap, GUID_ContainerFormatJpeg, GUID_WICPixelFormat24bppBGR, image);
+}
+
+static HRESULT ScaleAndEncode(IWICImagingFactory* wic, IWICBitmapSource* source,
+    uint32_t maxEdge, ThumbnailFormat format, ThumbnailImage* image) {
+
+    UINT width = 0, height = 0;
+    HRESULT hr = source->GetSize(&width, &height);
+    if (FAILED(hr) || width == 0 || height == 0) return FAILED(hr) ? hr : E_FAIL;
+
+    CComPtr<IWICBitmapSource> scaled = source;
+    if (width > maxEdge || height > maxEdge) {
+        double ratio = static_cast<double>(maxEdge) / std::max(width, height);
+        UINT scaledWidth = std::max<UINT>(1, static_cast<UINT>(width * ratio + 0.5));
+        UINT scaledHeight = std::max<UINT>(1, static_cast<UINT>(height * ratio + 0.5));
+
+        // HighQualityCubic (Windows 10+) keeps thin edges crisp on big
+        // reductions; a scaler initializes once, so Fant gets a fresh one
+        CComPtr<IWICBitmapScaler> scaler;
+        hr = wic->CreateBitmapScaler(&scaler);
+        if (SUCCEEDED(hr)) {
+            hr = scaler->Initialize(source, scaledWidth, scaledHeight,
+                WICBitmapInterpolationModeHighQualityCubic);
+        }
+        if (FAILED(hr)) {
+            scaler.Release();
+            hr = wic->CreateBitmapScaler(&scaler);
+            if (SUCCEEDED(hr)) {
+                hr = scaler->Initialize(source, scaledWidth, scaledHeight, WICBitmapInterpolationModeFant);
+            }
+        }
+        if (FAILED(hr)) return hr;
+        scaled = scaler.p;
+    }
+
+    if (format == ThumbnailFormat::Png) return EncodePng(wic, scaled, image);
+
+    bool transparent = false;
+    hr = EncodeJpeg(wic, scaled, format == ThumbnailFormat::Auto, &transparent, image);
+    if (SUCCEEDED(hr) && transparent && format == ThumbnailFormat::Auto) {
+        hr = EncodePng(wic, scaled, image);
+    }
+    return hr;
+}
+
+static bool ReadCompoundStream(const CompoundFile& file, const std::u16string& name,
+    std::vector<uint8_t>* bytes) {
+
+    CompoundEntry entry;
+    if (!file.Find(name, &entry) || entry.type != CompoundEntry::Stream) return false;
+    if (entry.size < kMinPreviewBytes) return false;
+    return file.ReadStream(entry, bytes, kMaxPreviewBytes);
+}
+
+PreviewStream ReadPreviewStream(const std::wstring& path, const std::vector<std::u16string>& names) {
+    PreviewStream result;
+
+    MappedFile mapped;
+    CompoundFile file;
+    if (!mapped.Open(path, &result.error) || !file.Open(&mapped, &result.error)) {
+        return result;
+    }
+
+    for (const auto& name : names) {
+        if (ReadCompoundStream(file, name, &result.data)) {
+            result.success = true;
+            result.name = name;
+            return result;
+        }
+    }
+
+    result.data.clear();
+    result.error = "No preview stream found in file";
+    return result;
+}
+
+// Decoded preview image, before scaling
+static bool DecodeFromStorage(IWICImagingFactory* wic, const std::wstring& path,
+    IWICBitmapSource** ppSource) {
+
+    // Not a compound file (SOLIDWORKS 2015+) fails here after one header read
+    std::string error;
+    MappedFile mapped;
+    CompoundFile file;
+    if (!mapped.Open(path, &error) || !file.Open(&mapped, &error)) return false;
+
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < kPreviewStreamCount; i++) {
+        if (!ReadCompoundStream(file, kPreviewStreamNames[i], &bytes)) continue;
+        WrapDibAsBmp(&bytes);
+        if (SUCCEEDED(DecodeImage(wic, bytes, ppSource))) return true;
+    }
+    return false;
+}
+
+static bool DecodeFromShell(IWICImagingFactory* wic, const std::wstring& path,
+    uint32_t maxEdge, IWICBitmapSource** ppSource) {
+
+    CComPtr<IShellItemImageFactory> factory;
+    if (FAILED(SHCreateItemFromParsingName(path.c_str(), nullptr, IID_PPV_ARGS(&factory)))) {
+        return false;
+    }
+
+    // THUMBNAILONLY: an icon is worse than no image, the renderer has its own
+    SIZE size = { static_cast<LONG>(maxEdge), static_cast<LONG>(maxEdge) };
+    HBITMAP hBitmap = nullptr;
+    if (FAILED(factory->GetImage(size, SIIGBF_THUMBNAILONLY | SIIGBF_BIGGERSIZEOK, &hBitmap)) || !hBitmap) {
+        return false;
+    }
+
+    CComPtr<IWICBitmap> bitmap;
+    HRESULT hr = wic->CreateBitmapFromHBITMAP(hBitmap, nullptr, WICBitmapUsePremultipliedAlpha, &bitmap);
+    DeleteObject(hBitmap);
+    if (FAILED(hr)) return false;
+
+    *ppSource = bitmap.Detach();
+    return true;
+}
+
+std::vector<ThumbnailImage> ExtractThumbnailSizes(const std::wstring& path,
+    const std::vector<uint32_t>& maxEdges, ThumbnailFormat format) {
+
+    std::vector<ThumbnailImage> images(maxEdges.size());
+    auto fail = [&images](const char* error) {
+        for (auto& image : images) image.error = error;
+        return images;
+    };
+
+    if (maxEdges.empty()) return images;
+    if (GetFileAttributesW(path.c_str()) == INVALID_FILE_ATTRIBUTES) return fail("File not found");
+
+    CComPtr<IWICImagingFactory> wic;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic)))) {
+        return fail("WIC unavailable");
+    }
+
+    uint32_t largest = *std::max_element(maxEdges.begin(), maxEdges.end());
+    if (largest == 0) largest = kDefaultMaxEdge;
+
+    // Decode once; every size is scaled from the same source
+    CComPtr<IWICBitmapSource> source;
+    const char* sourceName = "storage";
+    if (!DecodeFromStorage(wic, path, &source)) {
+        sourceName = "shell";
+        if (!DecodeFromShell(wic, path, largest, &source)) return fail("No thumbnail found");
+    }
+
+    for (size_t i = 0; i < maxEdges.size(); i++) {
+        ThumbnailImage& image = images[i];
+        uint32_t maxEdge = maxEdges[i] ? maxEdges[i] : kDefaultMaxEdge;
+        if (SUCCEEDED(ScaleAndEncode(wic, source, maxEdge, format, &image))) {
+            image.success = true;
+            image.source = sourceName;
+        } else {
+            image = ThumbnailImage();
+            image.error = "Could not encode thumbnail";
+        }
+    }
+    return images;
+}
+
+bool WarmThumbnailCodecs() {
+    CComPtr<IWICImagingFactory> wic;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&wic)))) {
+        return false;
+    }
+    // Creating the encoders pulls in their code; the shell stream is for the
+    // delay-loaded shlwapi
+    CComPtr<IWICBitmapEncoder> png, jpeg;
+    CComPtr<IStream> stream;
+    stream.Attach(SHCreateMemStream(nullptr, 0));
+    return SUCCEEDED(wic->CreateEncoder(GUID_ContainerFormatPng, nullptr, &png)) &&
+        SUCCEEDED(wic->CreateEncoder(GUID_ContainerFormatJpeg, nullptr, &jpeg)) && stream;
+}
+
+ThumbnailImage ExtractThumbnail(const std::wstring& path, uint32_t maxEdge, ThumbnailFormat format) {
+    return std::move(ExtractThumbnailSizes(path, { maxEdge }, format).front());
+}
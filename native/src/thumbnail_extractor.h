@@ -0,0 +1,64 @@
+/**
+ * Thumbnail Extractor
+ *
+ * Pulls an embedded preview out of a CAD file without loading the whole
+ * file: first the OLE compound-file preview streams (pre-2015 SolidWorks
+ * files, read through a mapped view), then the Windows shell thumbnail
+ * handler. The image is scaled to fit maxEdge with WIC (high-quality cubic
+ * where the system has it, Fant otherwise) and re-encoded as PNG or JPEG.
+ * WIC ships no WebP or AVIF encoder, so JPEG is the compact format: a
+ * shaded preview at grid size is a few KB, where the stored BMP preview
+ * is often hundreds.
+ *
+ * Runs on any COM-initialized worker thread; no N-API here.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class ThumbnailFormat : uint32_t {
+    Png,   // lossless, keeps transparency
+    Jpeg,  // transparent pixels flattened onto white
+    Auto,  // JPEG unless some pixel is transparent, then PNG
+};
+
+struct ThumbnailImage {
+    bool success = false;
+    std::string error;
+    std::string mimeType;
+    std::string source;  // "storage" or "shell"
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> data;
+};
+
+struct PreviewStream {
+    bool success = false;
+    std::string error;
+    std::u16string name;  // which of the requested streams was found
+    std::vector<uint8_t> data;
+};
+
+// Preview stream names SolidWorks has used over the years, best first.
+// \x05PreviewMetaFile is read too, but real WMF content is skipped: WIC can't
+// decode it.
+extern const char16_t* const kPreviewStreamNames[];
+extern const size_t kPreviewStreamCount;
+
+ThumbnailImage ExtractThumbnail(const std::wstring& path, uint32_t maxEdge,
+    ThumbnailFormat format = ThumbnailFormat::Png);
+
+// One decode, one encoded image per requested edge (same order)
+std::vector<ThumbnailImage> ExtractThumbnailSizes(const std::wstring& path,
+    const std::vector<uint32_t>& maxEdges, ThumbnailFormat format = ThumbnailFormat::Png);
+
+// Load WIC and its PNG/JPEG encoders ahead of the first thumbnail. Must run
+// on a COM-initialized thread.
+bool WarmThumbnailCodecs();
+
+// Raw bytes of the first of `names` present in a compound file, as stored.
+// Only the directory and that stream's sectors are read. No COM needed.
+PreviewStream ReadPreviewStream(const std::wstring& path, const std::vector<std::u16string>& names);
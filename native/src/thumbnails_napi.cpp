@@ -0,0 +1,266 @@
+/**
+ * Thumbnail Bindings
+ *
+ * extractThumbnails(paths[], { maxEdge, format, cache, priority, jobId }) -> Promise<ThumbnailResult[]>
+ * openThumbnailCache(directory, { sizes, format }) / closeThumbnailCache()
+ * getThumbnailCacheStats()
+ *
+ * Every path is extracted on the shared worker pool; the promise resolves
+ * once with results in input order. Image bytes come back as Buffers that
+ * own the native allocation (see TakeBuffer), so callers never go through
+ * base64. While the disk cache is open, unchanged files are served from
+ * it and misses are stored at every configured size from a single decode.
+ * `format` is 'auto' (default: JPEG, or PNG for images with transparency),
+ * 'jpeg' or 'png'; check each result's mimeType.
+ * Files cancelled before their turn (cancelJob / cancelJobsUnder) resolve
+ * with error "Cancelled".
+ */
+
+#include "addon.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "native_stats.h"
+#include "thread_pool.h"
+#include "thumbnail_cache.h"
+#include "thumbnail_extractor.h"
+
+static const uint32_t kDefaultMaxEdge = 256;
+static const uint32_t kMinMaxEdge = 16;
+static const uint32_t kMaxMaxEdge = 2048;
+static const uint32_t kMaxCacheSizes = 3;
+
+struct ThumbnailBatch {
+    std::vector<std::wstring> paths;
+    std::vector<ThumbnailImage> results;
+    uint32_t maxEdge = kDefaultMaxEdge;
+    ThumbnailFormat format = ThumbnailFormat::Auto;
+    bool useCache = true;
+    JobOptions job;
+    CancelTokenPtr token;
+    std::atomic<size_t> remaining{0};
+    AsyncCompletion* completion = nullptr;
+};
+
+static Napi::Value BuildThumbnailResults(Napi::Env env, ThumbnailBatch* batch) {
+    Napi::Array results = Napi::Array::New(env, batch->results.size());
+    for (size_t i = 0; i < batch->results.size(); i++) {
+        ThumbnailImage& image = batch->results[i];
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("path", WideToJs(env, batch->paths[i]));
+        entry.Set("success", Napi::Boolean::New(env, image.success));
+        if (image.success) {
+            entry.Set("mimeType", Napi::String::New(env, image.mimeType));
+            entry.Set("width", Napi::Number::New(env, image.width));
+            entry.Set("height", Napi::Number::New(env, image.height));
+            entry.Set("source", Napi::String::New(env, image.source));
+            entry.Set("data", TakeBuffer(env, std::move(image.data)));
+        } else {
+            entry.Set("error", Napi::String::New(env, image.error));
+        }
+        results.Set(static_cast<uint32_t>(i), entry);
+    }
+    return results;
+}
+
+// { format: 'auto' | 'jpeg' | 'png' }; false (with a TypeError) for anything else
+static bool ReadFormatOption(Napi::Env env, const Napi::Object& options, ThumbnailFormat* format) {
+    Napi::Value value = options.Get("format");
+    if (value.IsUndefined()) return true;
+    std::string name = value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string();
+    if (name == "auto") {
+        *format = ThumbnailFormat::Auto;
+    } else if (name == "jpeg") {
+        *format = ThumbnailFormat::Jpeg;
+    } else if (name == "png") {
+        *format = ThumbnailFormat::Png;
+    } else {
+        Napi::TypeError::New(env, "format must be 'auto', 'jpeg' or 'png'").ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+// Serve from the disk cache, or extract every configured size at once and
+// remember them; runs on a worker
+static ThumbnailImage ExtractCached(const std::wstring& path, uint32_t maxEdge, ThumbnailFormat format,
+    bool useCache) {
+    ScopedNativeTimer timer(NativeOp::ExtractThumbnail);
+    ThumbnailCache& cache = ThumbnailCache::Shared();
+    ThumbnailCacheKey key;
+    if (!useCache || !cache.IsOpen() || !ThumbnailCache::KeyForFile(path, &key)) {
+        return ExtractThumbnail(path, maxEdge, format);
+    }
+
+    ThumbnailImage image;
+    key.edge = maxEdge;
+    key.format = static_cast<uint32_t>(format);
+    if (cache.Lookup(key, &image)) return image;
+
+    std::vector<uint32_t> edges = { maxEdge };
+    for (uint32_t edge : cache.Edges()) {
+        if (edge != maxEdge) edges.push_back(edge);
+    }
+
+    std::vector<ThumbnailImage> images = ExtractThumbnailSizes(path, edges, format);
+    for (size_t i = 0; i < images.size(); i++) {
+        key.edge = edges[i];
+        cache.Store(key, images[i]);
+    }
+    return std::move(images.front());
+}
+
+// extractThumbnails(paths: string[] | path table, options?: { maxEdge?: number, format?: string, cache?: boolean,
+//                   priority?: 'visible' | 'normal' | 'prefetch', jobId?: number })
+static Napi::Value ExtractThumbnails(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto batch = std::make_shared<ThumbnailBatch>();
+    if (!ReadPathTable(info[0], &batch->paths)) return env.Null();
+
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        Napi::Value maxEdge = options.Get("maxEdge");
+        if (maxEdge.IsNumber()) {
+            batch->maxEdge = std::clamp<uint32_t>(maxEdge.As<Napi::Number>().Uint32Value(),
+                kMinMaxEdge, kMaxMaxEdge);
+        }
+        Napi::Value cache = options.Get("cache");
+        if (cache.IsBoolean()) batch->useCache = cache.As<Napi::Boolean>().Value();
+        if (!ReadFormatOption(env, options, &batch->format) ||
+            !ReadJobOptions(env, options, &batch->job)) {
+            return env.Null();
+        }
+    }
+
+    batch->results.resize(batch->paths.size());
+    batch->remaining = batch->paths.size();
+    batch->completion = AsyncCompletion::Create(env, "extractThumbnails");
+    Napi::Promise promise = batch->completion->Promise();
+
+    if (batch->paths.empty()) {
+        batch->completion->Resolve([](Napi::Env env) { return Napi::Array::New(env); });
+        return promise;
+    }
+
+    batch->token = CancelToken::Create(batch->job.jobId, batch->paths);
+    for (size_t i = 0; i < batch->paths.size(); i++) {
+        ThreadPool::Shared().Submit([batch, i]() {
+            if (batch->token->IsCancelled(batch->paths[i])) {
+                batch->results[i].error = kCancelledError;
+            } else {
+                batch->results[i] = ExtractCached(batch->paths[i], batch->maxEdge, batch->format, batch->useCache);
+            }
+            if (--batch->remaining == 0) {
+                batch->token.reset();  // finished: no longer cancellable
+                batch->completion->Resolve([batch](Napi::Env env) {
+                    return BuildThumbnailResults(env, batch.get());
+                });
+            }
+        }, batch->job.priority);
+    }
+
+    return promise;
+}
+
+struct WarmBatch {
+    std::vector<std::wstring> paths;
+    CancelTokenPtr token;
+    std::function<void(size_t)> done;
+    std::atomic<size_t> remaining{0};
+    std::atomic<size_t> warmed{0};
+};
+
+void WarmThumbnailCache(std::vector<std::wstring> paths, JobPriority priority, CancelTokenPtr token,
+    std::function<void(size_t warmed)> done) {
+    ThumbnailCache& cache = ThumbnailCache::Shared();
+    if (paths.empty() || !cache.IsOpen() || cache.Edges().empty()) {
+        done(0);
+        return;
+    }
+
+    auto batch = std::make_shared<WarmBatch>();
+    batch->paths = std::move(paths);
+    batch->token = std::move(token);
+    batch->done = std::move(done);
+    batch->remaining = batch->paths.size();
+    // A miss stores every configured edge, so any one of them will do
+    uint32_t edge = cache.Edges().front();
+    ThumbnailFormat format = cache.Format();
+
+    for (size_t i = 0; i < batch->paths.size(); i++) {
+        ThreadPool::Shared().Submit([batch, i, edge, format]() {
+            if (!batch->token->IsCancelled(batch->paths[i]) &&
+                ExtractCached(batch->paths[i], edge, format, true).success) {
+                batch->warmed++;
+            }
+            if (--batch->remaining == 0) batch->done(batch->warmed);
+        }, priority);
+    }
+}
+
+// openThumbnailCache(directory: string, options?: { sizes?: number[], format?: string })
+static Napi::Value OpenThumbnailCache(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::wstring directory;
+    std::optional<Napi::Object> options;
+    if (!ReadArgs(info, "Cache directory expected", &directory, &options)) return env.Null();
+
+    std::vector<uint32_t> sizes = { 128, 256 };
+    ThumbnailFormat format = ThumbnailFormat::Auto;
+    if (options) {
+        if (!ReadFormatOption(env, *options, &format)) return env.Null();
+        Napi::Value value = options->Get("sizes");
+        if (value.IsArray()) {
+            Napi::Array array = value.As<Napi::Array>();
+            sizes.clear();
+            for (uint32_t i = 0; i < array.Length() && sizes.size() < kMaxCacheSizes; i++) {
+                Napi::Value size = array.Get(i);
+                if (!size.IsNumber()) continue;
+                sizes.push_back(std::clamp<uint32_t>(size.As<Napi::Number>().Uint32Value(),
+                    kMinMaxEdge, kMaxMaxEdge));
+            }
+        }
+    }
+
+    std::string error;
+    Napi::Object result = Napi::Object::New(env);
+    bool opened = ThumbnailCache::Shared().Open(directory, sizes, format, &error);
+    result.Set("success", Napi::Boolean::New(env, opened));
+    if (opened) {
+        result.Set("entries", Napi::Number::New(env, static_cast<double>(ThumbnailCache::Shared().Stats().entries)));
+    } else {
+        result.Set("error", Napi::String::New(env, error));
+    }
+    return result;
+}
+
+static Napi::Value CloseThumbnailCache(const Napi::CallbackInfo& info) {
+    ThumbnailCache::Shared().Close();
+    return info.Env().Undefined();
+}
+
+static Napi::Value GetThumbnailCacheStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ThumbnailCacheStats stats = ThumbnailCache::Shared().Stats();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("open", Napi::Boolean::New(env, ThumbnailCache::Shared().IsOpen()));
+    result.Set("entries", Napi::Number::New(env, static_cast<double>(stats.entries)));
+    result.Set("packBytes", Napi::Number::New(env, static_cast<double>(stats.packBytes)));
+    result.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+    result.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+    return result;
+}
+
+void InitThumbnailBindings(Napi::Env env, Napi::Object exports) {
+    exports.Set("extractThumbnails", Napi::Function::New(env, ExtractThumbnails));
+    exports.Set("openThumbnailCache", Napi::Function::New(env, OpenThumbnailCache));
+    exports.Set("closeThumbnailCache", Napi::Function::New(env, CloseThumbnailCache));
+    exports.Set("getThumbnailCacheStats", Napi::Function::New(env, GetThumbnailCacheStats));
+}
@@ -0,0 +1,24 @@
+/**
+ * Unbuffered File I/O
+ */
+
+#include "unbuffered_io.h"
+
+HANDLE OpenForUnbufferedRead(const std::wstring& path, bool* unbuffered) {
+    const DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    if (unbuffered) *unbuffered = true;
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, share, nullptr, OPEN_EXISTING,
+        FILE_FLAG_OVERLAPPED | FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file != INVALID_HANDLE_VALUE) return file;
+
+    // Some redirectors and filter drivers reject unbuffered handles
+    DWORD error = GetLastError();
+    if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND || error == ERROR_ACCESS_DENIED) {
+        return INVALID_HANDLE_VALUE;
+    }
+    if (unbuffered) *unbuffered = false;
+    file = CreateFileW(path.c_str(), GENERIC_READ, share, nullptr, OPEN_EXISTING,
+        FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) SetLastError(error);
+    return file;
+}
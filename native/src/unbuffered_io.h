@@ -0,0 +1,20 @@
+/**
+ * Unbuffered File I/O
+ *
+ * The open shared by every reader that streams whole files past the
+ * system cache (the hash engine, the copy engine and chunk readers):
+ * overlapped, sequential and FILE_FLAG_NO_BUFFERING, falling back to a
+ * buffered handle on volumes that refuse unbuffered ones. Callers that
+ * keep the unbuffered handle must read sector-aligned offsets and sizes
+ * into sector-aligned buffers (AlignedBufferPool).
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+
+// Open a file for overlapped sequential reads, unbuffered where the volume
+// allows it and buffered where it doesn't. *unbuffered (optional) says
+// which. On failure GetLastError() is the first attempt's error.
+HANDLE OpenForUnbufferedRead(const std::wstring& path, bool* unbuffered = nullptr);
@@ -0,0 +1,25 @@
+/**
+ * Worker Shutdown
+ *
+ * Stops every background engine the bindings share, from the env cleanup
+ * hook in edrawings_preview.cpp. Order matters: engines that submit to the
+ * pool go first, then the pool itself, and the thumbnail cache last so no
+ * worker can Store() into it after it closes.
+ */
+
+#include "addon.h"
+
+#include "copy_engine.h"
+#include "directory_watcher.h"
+#include "hash_engine.h"
+#include "thread_pool.h"
+#include "thumbnail_cache.h"
+
+void ShutdownWorkerBindings() {
+    DirectoryWatcher::Shared().Shutdown();
+    HashEngine::Shared().Shutdown();
+    CopyEngine::Shared().Shutdown();
+    ThreadPool::Shared().Shutdown();
+    // After the workers: nothing can Store() past this point
+    ThumbnailCache::Shared().Close();
+}